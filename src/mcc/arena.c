@@ -0,0 +1,47 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#include <sys/mman.h>
+
+#include "arena.h"
+
+int arena_init(Arena *arena, const size_t capacity) {
+    // PROT_NONE：仅保留地址空间，不计入提交的内存，越过已提交部分的访问立即触发段错误而不会静默越界
+    void *base = mmap(NULL, capacity, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        arena->base = NULL;
+        arena->size = arena->capacity = 0;
+        return -1;
+    }
+    arena->base = base;
+    arena->size = 0;
+    arena->capacity = capacity;
+    return 0;
+}
+
+int arena_commit(Arena *arena, const size_t size) {
+    if (size <= arena->size) {
+        return 0;
+    }
+    if (size > arena->capacity) {
+        return -1;
+    }
+    size_t committed = (size + ARENA_CHUNK - 1) / ARENA_CHUNK * ARENA_CHUNK;
+    if (committed > arena->capacity) {
+        committed = arena->capacity;
+    }
+    if (mprotect(arena->base + arena->size, committed - arena->size, PROT_READ | PROT_WRITE) != 0) {
+        return -1;
+    }
+    arena->size = committed;
+    return 0;
+}
+
+void arena_free(Arena *arena) {
+    if (arena->base != NULL) {
+        munmap(arena->base, arena->capacity);
+        arena->base = NULL;
+        arena->size = arena->capacity = 0;
+    }
+}
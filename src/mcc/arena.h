@@ -0,0 +1,43 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_ARENA_H
+#define MCC_ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_CHUNK (64 * 1024) // 每次提交的内存块大小（字节）
+
+// 内存区：预先保留一段连续的地址空间（不可访问，不占用物理内存），写入前按块提交为可读写；
+// 起始地址始终不变，代码段、数据段中保存的绝对地址在增长后仍然有效；
+// 新提交的页面由内核在首次访问时分配并填 0，无需 memset
+typedef struct {
+    char *base; // 起始地址
+    size_t size; // 已提交（可读写）的大小
+    size_t capacity; // 保留的地址空间大小
+} Arena;
+
+/**
+ * @brief 初始化内存区：保留地址空间，暂不提交
+ * @param arena 内存区
+ * @param capacity 保留的地址空间大小（内存区的最大容量）
+ * @return 0:成功 -1:地址空间不足
+ */
+int arena_init(Arena *arena, size_t capacity);
+
+/**
+ * @brief 确保内存区的 [0, size) 可读写：不足时按块（ARENA_CHUNK 的整数倍）提交
+ * @param arena 内存区
+ * @param size 需要的大小
+ * @return 0:成功 -1:超出保留的容量或提交失败
+ */
+int arena_commit(Arena *arena, size_t size);
+
+/**
+ * @brief 释放内存区（解除整个地址空间的映射）
+ * @param arena 内存区
+ */
+void arena_free(Arena *arena);
+
+#endif //MCC_ARENA_H
@@ -0,0 +1,353 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "bytecode.h"
+#include "native.h"
+#include "fail.h"
+
+// 计算紧凑指令长度（操作码 + 操作数）
+size_t instruction_size(int64_t op, int64_t operand);
+
+// 根据操作数大小选择指令变体
+int select_variant(int base, int64_t operand);
+
+/**
+ * @brief 将定长指令编码为紧凑字节码
+ * @details 分两趟：第一趟计算每条定长指令在字节码中的偏移，第二趟写入字节码并将跳转地址转换为相对偏移
+ * @param bc 紧凑字节码
+ * @param o_text 代码段（原始指针）
+ * @param text 代码段最后写入位置
+ * @param main 主函数入口
+ */
+void bytecode_encode(Bytecode *bc, const int64_t *o_text, const int64_t *text, const int64_t *main) {
+    // 指令从 o_text[1] 开始写入，跳转目标可能为 text + 1（代码段末尾）
+    const size_t count = text - o_text + 2;
+    uint32_t *offsets = malloc(sizeof(uint32_t) * count);
+    if (offsets == NULL) {
+        fail("bytecode: malloc memory failed\n");
+    }
+
+    // 1. 计算偏移
+    size_t offset = BYTECODE_STUB;
+    for (size_t i = 1; i < count - 1;) {
+        const int64_t op = o_text[i];
+        offsets[i] = offset;
+        if (op <= ADJ) {
+            offsets[i + 1] = offset;
+            offset += instruction_size(op, o_text[i + 1]);
+            i += 2;
+        } else {
+            offset += 1;
+            i += 1;
+        }
+    }
+    offsets[count - 1] = offset;
+
+    bc->size = offset;
+    // 由 mmap 分配，不占用 brk 堆，快照恢复时可映射到原地址
+    bc->code = mmap(NULL, bc->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (bc->code == MAP_FAILED) {
+        fail("bytecode: malloc memory failed\n");
+    }
+
+    // 2. 写入字节码
+    uint8_t *pc = bc->code;
+    *pc++ = PUSH; // main 函数返回后：将返回值入栈并退出
+    *pc++ = EXIT;
+    for (size_t i = 1; i < count - 1;) {
+        const int64_t op = o_text[i];
+        if (op > ADJ) {
+            *pc++ = (uint8_t) op;
+            i += 1;
+            continue;
+        }
+        const int64_t operand = o_text[i + 1];
+        if (op == JMP || op == JSR || op == JZ || op == JNZ) {
+            // 相对偏移：目标地址 - 下一条指令地址
+            const size_t target = offsets[(int64_t *) operand - o_text];
+            const int32_t rel = (int32_t) (target - (pc - bc->code + 1 + sizeof(int32_t)));
+            *pc++ = (uint8_t) (op == JMP ? JMP32 : op == JSR ? JSR32 : op == JZ ? JZ32 : JNZ32);
+            memcpy(pc, &rel, sizeof(rel));
+            pc += sizeof(rel);
+        } else {
+            const int variant = select_variant(op == LEA ? LEA8 : op == IMM ? IMM8 : op == ENT ? ENT8 : ADJ8, operand);
+            *pc++ = (uint8_t) variant;
+            const int width = bytecode_width(variant);
+            memcpy(pc, &operand, width); // 小端序：截取低位字节
+            pc += width;
+        }
+        i += 2;
+    }
+    bc->entry = bc->code + offsets[main - o_text];
+    free(offsets);
+}
+
+void bytecode_free(Bytecode *bc) {
+    if (bc->code != NULL) {
+        munmap(bc->code, bc->size);
+        bc->code = NULL;
+    }
+}
+
+/**
+ * @brief 打印紧凑字节码
+ * @param bc 紧凑字节码
+ */
+void bytecode_print(const Bytecode *bc) {
+    const uint8_t *pc = bc->code;
+    while (pc < bc->code + bc->size) {
+        const int op = *pc++;
+        printf("%6ld: %.4s", (long) (pc - 1 - bc->code),
+               &OPCODE_NAMES[bytecode_base(op) * 5]);
+        if (op >= JMP32) {
+            const int64_t rel = bytecode_operand(pc, op);
+            pc += sizeof(int32_t);
+            printf(" %ld\n", (long) (pc - bc->code + rel));
+        } else if (op >= LEA8) {
+            printf(" %ld\n", bytecode_operand(pc, op));
+            pc += bytecode_width(op);
+        } else {
+            printf("\n");
+        }
+    }
+}
+
+/**
+ * @brief 计算紧凑指令长度
+ * @param op 操作码（定长指令）
+ * @param operand 操作数
+ * @return 指令长度（字节）
+ */
+size_t instruction_size(const int64_t op, const int64_t operand) {
+    if (op == JMP || op == JSR || op == JZ || op == JNZ) {
+        return 1 + sizeof(int32_t);
+    }
+    return 1 + bytecode_width(select_variant(LEA8, operand));
+}
+
+/**
+ * @brief 根据操作数大小选择指令变体
+ * @param base 变体的第一个操作码（LEA8, IMM8, ENT8, ADJ8）
+ * @param operand 操作数
+ * @return 能容纳操作数的最小变体
+ */
+int select_variant(const int base, const int64_t operand) {
+    if (operand >= INT8_MIN && operand <= INT8_MAX) {
+        return base;
+    }
+    if (operand >= INT16_MIN && operand <= INT16_MAX) {
+        return base + 1;
+    }
+    if (operand >= INT32_MIN && operand <= INT32_MAX) {
+        return base + 2;
+    }
+    return base + 3;
+}
+
+/**
+ * @brief 准备运行紧凑字节码
+ * @param vm 虚拟机（已通过 vm_init 初始化栈）
+ * @param bc 紧凑字节码
+ */
+void bytecode_prepare(VM *vm, const Bytecode *bc) {
+    vm->pc = (int64_t *) bc->entry;
+    *vm->rsp = (int64_t) bc->code; // main 函数返回地址：指向字节码首部的退出桩
+    vm->compact = 1;
+    vm_segments(vm, bc->code, bc->size, vm->data, vm->d_size);
+}
+
+/**
+ * @brief 运行紧凑字节码
+ * @details 与 vm_run 逻辑一致，寄存器保存在局部变量中，系统调用前及结束时写回虚拟机
+ * @param vm 虚拟机（已通过 bytecode_prepare 或 vm_restore 设置）
+ * @return 正常结束：源程序的 main函数返回值；异常结束：错误码
+ */
+int64_t bytecode_run(VM *vm) {
+    const uint8_t *pc = (const uint8_t *) vm->pc;
+    int64_t *rsp = vm->rsp, *rbp = vm->rbp, rax = vm->rax, cycle = vm->cycle;
+    const int debug = vm->debug;
+    while (1) {
+        const int op = *pc++; // get operation code
+        ++cycle;
+        if (debug) {
+            // 打印当前执行的指令
+            printf("%ld> %.4s", cycle,
+                   &OPCODE_NAMES[bytecode_base(op) * 5]);
+            if (op >= LEA8) {
+                printf(" %ld\n", bytecode_operand(pc, op));
+            } else {
+                printf("\n");
+            }
+        }
+        switch (op) {
+            case IMM8:
+                rax = (int8_t) *pc++;
+                break;
+            case IMM16:
+            case IMM32:
+            case IMM64:
+                rax = bytecode_operand(pc, op);
+                pc += bytecode_width(op);
+                break;
+            case LC:
+                rax = *(unsigned char *) rax;
+                break;
+            case LI:
+                rax = *(int64_t *) rax;
+                break;
+            case SC:
+                rax = *(unsigned char *) *rsp++ = rax;
+                break;
+            case SI:
+                *(int64_t *) *rsp++ = rax;
+                break;
+            case PUSH:
+                *--rsp = rax;
+                break;
+            case JMP32:
+                pc += sizeof(int32_t) + bytecode_operand(pc, op);
+                break;
+            case JZ32:
+                pc += sizeof(int32_t) + (rax ? 0 : bytecode_operand(pc, op));
+                break;
+            case JNZ32:
+                pc += sizeof(int32_t) + (rax ? bytecode_operand(pc, op) : 0);
+                break;
+            case JSR32:
+                *--rsp = (int64_t) (pc + sizeof(int32_t));
+                pc += sizeof(int32_t) + bytecode_operand(pc, op);
+                break;
+            case ENT8:
+            case ENT16:
+            case ENT32:
+            case ENT64:
+                *--rsp = (int64_t) rbp;
+                rbp = rsp;
+                rsp = rsp - bytecode_operand(pc, op);
+                pc += bytecode_width(op);
+                break;
+            case ADJ8:
+            case ADJ16:
+            case ADJ32:
+            case ADJ64:
+                rsp = rsp + bytecode_operand(pc, op);
+                pc += bytecode_width(op);
+                break;
+            case LEV:
+                rsp = rbp;
+                rbp = (int64_t *) *rsp++;
+                pc = (const uint8_t *) *rsp++;
+                break;
+            case NATV: {
+                // 原生函数桩：参数个数取调用点之后 ADJ 的操作数，经函数值调用时取声明的参数个数
+                const uint8_t *ret = (const uint8_t *) *rsp;
+                Native *native = (Native *) rax;
+                const int adj = *ret >= ADJ8 && *ret <= ADJ64;
+                rax = native_call(native, rsp + 1, adj ? (int) bytecode_operand(ret + 1, *ret) : native->params);
+                pc = (const uint8_t *) *rsp++;
+                break;
+            }
+            case LEA8:
+                rax = (int64_t) (rbp + (int8_t) *pc++);
+                break;
+            case LEA16:
+            case LEA32:
+            case LEA64:
+                rax = (int64_t) (rbp + bytecode_operand(pc, op));
+                pc += bytecode_width(op);
+                break;
+            case OR:
+                rax = *rsp++ | rax;
+                break;
+            case XOR:
+                rax = *rsp++ ^ rax;
+                break;
+            case AND:
+                rax = *rsp++ & rax;
+                break;
+            case EQ:
+                rax = *rsp++ == rax;
+                break;
+            case NE:
+                rax = *rsp++ != rax;
+                break;
+            case LT:
+                rax = *rsp++ < rax;
+                break;
+            case LE:
+                rax = *rsp++ <= rax;
+                break;
+            case GT:
+                rax = *rsp++ > rax;
+                break;
+            case GE:
+                rax = *rsp++ >= rax;
+                break;
+            case SHL:
+                rax = *rsp++ << rax;
+                break;
+            case SHR:
+                rax = *rsp++ >> rax;
+                break;
+            case ADD:
+                rax = *rsp++ + rax;
+                break;
+            case SUB:
+                rax = *rsp++ - rax;
+                break;
+            case MUL:
+                rax = *rsp++ * rax;
+                break;
+            case DIV:
+                rax = *rsp++ / rax;
+                break;
+            case MOD:
+                rax = *rsp++ % rax;
+                break;
+            case OPEN:
+            case READ:
+            case CLOS:
+            case PRTF:
+            case MALC:
+            case MSET:
+            case MCMP:
+            case SNAP:
+            case THRC:
+            case THRJ:
+            case AADD:
+            case ACAS:
+            case LOCK:
+            case UNLK:
+            case PFOR:
+            case CNEW:
+            case CRES:
+            case CYLD:
+            case CDON:
+            case QSRT:
+            case BSCH:
+                // 系统调用可能保存快照，需先写回寄存器
+                vm->pc = (int64_t *) pc;
+                vm->rsp = rsp;
+                vm->rbp = rbp;
+                // PRTF 的参数个数：紧随其后的 ADJ 指令的操作数
+                rax = vm_syscall(vm, op, op == PRTF ? bytecode_operand(pc + 1, *pc) : 0);
+                break;
+            case EXIT:
+                vm->cycle = cycle;
+                printf("exit(%ld) cycle = %ld\n", *rsp, cycle);
+                vm->rsp = rsp;
+                vm->rbp = rbp;
+                vm->rax = rax;
+                return *rsp;
+            default:
+                printf("unknown instruction:%d\n", op);
+                return -1;
+        }
+    }
+}
@@ -0,0 +1,127 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_BYTECODE_H
+#define MCC_BYTECODE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "vm.h"
+
+// 紧凑字节码的扩展操作码
+// 无操作数的指令沿用 vm.h 中的操作码；带操作数的指令按操作数大小拆分为多个变体，跳转指令使用 32 位相对偏移
+enum {
+    LEA8 = BSCH + 1, LEA16, LEA32, LEA64,
+    IMM8, IMM16, IMM32, IMM64,
+    ENT8, ENT16, ENT32, ENT64,
+    ADJ8, ADJ16, ADJ32, ADJ64,
+    JMP32, JSR32, JZ32, JNZ32
+};
+
+#define BYTECODE_STUB 2 // 字节码首部的退出桩（PUSH, EXIT）长度，main 函数返回后执行
+
+// 紧凑字节码
+typedef struct {
+    uint8_t *code; // 字节码：1 字节操作码 + 变长操作数
+    size_t size; // 字节码长度
+    uint8_t *entry; // main 函数入口
+} Bytecode;
+
+/**
+ * @brief 将定长指令（每个操作码和操作数均为 int64_t）编码为紧凑字节码
+ * @param bc 紧凑字节码
+ * @param o_text 代码段（原始指针）
+ * @param text 代码段最后写入位置
+ * @param main 主函数入口
+ */
+void bytecode_encode(Bytecode *bc, const int64_t *o_text, const int64_t *text, const int64_t *main);
+
+/**
+ * @brief 释放紧凑字节码
+ * @param bc 紧凑字节码
+ */
+void bytecode_free(Bytecode *bc);
+
+/**
+ * @brief 打印紧凑字节码
+ * @param bc 紧凑字节码
+ */
+void bytecode_print(const Bytecode *bc);
+
+/**
+ * @brief 准备运行紧凑字节码：设置入口、main 函数返回地址及代码段
+ * @param vm 虚拟机（已通过 vm_init 初始化栈）
+ * @param bc 紧凑字节码
+ */
+void bytecode_prepare(VM *vm, const Bytecode *bc);
+
+/**
+ * @brief 运行紧凑字节码（从 vm->pc 开始执行）
+ * @param vm 虚拟机（已通过 bytecode_prepare 或 vm_restore 设置）
+ * @return 正常结束：源程序的 main函数返回值；异常结束：错误码
+ */
+int64_t bytecode_run(VM *vm);
+
+/**
+ * @brief 解码操作数
+ * @param pc 指向操作数的指针
+ * @param op 操作码
+ * @return 操作数
+ */
+static inline int64_t bytecode_operand(const uint8_t *pc, const int op) {
+    switch (op >= JMP32 ? 2 : (op - LEA8) & 3) {
+        case 0:
+            return (int8_t) *pc;
+        case 1: {
+            int16_t v;
+            memcpy(&v, pc, sizeof(v));
+            return v;
+        }
+        case 2: {
+            int32_t v;
+            memcpy(&v, pc, sizeof(v));
+            return v;
+        }
+        default: {
+            int64_t v;
+            memcpy(&v, pc, sizeof(v));
+            return v;
+        }
+    }
+}
+
+/**
+ * @brief 获取变体对应的定长指令操作码
+ * @param op 操作码
+ * @return 定长指令操作码
+ */
+static inline int bytecode_base(const int op) {
+    static const int bases[] = {LEA, IMM, ENT, ADJ};
+    if (op >= JMP32) {
+        return JMP + op - JMP32; // JMP32..JNZ32 依次对应 JMP, JSR, JZ, JNZ
+    }
+    if (op >= LEA8) {
+        return bases[(op - LEA8) / 4];
+    }
+    return op;
+}
+
+/**
+ * @brief 获取操作数的字节数
+ * @param op 操作码
+ * @return 操作数字节数
+ */
+static inline int bytecode_width(const int op) {
+    if (op >= JMP32) {
+        return 4;
+    }
+    if (op >= LEA8) {
+        return 1 << ((op - LEA8) & 3);
+    }
+    return 0;
+}
+
+#endif //MCC_BYTECODE_H
@@ -0,0 +1,333 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+#include "cache.h"
+#include "fail.h"
+
+#define CACHE_SUFFIX ".mcb" // 缓存条目文件后缀
+
+// 拼接路径
+char *join_path(const char *dir, const char *name);
+
+// 逐级创建目录
+void make_dirs(char *path);
+
+// 读取并更新统计信息
+void update_stats(const Cache *cache, uint64_t hits, uint64_t misses, uint64_t saved);
+
+// 淘汰最久未使用的条目
+void evict(const Cache *cache);
+
+/**
+ * @brief 初始化编译缓存
+ * @param cache 编译缓存
+ */
+void cache_init(Cache *cache) {
+    const char *dir = getenv(CACHE_DIR_ENV);
+    if (dir != NULL && *dir != '\0') {
+        cache->dir = strdup(dir);
+    } else {
+        const char *home = getenv("HOME");
+        cache->dir = join_path(home != NULL ? home : ".", ".cache/mcc");
+    }
+    const char *size = getenv(CACHE_SIZE_ENV);
+    const long mb = size != NULL && *size != '\0' ? strtol(size, NULL, 10) : -1;
+    cache->limit = (size_t) (mb >= 0 ? mb : CACHE_SIZE) * 1024 * 1024;
+    cache->key[0] = '\0';
+    cache->path = NULL;
+    make_dirs(cache->dir);
+}
+
+void cache_free(Cache *cache) {
+    if (cache->dir != NULL) {
+        free(cache->dir);
+        cache->dir = NULL;
+    }
+    if (cache->path != NULL) {
+        free(cache->path);
+        cache->path = NULL;
+    }
+}
+
+/**
+ * @brief 计算源文件的键
+ * @details 两个独立的 64 位哈希（FNV-1a 及乘法-循环移位混合）拼接为 128 位，
+ * 输入依次为编译器版本和源文件内容；现有选项均不改变缓存的程序映像（-l、--watch 与缓存同用时不生效，-j 只影响词法分析的方式，
+ * -b、-d 只影响运行），新增改变代码生成的选项时须将其加入键的前缀
+ * @param cache 编译缓存
+ * @param source 源文件文本
+ * @param length 源文件长度
+ */
+void cache_key(Cache *cache, const char *source, const size_t length) {
+    char prefix[64];
+    const int p_length = snprintf(prefix, sizeof(prefix), "mcc %s %zu\n", MCC_VERSION, length);
+    uint64_t h1 = 0xcbf29ce484222325, h2 = 0x9e3779b97f4a7c15;
+    for (int pass = 0; pass < 2; ++pass) {
+        const unsigned char *bytes = (const unsigned char *) (pass == 0 ? prefix : source);
+        const size_t count = pass == 0 ? (size_t) p_length : length;
+        for (size_t i = 0; i < count; ++i) {
+            h1 = (h1 ^ bytes[i]) * 0x100000001b3;
+            h2 = (h2 + bytes[i]) * 0xff51afd7ed558ccd;
+            h2 ^= h2 >> 29;
+        }
+    }
+    snprintf(cache->key, sizeof(cache->key), "%016lx%016lx", h1, h2);
+
+    char name[sizeof(cache->key) + sizeof(CACHE_SUFFIX)];
+    snprintf(name, sizeof(name), "%s%s", cache->key, CACHE_SUFFIX);
+    if (cache->path != NULL) {
+        free(cache->path);
+    }
+    cache->path = join_path(cache->dir, name);
+}
+
+/**
+ * @brief 查找并加载缓存条目
+ * @param cache 编译缓存
+ * @param image 程序映像（命中时加载）
+ * @return 1:命中 0:未命中
+ */
+int cache_load(Cache *cache, Image *image) {
+    const uint64_t start = cache_now();
+    if (!image_probe(cache->path)) {
+        return 0;
+    }
+    image_load(image, cache->path);
+    utimensat(AT_FDCWD, cache->path, NULL, 0); // 更新修改时间，淘汰时按最近使用时间排序
+    const uint64_t elapsed = cache_now() - start;
+    update_stats(cache, 1, 0, image->compile_time > elapsed ? image->compile_time - elapsed : 0);
+    return 1;
+}
+
+/**
+ * @brief 保存编译结果
+ * @details 先写入临时文件再重命名，并发运行的多个进程不会读到不完整的条目
+ * @param cache 编译缓存
+ * @param parser 语法分析器（语法分析已完成）
+ * @param compile_time 编译时间（纳秒）
+ */
+void cache_store(Cache *cache, const Parser *parser, const uint64_t compile_time) {
+    update_stats(cache, 0, 1, 0);
+    if (parser->main_entry == NULL) {
+        return;
+    }
+    const size_t length = strlen(cache->path) + 32;
+    char *tmp = malloc(length);
+    if (tmp == NULL) {
+        fail("cache: malloc memory failed\n");
+    }
+    snprintf(tmp, length, "%s.%d.tmp", cache->path, getpid());
+    image_write(parser, tmp, compile_time);
+    if (rename(tmp, cache->path) != 0) {
+        unlink(tmp);
+    }
+    free(tmp);
+    evict(cache);
+}
+
+/**
+ * @brief 打印缓存统计信息
+ * @param cache 编译缓存
+ */
+void cache_print_stats(const Cache *cache) {
+    CacheStats stats = {0};
+    char *path = join_path(cache->dir, "stats");
+    FILE *file = fopen(path, "r");
+    if (file != NULL) {
+        if (fscanf(file, "%lu %lu %lu", &stats.hits, &stats.misses, &stats.saved) != 3) {
+            stats = (CacheStats){0};
+        }
+        fclose(file);
+    }
+    free(path);
+
+    size_t entries = 0, bytes = 0;
+    DIR *dir = opendir(cache->dir);
+    if (dir != NULL) {
+        const struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            const size_t length = strlen(entry->d_name);
+            if (length > strlen(CACHE_SUFFIX) &&
+                strcmp(entry->d_name + length - strlen(CACHE_SUFFIX), CACHE_SUFFIX) == 0) {
+                char *name = join_path(cache->dir, entry->d_name);
+                struct stat st;
+                if (stat(name, &st) == 0) {
+                    ++entries;
+                    bytes += st.st_size;
+                }
+                free(name);
+            }
+        }
+        closedir(dir);
+    }
+
+    const uint64_t total = stats.hits + stats.misses;
+    printf("cache: %s\n", cache->dir);
+    printf("  hits: %lu, misses: %lu, hit rate: %.1f%%\n",
+           stats.hits, stats.misses, total > 0 ? 100.0 * stats.hits / total : 0.0);
+    printf("  time saved: %.3f ms\n", stats.saved / 1e6);
+    printf("  entries: %zu, size: %zu / %zu bytes\n", entries, bytes, cache->limit);
+}
+
+/**
+ * @brief 获取单调时钟的当前时间
+ * @return 纳秒
+ */
+uint64_t cache_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * @brief 拼接路径
+ * @param dir 目录
+ * @param name 文件名
+ * @return 路径（需调用方释放）
+ */
+char *join_path(const char *dir, const char *name) {
+    const size_t length = strlen(dir) + strlen(name) + 2;
+    char *path = malloc(length);
+    if (path == NULL) {
+        fail("cache: malloc memory failed\n");
+    }
+    snprintf(path, length, "%s/%s", dir, name);
+    return path;
+}
+
+/**
+ * @brief 逐级创建目录（mkdir -p）
+ * @param path 目录路径
+ */
+void make_dirs(char *path) {
+    for (char *p = path + 1; *p != '\0'; ++p) {
+        if (*p == '/') {
+            *p = '\0';
+            mkdir(path, 0755);
+            *p = '/';
+        }
+    }
+    if (mkdir(path, 0755) != 0 && errno != EEXIST) {
+        fail("cache: could not create %s\n", path);
+    }
+}
+
+/**
+ * @brief 读取并更新统计信息（加文件锁，多个进程可同时更新）
+ * @param cache 编译缓存
+ * @param hits 命中次数增量
+ * @param misses 未命中次数增量
+ * @param saved 节省时间增量（纳秒）
+ */
+void update_stats(const Cache *cache, const uint64_t hits, const uint64_t misses, const uint64_t saved) {
+    char *path = join_path(cache->dir, "stats");
+    const int fd = open(path, O_RDWR | O_CREAT, 0644);
+    free(path);
+    if (fd < 0) {
+        return;
+    }
+    flock(fd, LOCK_EX);
+    CacheStats stats = {0};
+    char buf[128];
+    const ssize_t length = pread(fd, buf, sizeof(buf) - 1, 0);
+    if (length > 0) {
+        buf[length] = '\0';
+        if (sscanf(buf, "%lu %lu %lu", &stats.hits, &stats.misses, &stats.saved) != 3) {
+            stats = (CacheStats){0};
+        }
+    }
+    stats.hits += hits;
+    stats.misses += misses;
+    stats.saved += saved;
+    const int count = snprintf(buf, sizeof(buf), "%lu %lu %lu\n", stats.hits, stats.misses, stats.saved);
+    if (pwrite(fd, buf, count, 0) == count) {
+        ftruncate(fd, count);
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+}
+
+// 缓存条目（用于淘汰排序）
+typedef struct {
+    char *path; // 条目路径
+    size_t size; // 条目大小
+    time_t mtime; // 最近使用时间
+} CacheEntry;
+
+/**
+ * @brief 按最近使用时间升序排序
+ * @param a 缓存条目
+ * @param b 缓存条目
+ * @return 比较结果
+ */
+int compare_entry(const void *a, const void *b) {
+    const time_t ta = ((const CacheEntry *) a)->mtime, tb = ((const CacheEntry *) b)->mtime;
+    return ta < tb ? -1 : ta > tb;
+}
+
+/**
+ * @brief 缓存大小超出容量时，按最近使用时间从旧到新删除条目，直至不超出容量
+ * @param cache 编译缓存
+ */
+void evict(const Cache *cache) {
+    DIR *dir = opendir(cache->dir);
+    if (dir == NULL) {
+        return;
+    }
+    size_t size = 0, total = 0, capacity = 64;
+    CacheEntry *entries = malloc(sizeof(CacheEntry) * capacity);
+    const struct dirent *entry;
+    while (entries != NULL && (entry = readdir(dir)) != NULL) {
+        const size_t length = strlen(entry->d_name);
+        if (length <= strlen(CACHE_SUFFIX) ||
+            strcmp(entry->d_name + length - strlen(CACHE_SUFFIX), CACHE_SUFFIX) != 0) {
+            continue;
+        }
+        char *path = join_path(cache->dir, entry->d_name);
+        struct stat st;
+        if (stat(path, &st) != 0) {
+            free(path);
+            continue;
+        }
+        if (size == capacity) {
+            capacity = capacity * 2;
+            CacheEntry *tmp = realloc(entries, sizeof(CacheEntry) * capacity);
+            if (tmp == NULL) {
+                free(path);
+                break;
+            }
+            entries = tmp;
+        }
+        entries[size++] = (CacheEntry){path, st.st_size, st.st_mtime};
+        total += st.st_size;
+    }
+    closedir(dir);
+    if (entries == NULL) {
+        return;
+    }
+
+    qsort(entries, size, sizeof(CacheEntry), compare_entry);
+    for (size_t i = 0; i < size; ++i) {
+        if (total > cache->limit && strcmp(entries[i].path, cache->path) != 0) {
+            if (unlink(entries[i].path) == 0) {
+                total -= entries[i].size;
+            }
+        }
+        free(entries[i].path);
+    }
+    free(entries);
+}
@@ -0,0 +1,80 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_CACHE_H
+#define MCC_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "image.h"
+
+#define CACHE_DIR_ENV "MCC_CACHE_DIR" // 缓存目录环境变量，默认为 $HOME/.cache/mcc
+#define CACHE_SIZE_ENV "MCC_CACHE_SIZE" // 缓存容量环境变量（MB），默认为 CACHE_SIZE
+#define CACHE_SIZE 64 // 默认缓存容量（MB）
+
+// 编译缓存统计信息（保存在缓存目录的 stats 文件中，多个进程共享）
+typedef struct {
+    uint64_t hits; // 命中次数
+    uint64_t misses; // 未命中次数
+    uint64_t saved; // 命中时节省的编译时间（纳秒）
+} CacheStats;
+
+// 编译缓存：以源文件内容、编译器版本和编译选项的哈希值为键，保存程序映像
+typedef struct {
+    char *dir; // 缓存目录
+    size_t limit; // 缓存容量（字节），超出时淘汰最久未使用的条目
+    char key[33]; // 当前源文件的键（128 位哈希值的十六进制表示）
+    char *path; // 当前源文件对应的缓存条目路径
+} Cache;
+
+/**
+ * @brief 初始化编译缓存（缓存目录不存在时自动创建）
+ * @param cache 编译缓存
+ */
+void cache_init(Cache *cache);
+
+/**
+ * @brief 释放编译缓存
+ * @param cache 编译缓存
+ */
+void cache_free(Cache *cache);
+
+/**
+ * @brief 计算源文件的键
+ * @param cache 编译缓存
+ * @param source 源文件文本
+ * @param length 源文件长度
+ */
+void cache_key(Cache *cache, const char *source, size_t length);
+
+/**
+ * @brief 查找并加载缓存条目
+ * @param cache 编译缓存
+ * @param image 程序映像（命中时加载）
+ * @return 1:命中 0:未命中
+ */
+int cache_load(Cache *cache, Image *image);
+
+/**
+ * @brief 保存编译结果，并在超出缓存容量时淘汰最久未使用的条目
+ * @param cache 编译缓存
+ * @param parser 语法分析器（语法分析已完成）
+ * @param compile_time 编译时间（纳秒）
+ */
+void cache_store(Cache *cache, const Parser *parser, uint64_t compile_time);
+
+/**
+ * @brief 打印缓存统计信息：命中率、节省的编译时间、条目数量及大小
+ * @param cache 编译缓存
+ */
+void cache_print_stats(const Cache *cache);
+
+/**
+ * @brief 获取单调时钟的当前时间
+ * @return 纳秒
+ */
+uint64_t cache_now(void);
+
+#endif //MCC_CACHE_H
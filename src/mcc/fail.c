@@ -0,0 +1,40 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "fail.h"
+
+__thread FailPoint *fail_point; // 当前线程的错误恢复点（各线程独立，多个线程可同时编译、运行）
+
+void fail(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    if (fail_point == NULL) {
+        vprintf(format, args);
+        va_end(args);
+        exit(-1);
+    }
+    vsnprintf(fail_point->message, FAIL_SIZE, format, args);
+    va_end(args);
+    const size_t length = strlen(fail_point->message);
+    if (length > 0 && fail_point->message[length - 1] == '\n') {
+        fail_point->message[length - 1] = 0;
+    }
+    longjmp(fail_point->jump, 1);
+}
+
+FailPoint *fail_catch(FailPoint *point) {
+    FailPoint *outer = fail_point;
+    point->message[0] = 0;
+    fail_point = point;
+    return outer;
+}
+
+void fail_restore(FailPoint *outer) {
+    fail_point = outer;
+}
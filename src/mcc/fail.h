@@ -0,0 +1,40 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_FAIL_H
+#define MCC_FAIL_H
+
+#include <setjmp.h>
+
+#define FAIL_SIZE 256 // 错误信息的最大长度（含结尾的 0）
+
+// 错误恢复点：嵌入使用时（libmcc）由调用入口设置，发生错误时跳回此处，以返回值报告错误
+typedef struct {
+    jmp_buf jump; // 跳转位置（调用入口的 setjmp）
+    char message[FAIL_SIZE]; // 错误信息（不含末尾换行）
+} FailPoint;
+
+/**
+ * @brief 报告错误（词法分析、语法分析、链接、虚拟机运行等）
+ * @details 当前线程未设置错误恢复点时（命令行），打印错误信息后退出进程；
+ *          否则保存错误信息，跳回最近设置的恢复点（不返回）
+ * @param format 格式字符串（同 printf）
+ */
+void fail(const char *format, ...) __attribute__((noreturn));
+
+/**
+ * @brief 设置当前线程的错误恢复点
+ * @details 用法：outer = fail_catch(&point); if (setjmp(point.jump) == 0) { ... } fail_restore(outer);
+ * @param point 错误恢复点（跳回后 message 为错误信息）
+ * @return 此前设置的恢复点（NULL 表示未设置），结束时传给 fail_restore
+ */
+FailPoint *fail_catch(FailPoint *point);
+
+/**
+ * @brief 恢复当前线程此前的错误恢复点
+ * @param outer fail_catch 返回的恢复点
+ */
+void fail_restore(FailPoint *outer);
+
+#endif //MCC_FAIL_H
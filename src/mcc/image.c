@@ -0,0 +1,277 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "image.h"
+#include "fail.h"
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0 // 旧内核：仅作为地址提示，映射后检查实际地址
+#endif
+
+// 向上对齐
+size_t align_up(size_t size, size_t align);
+
+// 写入文件并填充至对齐位置
+void write_section(FILE *file, const void *buf, size_t size, size_t padded);
+
+// 映射段：优先映射到首选地址
+char *map_section(int fd, uint64_t base, size_t size, uint64_t offset, int prot);
+
+// 文件中 [offset, offset + size) 是否位于文件内
+int within_file(uint64_t offset, uint64_t size, size_t f_size);
+
+// 检查映像文件头及重定位表：各段、入口及重定位位置均位于文件及代码段内
+int image_check(const ImageHeader *header, const char *file, size_t f_size);
+
+/**
+ * @brief 将语法分析的结果写入程序映像文件
+ * @param parser 语法分析器（语法分析已完成）
+ * @param path 映像文件路径
+ * @param compile_time 编译时间（纳秒，0 表示未知）
+ */
+void image_write(const Parser *parser, const char *path, const uint64_t compile_time) {
+    if (parser->main_entry == NULL) {
+        fail("main function is not defined\n");
+    }
+    const size_t t_size = parser->text - parser->o_text + 1; // 代码段从 o_text[0] 开始计算偏移
+    const size_t d_size = parser->data - parser->o_data;
+
+    ImageHeader header = {0};
+    header.magic = IMAGE_MAGIC;
+    header.version = IMAGE_VERSION;
+    header.text_size = align_up(t_size * sizeof(int64_t), IMAGE_ALIGN);
+    header.data_size = align_up(d_size > 0 ? d_size : 1, IMAGE_ALIGN);
+    header.text_base = IMAGE_TEXT_BASE;
+    header.data_base = align_up(header.text_base + header.text_size, IMAGE_DATA_GAP);
+    header.entry = parser->main_entry - parser->o_text;
+    header.r_size = parser->r_size;
+    header.ln_size = parser->ln_size;
+    header.text_offset = IMAGE_ALIGN;
+    header.data_offset = header.text_offset + header.text_size;
+    header.reloc_offset = header.data_offset + header.data_size;
+    header.line_offset = header.reloc_offset + sizeof(Reloc) * parser->r_size;
+    header.compile_time = compile_time;
+
+    // 代码段中的绝对地址改写为首选加载地址
+    int64_t *text = malloc(t_size * sizeof(int64_t));
+    if (text == NULL) {
+        fail("image: malloc memory failed\n");
+    }
+    memcpy(text, parser->o_text, t_size * sizeof(int64_t));
+    for (size_t i = 0; i < parser->r_size; ++i) {
+        const Reloc *reloc = parser->relocs + i;
+        if (reloc->kind == RELOC_TEXT) {
+            text[reloc->offset] = text[reloc->offset] - (int64_t) parser->o_text + (int64_t) header.text_base;
+        } else {
+            text[reloc->offset] = text[reloc->offset] - (int64_t) parser->o_data + (int64_t) header.data_base;
+        }
+    }
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        fail("could not open(%s)\n", path);
+    }
+    write_section(file, &header, sizeof(header), header.text_offset);
+    write_section(file, text, t_size * sizeof(int64_t), header.text_size);
+    write_section(file, parser->o_data, d_size, header.data_size);
+    write_section(file, parser->relocs, sizeof(Reloc) * parser->r_size, sizeof(Reloc) * parser->r_size);
+    write_section(file, parser->lines, sizeof(LineInfo) * parser->ln_size, sizeof(LineInfo) * parser->ln_size);
+    if (fclose(file) != 0) {
+        fail("could not write(%s)\n", path);
+    }
+    free(text);
+}
+
+/**
+ * @brief 判断文件是否为程序映像（仅检查普通文件，管道等读取后无法再作为源文件读取）
+ * @param path 文件路径
+ * @return 1:是程序映像 0:不是程序映像
+ */
+int image_probe(const char *path) {
+    const int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return 0;
+    }
+    uint32_t magic = 0;
+    const ssize_t length = read(fd, &magic, sizeof(magic));
+    close(fd);
+    return length == sizeof(magic) && magic == IMAGE_MAGIC;
+}
+
+/**
+ * @brief 加载程序映像
+ * @param image 程序映像
+ * @param path 映像文件路径
+ */
+void image_load(Image *image, const char *path) {
+    const int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        fail("could not open(%s)\n", path);
+    }
+    if (sysconf(_SC_PAGESIZE) > IMAGE_ALIGN) {
+        fail("image: page size %ld is not supported\n", sysconf(_SC_PAGESIZE));
+    }
+    image->f_size = st.st_size;
+    image->file = mmap(NULL, image->f_size, PROT_READ, MAP_SHARED, fd, 0);
+    const ImageHeader *header = (const ImageHeader *) image->file;
+    if (image->file == MAP_FAILED || image->f_size < sizeof(ImageHeader) ||
+        !image_check(header, image->file, image->f_size)) {
+        fail("bad image %s\n", path);
+    }
+
+    char *text = map_section(fd, header->text_base, header->text_size, header->text_offset, PROT_READ);
+    char *data = map_section(fd, header->data_base, header->data_size, header->data_offset, PROT_READ | PROT_WRITE);
+    close(fd);
+
+    // 未能在首选地址加载：临时将代码段设为可写，应用重定位
+    const int64_t text_delta = (int64_t) text - (int64_t) header->text_base;
+    const int64_t data_delta = (int64_t) data - (int64_t) header->data_base;
+    image->relocated = text_delta != 0 || data_delta != 0;
+    if (image->relocated) {
+        const Reloc *relocs = (const Reloc *) (image->file + header->reloc_offset);
+        int64_t *words = (int64_t *) text;
+        mprotect(text, header->text_size, PROT_READ | PROT_WRITE);
+        for (size_t i = 0; i < header->r_size; ++i) {
+            words[relocs[i].offset] += relocs[i].kind == RELOC_TEXT ? text_delta : data_delta;
+        }
+        mprotect(text, header->text_size, PROT_READ);
+    }
+
+    image->text = (int64_t *) text;
+    image->t_size = header->text_size / sizeof(int64_t);
+    image->data = data;
+    image->d_size = header->data_size;
+    image->entry = image->text + header->entry;
+    image->lines = (const LineInfo *) (image->file + header->line_offset);
+    image->ln_size = header->ln_size;
+    image->compile_time = header->compile_time;
+}
+
+void image_free(Image *image) {
+    if (image->text != NULL) {
+        munmap(image->text, image->t_size * sizeof(int64_t));
+        image->text = NULL;
+    }
+    if (image->data != NULL) {
+        munmap(image->data, image->d_size);
+        image->data = NULL;
+    }
+    if (image->file != NULL) {
+        munmap((void *) image->file, image->f_size);
+        image->file = NULL;
+    }
+}
+
+/**
+ * @brief 向上对齐
+ * @param size 大小
+ * @param align 对齐值（2 的幂）
+ * @return 对齐后的大小
+ */
+size_t align_up(const size_t size, const size_t align) {
+    return (size + align - 1) & ~(align - 1);
+}
+
+/**
+ * @brief 写入文件并填充 0 至指定大小
+ * @param file 文件
+ * @param buf 数据
+ * @param size 数据大小
+ * @param padded 填充后的大小
+ */
+void write_section(FILE *file, const void *buf, const size_t size, const size_t padded) {
+    static const char zeros[IMAGE_ALIGN];
+    if (size > 0 && fwrite(buf, 1, size, file) != size) {
+        fail("image: write failed\n");
+    }
+    for (size_t left = padded - size; left > 0;) {
+        const size_t count = left < sizeof(zeros) ? left : sizeof(zeros);
+        if (fwrite(zeros, 1, count, file) != count) {
+            fail("image: write failed\n");
+        }
+        left -= count;
+    }
+}
+
+/**
+ * @brief 文件中 [offset, offset + size) 是否位于文件内（不会溢出）
+ * @param offset 起始偏移
+ * @param size 字节数
+ * @param f_size 文件大小
+ * @return 1:位于文件内 0:超出文件
+ */
+int within_file(const uint64_t offset, const uint64_t size, const size_t f_size) {
+    return offset <= f_size && size <= f_size - offset;
+}
+
+/**
+ * @brief 检查映像文件头及重定位表，截断或损坏的映像文件不能映射或重定位到文件及段之外
+ * @param header 映像文件头（文件不小于文件头）
+ * @param file 映像文件的只读映射
+ * @param f_size 映像文件大小
+ * @return 1:有效 0:无效
+ */
+int image_check(const ImageHeader *header, const char *file, const size_t f_size) {
+    if (header->magic != IMAGE_MAGIC || header->version != IMAGE_VERSION ||
+        !within_file(header->text_offset, header->text_size, f_size) ||
+        !within_file(header->data_offset, header->data_size, f_size) ||
+        header->reloc_offset % _Alignof(Reloc) != 0 || header->line_offset % _Alignof(LineInfo) != 0 ||
+        header->r_size > f_size / sizeof(Reloc) ||
+        !within_file(header->reloc_offset, sizeof(Reloc) * header->r_size, f_size) ||
+        header->ln_size > f_size / sizeof(LineInfo) ||
+        !within_file(header->line_offset, sizeof(LineInfo) * header->ln_size, f_size)) {
+        return 0;
+    }
+    const uint64_t t_size = header->text_size / sizeof(int64_t);
+    if (header->entry >= t_size) {
+        return 0;
+    }
+    const Reloc *relocs = (const Reloc *) (file + header->reloc_offset);
+    for (size_t i = 0; i < header->r_size; ++i) {
+        if (relocs[i].offset >= t_size) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief 映射段：优先映射到首选地址，首选地址被占用时由内核选择地址
+ * @details 映射到首选地址以外时，由调用方临时修改访问权限并应用重定位
+ * @param fd 映像文件
+ * @param base 首选地址
+ * @param size 段大小
+ * @param offset 段在文件中的偏移
+ * @param prot 访问权限
+ * @return 段的实际地址
+ */
+char *map_section(const int fd, const uint64_t base, const size_t size, const uint64_t offset, const int prot) {
+    char *addr = mmap((void *) base, size, prot, MAP_PRIVATE | MAP_FIXED_NOREPLACE, fd, (off_t) offset);
+    if (addr != MAP_FAILED && addr != (char *) base) {
+        munmap(addr, size); // 旧内核忽略了 MAP_FIXED_NOREPLACE
+        addr = MAP_FAILED;
+    }
+    if (addr == MAP_FAILED) {
+        addr = mmap(NULL, size, prot, MAP_PRIVATE, fd, (off_t) offset);
+    }
+    if (addr == MAP_FAILED) {
+        fail("image: mmap failed\n");
+    }
+    return addr;
+}
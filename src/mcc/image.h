@@ -0,0 +1,83 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_IMAGE_H
+#define MCC_IMAGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "parser.h"
+
+#define IMAGE_MAGIC 0x0142434d // "MCB\1"
+#define IMAGE_VERSION 2 // 映像格式版本（操作码编号变化时需更新）
+#define IMAGE_ALIGN 16384 // 段对齐（文件偏移及加载地址均按此对齐，以便直接 mmap）
+#define IMAGE_TEXT_BASE 0x6d6300000000 // 代码段首选加载地址
+#define IMAGE_DATA_GAP (2 * 1024 * 1024) // 数据段首选加载地址按此对齐，位于代码段之后
+
+// 程序映像文件头
+typedef struct {
+    uint32_t magic; // 魔数：IMAGE_MAGIC
+    uint32_t version; // 格式版本：IMAGE_VERSION
+    uint64_t text_base; // 代码段首选加载地址（代码段中的绝对地址均按首选加载地址写入）
+    uint64_t data_base; // 数据段首选加载地址
+    uint64_t text_size; // 代码段大小（字节，已对齐）
+    uint64_t data_size; // 数据段大小（字节，已对齐）
+    uint64_t entry; // main 函数入口在代码段中的偏移（以 int64_t 为单位）
+    uint64_t r_size; // 重定位表条目数量
+    uint64_t ln_size; // 行号表条目数量
+    uint64_t text_offset; // 代码段在文件中的偏移
+    uint64_t data_offset; // 数据段在文件中的偏移
+    uint64_t reloc_offset; // 重定位表在文件中的偏移
+    uint64_t line_offset; // 行号表在文件中的偏移
+    uint64_t compile_time; // 生成此映像所用的编译时间（纳秒，0 表示未知）
+} ImageHeader;
+
+// 已加载的程序映像
+typedef struct {
+    int64_t *text; // 代码段（只读映射）
+    size_t t_size; // 代码段大小（以 int64_t 为单位）
+    char *data; // 数据段（私有可写映射）
+    size_t d_size; // 数据段大小（字节）
+    int64_t *entry; // main 函数入口
+    const LineInfo *lines; // 行号表
+    size_t ln_size; // 行号表：条目数量
+    const char *file; // 整个映像文件的只读映射
+    size_t f_size; // 映像文件大小
+    int relocated; // 是否未能在首选地址加载，从而执行了重定位
+    uint64_t compile_time; // 生成此映像所用的编译时间（纳秒，0 表示未知）
+} Image;
+
+/**
+ * @brief 将语法分析的结果写入程序映像文件
+ * @details 代码段中的绝对地址按首选加载地址改写，同时写入重定位表，以便在其它地址加载
+ * @param parser 语法分析器（语法分析已完成）
+ * @param path 映像文件路径
+ * @param compile_time 编译时间（纳秒，0 表示未知）
+ */
+void image_write(const Parser *parser, const char *path, uint64_t compile_time);
+
+/**
+ * @brief 判断文件是否为程序映像
+ * @param path 文件路径
+ * @return 1:是程序映像 0:不是程序映像
+ */
+int image_probe(const char *path);
+
+/**
+ * @brief 加载程序映像
+ * @details 代码段只读映射，数据段私有可写映射；优先映射到首选地址（无需重定位，多个进程共享代码段物理页），
+ * 首选地址不可用时映射到任意地址并应用重定位
+ * @param image 程序映像
+ * @param path 映像文件路径
+ */
+void image_load(Image *image, const char *path);
+
+/**
+ * @brief 卸载程序映像
+ * @param image 程序映像
+ */
+void image_free(Image *image);
+
+#endif //MCC_IMAGE_H
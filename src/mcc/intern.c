@@ -0,0 +1,180 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "intern.h"
+#include "fail.h"
+
+#define INTERN_BLOCK (64 * 1024) // arena 内存块大小
+#define INTERN_CAPACITY 1024 // 哈希表初始容量（2 的幂）
+
+// 从 arena 中分配内存
+char *intern_alloc(Interner *interner, size_t size);
+
+// 哈希表扩容
+void intern_resize(Interner *interner);
+
+/**
+ * @brief 计算字符串的哈希值
+ * @param chars 字符串
+ * @return hashcode
+ */
+int hash_string(const char *chars) {
+    return hash_chars(chars, strlen(chars));
+}
+
+/**
+ * @brief 计算指定长度的字符串的哈希值
+ * @details FNV-1a 逐字节混合，最后经 murmur3 的 fmix32 雪崩：任一输入位的变化影响全部输出位，
+ * 低位同样分布均匀，适合直接按 2 的幂取模作为开放寻址哈希表的下标
+ * @param chars 字符串
+ * @param length 长度
+ * @return hashcode
+ */
+int hash_chars(const char *chars, const size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash = (hash ^ (unsigned char) chars[i]) * 16777619u;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return (int) hash;
+}
+
+/**
+ * @brief 驻留字符串的哈希值：驻留时保存在字符串之前，无需重新计算
+ * @param chars 驻留的字符串
+ * @return hashcode
+ */
+int intern_hash(const char *chars) {
+    int hash;
+    memcpy(&hash, chars - sizeof(int), sizeof(int));
+    return hash;
+}
+
+void intern_init(Interner *interner) {
+    interner->blocks = NULL;
+    interner->b_size = 0;
+    interner->b_capacity = 0;
+    interner->top = NULL;
+    interner->left = 0;
+    interner->size = 0;
+    interner->mask = INTERN_CAPACITY - 1;
+    interner->table = calloc(INTERN_CAPACITY, sizeof(Interned));
+    interner->n_capacity = INTERN_CAPACITY / 2;
+    interner->names = malloc(sizeof(char *) * interner->n_capacity);
+    if (interner->table == NULL || interner->names == NULL) {
+        fail("intern: malloc memory failed\n");
+    }
+}
+
+void intern_free(Interner *interner) {
+    for (size_t i = 0; i < interner->b_size; ++i) {
+        free(interner->blocks[i]);
+    }
+    free(interner->blocks);
+    free(interner->table);
+    free(interner->names);
+    interner->blocks = NULL;
+    interner->table = NULL;
+    interner->names = NULL;
+    interner->b_size = 0;
+    interner->size = 0;
+}
+
+const char *intern(Interner *interner, const char *chars, const size_t length, const int hash) {
+    return interner->names[intern_id(interner, chars, length, hash)];
+}
+
+uint32_t intern_id(Interner *interner, const char *chars, const size_t length, const int hash) {
+    size_t i = (size_t) (unsigned) hash & interner->mask;
+    while (interner->table[i].chars != NULL) {
+        const Interned *entry = interner->table + i;
+        if (entry->hash == hash && entry->length == length && memcmp(entry->chars, chars, length) == 0) {
+            return entry->id;
+        }
+        i = (i + 1) & interner->mask;
+    }
+    char *copy = intern_alloc(interner, sizeof(int) + length + 1);
+    memcpy(copy, &hash, sizeof(int)); // 哈希值保存在字符串之前
+    copy += sizeof(int);
+    memcpy(copy, chars, length);
+    copy[length] = '\0';
+    const uint32_t id = (uint32_t) interner->size;
+    interner->table[i] = (Interned){copy, (uint32_t) length, hash, id};
+    interner->names[id] = copy;
+    if (++interner->size * 2 > interner->mask) {
+        intern_resize(interner); // 装载因子超过 1/2
+    }
+    return id;
+}
+
+/**
+ * @brief 从 arena 中分配内存（当前内存块不足时分配新的内存块）
+ * @param interner 字符串驻留表
+ * @param size 字节数
+ * @return 分配的内存
+ */
+char *intern_alloc(Interner *interner, const size_t size) {
+    if (size > interner->left) {
+        const size_t b_size = size > INTERN_BLOCK ? size : INTERN_BLOCK;
+        if (interner->b_size == interner->b_capacity) {
+            interner->b_capacity = interner->b_capacity > 0 ? interner->b_capacity * 2 : 16;
+            char **blocks = realloc(interner->blocks, sizeof(char *) * interner->b_capacity);
+            if (blocks == NULL) {
+                fail("intern: realloc memory failed\n");
+            }
+            interner->blocks = blocks;
+        }
+        char *block = malloc(b_size);
+        if (block == NULL) {
+            fail("intern: malloc memory failed\n");
+        }
+        interner->blocks[interner->b_size++] = block;
+        interner->top = block;
+        interner->left = b_size;
+    }
+    char *chars = interner->top;
+    interner->top += size;
+    interner->left -= size;
+    return chars;
+}
+
+/**
+ * @brief 哈希表扩容（容量翻倍，重新插入全部条目，names 数组随之扩容）
+ * @param interner 字符串驻留表
+ */
+void intern_resize(Interner *interner) {
+    const size_t capacity = (interner->mask + 1) * 2;
+    Interned *table = calloc(capacity, sizeof(Interned));
+    if (table == NULL) {
+        fail("intern: malloc memory failed\n");
+    }
+    for (size_t i = 0; i <= interner->mask; ++i) {
+        const Interned *entry = interner->table + i;
+        if (entry->chars != NULL) {
+            size_t j = (size_t) (unsigned) entry->hash & (capacity - 1);
+            while (table[j].chars != NULL) {
+                j = (j + 1) & (capacity - 1);
+            }
+            table[j] = *entry;
+        }
+    }
+    free(interner->table);
+    interner->table = table;
+    interner->mask = capacity - 1;
+    // 字符串数量不超过哈希表容量的 1/2
+    interner->n_capacity = capacity / 2;
+    const char **names = realloc(interner->names, sizeof(char *) * interner->n_capacity);
+    if (names == NULL) {
+        fail("intern: realloc memory failed\n");
+    }
+    interner->names = names;
+}
@@ -0,0 +1,89 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_INTERN_H
+#define MCC_INTERN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 驻留表条目
+typedef struct {
+    const char *chars; // 驻留的字符串（位于 arena 中，以 0 结尾，之前保存哈希值）
+    uint32_t length; // 字符串长度
+    int hash; // 字符串的哈希值
+    uint32_t id; // 编号（驻留的先后顺序）
+} Interned;
+
+// 字符串驻留表：字符串保存在大块连续内存（arena）中，相同的字符串只保存一份，
+// 驻留后的指针即为字符串的唯一标识，比较两个驻留字符串只需比较指针；
+// 按驻留顺序编号，词法单元只需保存 4 字节的编号，经 names 取得字符串
+typedef struct {
+    char **blocks; // arena 内存块
+    size_t b_size; // 内存块数量
+    size_t b_capacity; // blocks 数组容量
+    char *top; // 当前内存块的空闲位置
+    size_t left; // 当前内存块的剩余字节数
+    Interned *table; // 哈希表（开放寻址，线性探测）
+    size_t size; // 驻留的字符串数量
+    size_t mask; // 哈希表容量 - 1
+    const char **names; // 驻留的字符串（按编号排列）
+    size_t n_capacity; // names 数组容量
+} Interner;
+
+/**
+ * @brief 计算字符串的哈希值
+ * @param chars 字符串
+ * @return 哈希值
+ */
+int hash_string(const char *chars);
+
+/**
+ * @brief 计算指定长度的字符串的哈希值（与 hash_string 一致）
+ * @param chars 字符串
+ * @param length 长度
+ * @return 哈希值
+ */
+int hash_chars(const char *chars, size_t length);
+
+/**
+ * @brief 驻留字符串的哈希值（驻留时已计算，与 hash_chars 一致）
+ * @param chars 驻留的字符串（intern 的返回值）
+ * @return 哈希值
+ */
+int intern_hash(const char *chars);
+
+/**
+ * @brief 初始化字符串驻留表
+ * @param interner 字符串驻留表
+ */
+void intern_init(Interner *interner);
+
+/**
+ * @brief 释放字符串驻留表（所有驻留的字符串随之释放）
+ * @param interner 字符串驻留表
+ */
+void intern_free(Interner *interner);
+
+/**
+ * @brief 驻留字符串：已存在时返回已有的副本，否则复制到 arena 中
+ * @param interner 字符串驻留表
+ * @param chars 字符串（不必以 0 结尾）
+ * @param length 长度
+ * @param hash 哈希值（hash_chars 计算所得）
+ * @return 驻留的字符串
+ */
+const char *intern(Interner *interner, const char *chars, size_t length, int hash);
+
+/**
+ * @brief 驻留字符串并返回其编号（同一驻留表中相同的字符串编号相同），字符串为 interner->names[编号]
+ * @param interner 字符串驻留表
+ * @param chars 字符串（不必以 0 结尾）
+ * @param length 长度
+ * @param hash 哈希值（hash_chars 计算所得）
+ * @return 编号
+ */
+uint32_t intern_id(Interner *interner, const char *chars, size_t length, int hash);
+
+#endif //MCC_INTERN_H
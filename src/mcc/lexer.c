@@ -2,14 +2,27 @@
 // Created by Patrick.Lau on 2025/5/31.
 //
 
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <malloc.h>
+#include <unistd.h>
 
 #include "lexer.h"
+#include "pool.h"
+#include "fail.h"
 
-#define CAPACITY 1024 // tokens 初始容量
+#define CAPACITY 1024 // 词法单元数组最小初始容量
+#define TOKEN_BYTES 4 // 预估平均每个词法单元（含空白）占用的源码字节数，用于确定初始容量
+#define IDENT_SHORT 8 // 标识符前若干字节逐字节扫描，更长时才使用 SIMD 扫描
+#define LINE_CAPACITY 256 // 行号表初始容量
+#define CHUNK_SIZE (1 << 20) // 并行词法分析时每块源码的最小字节数
+
+// 源码块：并行词法分析时由一个线程扫描 [lexer.s_index, end)
+typedef struct {
+    Lexer lexer; // 块内的词法分析器
+    Interner interner; // 块内的字符串驻留表（各线程互不共享，拼接时驻留到整个源码的驻留表）
+    size_t end; // 块的结束位置（换行符之后）
+} Chunk;
 
 // 是否为数字
 int is_digit(char c);
@@ -20,17 +33,32 @@ int is_alpha(char c);
 // 跳过当前行
 void skip_line(Lexer *lexer);
 
-// tokens 数组扩容
-void resize(Lexer *lexer);
+// 初始化词法分析器的源码和扫描状态（不分配词法单元数组）
+void init_state(Lexer *lexer, char *source, Interner *interner);
+
+// 按源码长度预估词法单元数组的初始容量
+size_t estimate_tokens(size_t length);
+
+// 分配词法单元数组和行号表
+void alloc_tokens(Lexer *lexer, size_t t_capacity, size_t l_capacity);
+
+// 词法单元数组扩容
+void resize(Lexer *lexer, size_t capacity);
 
 // 分析并创建 token
 void analyse(Lexer *lexer);
 
-// 添加 token 到 tokens 数组
-void add_token(Lexer *lexer, TokenKind kind, const char *lexeme);
+// 添加词素为当前字符起的 count 个字符的 token
+void add_token(Lexer *lexer, TokenKind kind, size_t count);
+
+// 添加 token
+void add_lexeme(Lexer *lexer, TokenKind kind, size_t start, size_t count, int64_t value);
+
+// 添加行号表条目
+void add_line_run(Lexer *lexer, size_t index, size_t line);
 
-// 截取子串
-char *substr(const char *source, size_t start, size_t count);
+// 查找词法单元所在的行号表条目
+size_t find_run(const Lexer *lexer, size_t index);
 
 // 添加数值类型 Token
 void number(Lexer *lexer);
@@ -41,28 +69,49 @@ void string(Lexer *lexer);
 // 添加标识符类型 Token
 void identifier(Lexer *lexer);
 
-// 判断是否为关键字类型 Token，是则添加到数组中
-int keyword(Lexer *lexer, const char *keyword, int length, TokenKind type);
+// 判断标识符是否为关键字
+TokenKind classify(const char *chars, size_t length);
 
-void lexer_init(Lexer *lexer, char *source) {
-    lexer->s_length = strlen(source);
-    lexer->s_index = 0;
-    lexer->t_capacity = CAPACITY;
-    lexer->t_size = 0;
-    lexer->line = 1;
-    lexer->source = source;
-    lexer->tokens = malloc(sizeof(Token) * lexer->t_capacity);
-    if (lexer->tokens == NULL) {
-        printf("tokens: malloc memory failed.");
-        exit(-1);
+// 将另一驻留表中的标识符编号换为本驻留表中的编号
+void remap_ids(Lexer *lexer, const Lexer *other, size_t from, size_t count);
+
+// 查找源码块的切分位置
+size_t split_chunks(const Lexer *lexer, size_t count, size_t *splits, size_t *lines);
+
+// 扫描一个源码块
+void analyse_chunk(void *arg);
+
+void lexer_init(Lexer *lexer, char *source, Interner *interner) {
+    init_state(lexer, source, interner);
+    alloc_tokens(lexer, estimate_tokens(lexer->s_length), LINE_CAPACITY);
+}
+
+void lexer_init_stream(Lexer *lexer, char *source, const size_t capacity, Interner *interner) {
+    init_state(lexer, source, interner);
+    // 每行至少一个词法单元：最近的 capacity 个行号表条目覆盖最近的 capacity 个词法单元
+    alloc_tokens(lexer, capacity, capacity);
+    lexer->t_mask = capacity - 1;
+    lexer->l_mask = capacity - 1;
+}
+
+int lexer_next(Lexer *lexer) {
+    const size_t t_size = lexer->t_size;
+    while (lexer->s_index < lexer->s_length && lexer->t_size == t_size) {
+        analyse(lexer);
+        lexer->s_index++;
     }
+    return lexer->t_size != t_size;
 }
 
 void lexer_free(Lexer *lexer) {
-    if (lexer->source != NULL) {
-        free(lexer->source);
-        lexer->source = NULL;
-    }
+    free(lexer->values); // 各列位于同一内存块
+    free(lexer->lines);
+    lexer->kinds = NULL;
+    lexer->offsets = NULL;
+    lexer->lengths = NULL;
+    lexer->values = NULL;
+    lexer->ids = NULL;
+    lexer->lines = NULL;
 }
 
 void lexer_analyse(Lexer *lexer) {
@@ -73,16 +122,202 @@ void lexer_analyse(Lexer *lexer) {
     }
 }
 
+void lexer_analyse_parallel(Lexer *lexer, size_t jobs) {
+    const size_t length = lexer->s_length - lexer->s_index;
+    if (jobs == 0) {
+        const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        jobs = cpus > 0 ? (size_t) cpus : 1;
+    }
+    if (jobs > length / CHUNK_SIZE) {
+        jobs = length / CHUNK_SIZE;
+    }
+    if (jobs < 2 || lexer->s_index != 0 || lexer->t_size != 0) {
+        lexer_analyse(lexer);
+        return;
+    }
+
+    // 1. 切分：splits[i] 为第 i 块的起始位置，lines[i] 为其行号
+    size_t *splits = malloc(sizeof(size_t) * (jobs + 1));
+    size_t *lines = malloc(sizeof(size_t) * (jobs + 1));
+    Chunk *chunks = malloc(sizeof(Chunk) * jobs);
+    if (splits == NULL || lines == NULL || chunks == NULL) {
+        fail("chunks: malloc memory failed\n");
+    }
+    const size_t count = split_chunks(lexer, jobs, splits, lines);
+
+    // 2. 各线程扫描一块（块尾为换行符，向前查看的字符仍按整个源码判断），词素位置均相对于整个源码
+    ThreadPool pool;
+    pool_init(&pool, count);
+    for (size_t i = 0; i < count; ++i) {
+        Lexer *chunk = &chunks[i].lexer;
+        *chunk = *lexer;
+        intern_init(&chunks[i].interner);
+        chunk->interner = &chunks[i].interner;
+        chunk->s_index = splits[i];
+        chunk->line = lines[i];
+        alloc_tokens(chunk, estimate_tokens(splits[i + 1] - splits[i]), LINE_CAPACITY);
+        chunks[i].end = splits[i + 1];
+        pool_submit(&pool, analyse_chunk, chunks + i);
+    }
+    pool_wait(&pool);
+    pool_free(&pool);
+
+    // 3. 按顺序拼接各块的词法单元序列
+    size_t t_size = 0;
+    for (size_t i = 0; i < count; ++i) {
+        t_size += chunks[i].lexer.t_size;
+    }
+    resize(lexer, t_size);
+    for (size_t i = 0; i < count; ++i) {
+        Lexer *chunk = &chunks[i].lexer;
+        lexer_append(lexer, chunk, 0, chunk->t_size, 0, 0);
+        lexer->line = chunk->line;
+        lexer_free(chunk);
+        intern_free(&chunks[i].interner);
+    }
+    lexer->s_index = lexer->s_length;
+    free(splits);
+    free(lines);
+    free(chunks);
+}
+
+size_t lexer_line(Lexer *lexer, const size_t index) {
+    if (lexer->l_size == 0) {
+        return lexer->line;
+    }
+    const size_t run = find_run(lexer, index);
+    lexer->l_hint = run;
+    return lexer->lines[run & lexer->l_mask].line;
+}
+
+void lexer_append(Lexer *lexer, Lexer *other, const size_t from, const size_t to, const long l_delta, const long s_delta) {
+    if (from >= to) {
+        return;
+    }
+    const size_t count = to - from;
+    const size_t base = lexer->t_size;
+    if (lexer->t_capacity < base + count) {
+        resize(lexer, base + count);
+    }
+    memcpy(lexer->kinds + base, other->kinds + from, count);
+    memcpy(lexer->lengths + base, other->lengths + from, sizeof(uint32_t) * count);
+    memcpy(lexer->values + base, other->values + from, sizeof(int64_t) * count);
+    for (size_t i = 0; i < count; ++i) {
+        lexer->offsets[base + i] = (uint32_t) (other->offsets[from + i] + s_delta);
+    }
+    if (other->interner == lexer->interner) {
+        memcpy(lexer->ids + base, other->ids + from, sizeof(uint32_t) * count);
+    } else {
+        remap_ids(lexer, other, from, count);
+    }
+    lexer->t_size += count;
+    // 行号表：from 所在的行及其后在 to 之前开始的行
+    for (size_t run = find_run(other, from); run < other->l_size && other->lines[run].index < to; ++run) {
+        const size_t index = other->lines[run].index > from ? other->lines[run].index - from : 0;
+        add_line_run(lexer, base + index, other->lines[run].line + l_delta);
+    }
+}
+
+/**
+ * @brief 将 other 的词法单元 [from, from + count) 中标识符的编号换为 lexer 的驻留表中的编号，
+ * 写入 lexer 的 [t_size, t_size + count)；每个不同的标识符只驻留一次
+ * @param lexer 词法分析器（各列容量足够）
+ * @param other 词法单元来源
+ * @param from 起始索引
+ * @param count 词法单元数量
+ */
+void remap_ids(Lexer *lexer, const Lexer *other, const size_t from, const size_t count) {
+    const Interner *source = other->interner;
+    uint32_t *map = malloc(sizeof(uint32_t) * (source->size > 0 ? source->size : 1));
+    if (map == NULL) {
+        fail("ids: malloc memory failed\n");
+    }
+    memset(map, 0xff, sizeof(uint32_t) * source->size); // UINT32_MAX：尚未驻留
+    uint32_t *ids = lexer->ids + lexer->t_size;
+    for (size_t i = 0; i < count; ++i) {
+        if (other->kinds[from + i] != TK_ID) {
+            ids[i] = 0;
+            continue;
+        }
+        const uint32_t id = other->ids[from + i];
+        if (map[id] == UINT32_MAX) {
+            const char *name = source->names[id];
+            map[id] = intern_id(lexer->interner, name, other->lengths[from + i], intern_hash(name));
+        }
+        ids[i] = map[id];
+    }
+    free(map);
+}
+
+/**
+ * @brief 查找源码块的切分位置
+ * @details 按与词法分析相同的规则跳过字符串和注释，只在其外的换行处切分（块的起始位置为换行符之后），
+ * 且切分后的首个非空白字符不能是 '.'（'.' 需根据前一个 token 判断是成员访问还是小数）
+ * @param lexer 词法分析器
+ * @param count 期望的块数
+ * @param splits 各块的起始位置（最后一项为源码长度）
+ * @param lines 各块起始位置的行号（字符串中的换行不计数，与词法分析一致）
+ * @return 实际的块数
+ */
+size_t split_chunks(const Lexer *lexer, const size_t count, size_t *splits, size_t *lines) {
+    const char *source = lexer->source;
+    const size_t length = lexer->s_length;
+    size_t size = 0, i = 0, line = 1;
+    lines[size] = line;
+    splits[size++] = 0;
+    while (i < length && size < count) {
+        const char c = source[i];
+        if (c == '"' || c == '\'') {
+            // 字符串：至下一个引号（单双引号均可）为止
+            i = lexer->scanner->quote(source, i + 1, length) + 1;
+            continue;
+        }
+        if (c == '#' || (c == '/' && source[i + 1] == '/')) {
+            // 注释和预处理语句：至行尾为止
+            i = lexer->scanner->line(source, i + 1, length);
+            continue;
+        }
+        ++i;
+        if (c != '\n') {
+            continue;
+        }
+        ++line;
+        if (i >= length / count * size) {
+            size_t j = i;
+            while (j < length && (source[j] == ' ' || source[j] == '\t' || source[j] == '\r' || source[j] == '\n')) {
+                ++j;
+            }
+            if (j < length && source[j] != '.') {
+                lines[size] = line;
+                splits[size++] = i;
+            }
+        }
+    }
+    splits[size] = length;
+    return size;
+}
+
+/**
+ * @brief 扫描一个源码块
+ * @param arg 源码块
+ */
+void analyse_chunk(void *arg) {
+    Chunk *chunk = arg;
+    Lexer *lexer = &chunk->lexer;
+    while (lexer->s_index < chunk->end) {
+        analyse(lexer);
+        lexer->s_index++;
+    }
+}
+
 /**
  * @brief 跳过当前行
  * @param lexer 词法分析器
  */
 void skip_line(Lexer *lexer) {
-    while (lexer->s_index < lexer->s_length) {
-        if (lexer->source[++lexer->s_index] == '\n') {
-            ++lexer->line;
-            break;
-        }
+    lexer->s_index = lexer->scanner->line(lexer->source, lexer->s_index + 1, lexer->s_length);
+    if (lexer->s_index < lexer->s_length) {
+        ++lexer->line;
     }
 }
 
@@ -96,6 +331,10 @@ void analyse(Lexer *lexer) {
         case ' ':
         case '\t':
         case '\r':
+            // 跳过连续的空白（换行符除外，单个空白无需扫描），停在最后一个空白字符上
+            if (lexer->source[lexer->s_index + 1] == c) {
+                lexer->s_index = lexer->scanner->blank(lexer->source, lexer->s_index + 2, lexer->s_length) - 1;
+            }
             break;
         case '\n':
             ++lexer->line;
@@ -105,8 +344,8 @@ void analyse(Lexer *lexer) {
             break;
         }
         case '.': {
-            if (lexer->tokens[lexer->t_size - 1].kind == TK_ID) {
-                add_token(lexer, TK_DOT, NULL);
+            if (lexer->t_size > 0 && lexer->kinds[(lexer->t_size - 1) & lexer->t_mask] == TK_ID) {
+                add_token(lexer, TK_DOT, 1);
             } else {
                 number(lexer);
             }
@@ -114,337 +353,488 @@ void analyse(Lexer *lexer) {
         }
         case '+': {
             if (lexer->source[lexer->s_index + 1] == '+') {
-                add_token(lexer, TK_INC, NULL);
+                add_token(lexer, TK_INC, 2);
                 ++lexer->s_index;
             } else {
-                add_token(lexer, TK_PLUS, NULL);
+                add_token(lexer, TK_PLUS, 1);
             }
             break;
         }
         case '-': {
             const char pc = lexer->source[lexer->s_index + 1];
             if (pc == '-') {
-                add_token(lexer, TK_DEC, NULL);
+                add_token(lexer, TK_DEC, 2);
                 ++lexer->s_index;
             } else if (pc == '>') {
-                add_token(lexer, TK_POINT, NULL);
+                add_token(lexer, TK_POINT, 2);
                 ++lexer->s_index;
             } else {
-                add_token(lexer, TK_MINUS, NULL);
+                add_token(lexer, TK_MINUS, 1);
             }
             break;
         }
         case '*': {
-            add_token(lexer, TK_STAR, NULL);
+            add_token(lexer, TK_STAR, 1);
             break;
         }
         case '/': {
             if (lexer->source[lexer->s_index + 1] == '/') {
                 skip_line(lexer);
             } else {
-                add_token(lexer, TK_SLASH, NULL);
+                add_token(lexer, TK_SLASH, 1);
             }
             break;
         }
         case '%': {
-            add_token(lexer, TK_MOD, NULL);
+            add_token(lexer, TK_MOD, 1);
             break;
         }
         case '!': {
             if (lexer->source[lexer->s_index + 1] == '=') {
-                add_token(lexer, TK_NE, NULL);
+                add_token(lexer, TK_NE, 2);
                 ++lexer->s_index;
             } else {
-                add_token(lexer, TK_NOT, NULL);
+                add_token(lexer, TK_NOT, 1);
             }
             break;
         }
         case '=': {
             if (lexer->source[lexer->s_index + 1] == '=') {
-                add_token(lexer, TK_EQUAL, NULL);
+                add_token(lexer, TK_EQUAL, 2);
                 ++lexer->s_index;
             } else {
-                add_token(lexer, TK_ASSIGN, NULL);
+                add_token(lexer, TK_ASSIGN, 1);
             }
             break;
         }
         case '?': {
-            add_token(lexer, TK_CONDITION, NULL);
+            add_token(lexer, TK_CONDITION, 1);
             break;
         }
         case ':': {
-            add_token(lexer, TK_COLON, NULL);
+            add_token(lexer, TK_COLON, 1);
             break;
         }
         case '&': {
             if (lexer->source[lexer->s_index + 1] == '&') {
-                add_token(lexer, TK_LAND, NULL);
+                add_token(lexer, TK_LAND, 2);
                 ++lexer->s_index;
             } else {
-                add_token(lexer, TK_AND, NULL);
+                add_token(lexer, TK_AND, 1);
             }
             break;
         }
         case '|': {
             if (lexer->source[lexer->s_index + 1] == '|') {
-                add_token(lexer, TK_LOR, NULL);
+                add_token(lexer, TK_LOR, 2);
                 ++lexer->s_index;
             } else {
-                add_token(lexer, TK_OR, NULL);
+                add_token(lexer, TK_OR, 1);
             }
             break;
         }
         case '^': {
-            add_token(lexer, TK_XOR, NULL);
+            add_token(lexer, TK_XOR, 1);
             break;
         }
         case '~': {
-            add_token(lexer, TK_TILDE, NULL);
+            add_token(lexer, TK_TILDE, 1);
             break;
         }
         case '<': {
             const char pc = lexer->source[lexer->s_index + 1];
             if (pc == '<') {
-                add_token(lexer, TK_SHL, NULL);
+                add_token(lexer, TK_SHL, 2);
                 ++lexer->s_index;
             } else if (pc == '=') {
-                add_token(lexer, TK_LE, NULL);
+                add_token(lexer, TK_LE, 2);
                 ++lexer->s_index;
             } else {
-                add_token(lexer, TK_LT, NULL);
+                add_token(lexer, TK_LT, 1);
             }
             break;
         }
         case '>': {
             const char pc = lexer->source[lexer->s_index + 1];
             if (pc == '>') {
-                add_token(lexer, TK_SHR, NULL);
+                add_token(lexer, TK_SHR, 2);
                 ++lexer->s_index;
             } else if (pc == '=') {
-                add_token(lexer, TK_GE, NULL);
+                add_token(lexer, TK_GE, 2);
                 ++lexer->s_index;
             } else {
-                add_token(lexer, TK_GT, NULL);
+                add_token(lexer, TK_GT, 1);
             }
             break;
         }
         case ',': {
-            add_token(lexer, TK_COMMA, NULL);
+            add_token(lexer, TK_COMMA, 1);
             break;
         }
         case ';': {
-            add_token(lexer, TK_SEMICOLON, NULL);
+            add_token(lexer, TK_SEMICOLON, 1);
             break;
         }
         case '[': {
-            add_token(lexer, TK_LEFT_BRACKET, NULL);
+            add_token(lexer, TK_LEFT_BRACKET, 1);
             break;
         }
         case ']': {
-            add_token(lexer, TK_RIGHT_BRACKET, NULL);
+            add_token(lexer, TK_RIGHT_BRACKET, 1);
             break;
         }
         case '(': {
-            add_token(lexer, TK_LEFT_PAREN, NULL);
+            add_token(lexer, TK_LEFT_PAREN, 1);
             break;
         }
         case ')': {
-            add_token(lexer, TK_RIGHT_PAREN, NULL);
+            add_token(lexer, TK_RIGHT_PAREN, 1);
             break;
         }
         case '{': {
-            add_token(lexer, TK_LEFT_BRACE, NULL);
+            add_token(lexer, TK_LEFT_BRACE, 1);
             break;
         }
         case '}': {
-            add_token(lexer, TK_RIGHT_BRACE, NULL);
-            break;
-        }
-        case 'b': {
-            if (!keyword(lexer, "break", 5, TK_BREAK)) {
-                identifier(lexer);
-                break;
-            }
-        }
-        case 'c': {
-            if (!keyword(lexer, "case", 4, TK_CASE)) {
-                if (!keyword(lexer, "char", 4, TK_CHAR)) {
-                    if (!keyword(lexer, "continue", 8, TK_CONTINUE)) {
-                        identifier(lexer);
-                    }
-                }
-            }
-            break;
-        }
-        case 'd': {
-            if (!keyword(lexer, "do", 2, TK_DO)) {
-                if (!keyword(lexer, "double", 6, TK_DOUBLE)) {
-                    if (!keyword(lexer, "default", 7, TK_DEFAULT)) {
-                        identifier(lexer);
-                    }
-                }
-            }
-            break;
-        }
-        case 'e': {
-            if (!keyword(lexer, "else", 4, TK_ELSE)) {
-                if (!keyword(lexer, "enum", 4, TK_ENUM)) {
-                    identifier(lexer);
-                }
-            }
-            break;
-        }
-        case 'f': {
-            if (!keyword(lexer, "for", 3, TK_FOR)) {
-                if (!keyword(lexer, "float", 5, TK_FLOAT)) {
-                    identifier(lexer);
-                }
-            }
-            break;
-        }
-        case 'g': {
-            if (!keyword(lexer, "goto", 4, TK_GOTO)) {
-                identifier(lexer);
-            }
-            break;
-        }
-        case 'i': {
-            if (!keyword(lexer, "if", 2, TK_IF)) {
-                if (!keyword(lexer, "int", 3, TK_INT)) {
-                    identifier(lexer);
-                }
-            }
-            break;
-        }
-        case 'l': {
-            if (!keyword(lexer, "long", 4, TK_LONG)) {
-                identifier(lexer);
-            }
-            break;
-        }
-        case 'r': {
-            if (!keyword(lexer, "return", 6, TK_RETURN)) {
-                identifier(lexer);
-            }
-            break;
-        }
-        case 's': {
-            if (!keyword(lexer, "switch", 6, TK_SWITCH)) {
-                if (!keyword(lexer, "sizeof", 6, TK_SIZEOF)) {
-                    if (!keyword(lexer, "short", 5, TK_SHORT)) {
-                        if (!keyword(lexer, "signed", 6, TK_SIGNED)) {
-                            identifier(lexer);
-                        }
-                    }
-                }
-            }
-            break;
-        }
-        case 'u': {
-            if (!keyword(lexer, "unsigned", 8, TK_UNSIGNED)) {
-                identifier(lexer);
-            }
-            break;
-        }
-        case 'v': {
-            if (!keyword(lexer, "void", 4, TK_VOID)) {
-                identifier(lexer);
-            }
-            break;
-        }
-        case 'w': {
-            if (!keyword(lexer, "while", 5, TK_WHILE)) {
-                identifier(lexer);
-            }
+            add_token(lexer, TK_RIGHT_BRACE, 1);
             break;
         }
         default: {
             if (is_digit(c)) {
                 number(lexer);
             } else if (is_alpha(c)) {
-                identifier(lexer);
+                identifier(lexer); // 标识符或关键字
             } else if (c == '"' || c == '\'') {
                 string(lexer);
             } else {
-                exit(-1);
+                fail("line:%ld, bad character: %c\n", lexer->line, c);
             }
         }
     }
 }
 
 /**
- * @brief 添加 token 到数组中
+ * @brief 添加词素为当前字符起的 count 个字符的 token（运算符、分隔符）
  * @param lexer 词法分析器
  * @param kind token类型
- * @param lexeme 词素
+ * @param count 词素长度
  */
-void add_token(Lexer *lexer, const TokenKind kind, const char *lexeme) {
-    if (lexer->t_size == lexer->t_capacity) {
-        resize(lexer);
-    }
-    lexer->tokens[lexer->t_size++] = (Token){lexer->line, kind, lexeme};
+void add_token(Lexer *lexer, const TokenKind kind, const size_t count) {
+    add_lexeme(lexer, kind, lexer->s_index, count, 0);
 }
 
 /**
- * @brief tokens 数组扩容(重新分配内存)
+ * @brief 添加 token（流式词法分析时覆盖最早的 token）
  * @param lexer 词法分析器
+ * @param kind token类型
+ * @param start 词素在源码中的起始位置
+ * @param count 词素长度
+ * @param value 整数字面量的值
  */
-void resize(Lexer *lexer) {
-    lexer->t_capacity = lexer->t_capacity * 2;
-    Token *tokens = realloc(lexer->tokens, sizeof(Token) * lexer->t_capacity);
-    if (tokens == NULL) {
-        printf("tokens: realloc memory failed");
-        exit(-2);
-    }
-    lexer->tokens = tokens;
+void add_lexeme(Lexer *lexer, const TokenKind kind, const size_t start, const size_t count, const int64_t value) {
+    if (lexer->t_size == lexer->t_capacity && lexer->t_mask == (size_t) -1) {
+        resize(lexer, lexer->t_capacity * 2);
+    }
+    if (lexer->l_size == 0 || lexer->lines[(lexer->l_size - 1) & lexer->l_mask].line != lexer->line) {
+        add_line_run(lexer, lexer->t_size, lexer->line);
+    }
+    const size_t i = lexer->t_size++ & lexer->t_mask;
+    lexer->kinds[i] = (uint8_t) kind;
+    lexer->offsets[i] = (uint32_t) start;
+    lexer->lengths[i] = (uint32_t) count;
+    lexer->values[i] = value;
+    lexer->ids[i] = 0;
 }
 
 /**
- * @brief 判断是否为关键字，如果是则添加一个 token
+ * @brief 添加行号表条目（流式词法分析时覆盖最早的条目）
  * @param lexer 词法分析器
- * @param keyword 关键字
- * @param length 长度
- * @param type token类型
- * @return 1:是关键字 0:不是关键字
+ * @param index 本行首个词法单元的索引
+ * @param line 行号
+ */
+void add_line_run(Lexer *lexer, const size_t index, const size_t line) {
+    if (lexer->l_size == lexer->l_capacity && lexer->l_mask == (size_t) -1) {
+        lexer->l_capacity = lexer->l_capacity * 2;
+        LineRun *lines = realloc(lexer->lines, sizeof(LineRun) * lexer->l_capacity);
+        if (lines == NULL) {
+            fail("lines: realloc memory failed\n");
+        }
+        lexer->lines = lines;
+    }
+    lexer->lines[lexer->l_size++ & lexer->l_mask] = (LineRun){(uint32_t) index, (uint32_t) line};
+}
+
+/**
+ * @brief 查找词法单元所在的行号表条目：先检查上次查找到的条目及其下一条目，否则二分查找
+ * @param lexer 词法分析器（行号表非空）
+ * @param index 词法单元索引
+ * @return 行号表条目的序号（流式词法分析时仅在最近的 l_capacity 个条目中查找）
  */
-int keyword(Lexer *lexer, const char *keyword, const int length, const TokenKind type) {
-    if (memcmp(lexer->source + lexer->s_index, keyword, length) == 0) {
-        const char pc = lexer->source[lexer->s_index + length];
-        if (!is_digit(pc) && !is_alpha(pc)) {
-            add_token(lexer, type, NULL);
-            lexer->s_index += length - 1;
-            return 1;
+size_t find_run(const Lexer *lexer, const size_t index) {
+    const LineRun *lines = lexer->lines;
+    const size_t mask = lexer->l_mask;
+    size_t low = mask != (size_t) -1 && lexer->l_size > lexer->l_capacity ? lexer->l_size - lexer->l_capacity : 0;
+    size_t high = lexer->l_size;
+    for (size_t run = lexer->l_hint; run < lexer->l_hint + 2; ++run) {
+        if (run >= low && run < high && lines[run & mask].index <= index &&
+            (run + 1 == high || lines[(run + 1) & mask].index > index)) {
+            return run;
+        }
+    }
+    // 最后一个起始索引不大于 index 的条目
+    while (high - low > 1) {
+        const size_t mid = low + (high - low) / 2;
+        if (lines[mid & mask].index <= index) {
+            low = mid;
+        } else {
+            high = mid;
         }
     }
-    return 0;
+    return low;
+}
+
+/**
+ * @brief 按源码长度预估词法单元数组的初始容量，通常无需扩容
+ * @param length 源码长度
+ * @return 初始容量（2 的幂）
+ */
+size_t estimate_tokens(const size_t length) {
+    size_t capacity = CAPACITY;
+    while (capacity < length / TOKEN_BYTES) {
+        capacity = capacity * 2;
+    }
+    return capacity;
+}
+
+/**
+ * @brief 初始化词法分析器的源码和扫描状态，词法单元数组和行号表由调用者按需分配
+ * @param lexer 词法分析器
+ * @param source 源码
+ * @param interner 标识符的字符串驻留表
+ */
+void init_state(Lexer *lexer, char *source, Interner *interner) {
+    lexer->s_length = strlen(source);
+    if (lexer->s_length > UINT32_MAX) {
+        fail("source is too large: %ld bytes\n", lexer->s_length);
+    }
+    lexer->s_index = 0;
+    lexer->t_size = 0;
+    lexer->l_size = 0;
+    lexer->l_hint = 0;
+    lexer->line = 1;
+    lexer->source = source;
+    lexer->t_mask = (size_t) -1;
+    lexer->l_mask = (size_t) -1;
+    lexer->scanner = scan_select();
+    lexer->interner = interner;
 }
 
 /**
- * @brief 添加标识符 token
+ * @brief 分配词法单元数组和行号表：各列位于同一内存块（values 为块首），扩容时只需一次分配
+ * @param lexer 词法分析器
+ * @param t_capacity 词法单元数组容量
+ * @param l_capacity 行号表容量
+ */
+void alloc_tokens(Lexer *lexer, const size_t t_capacity, const size_t l_capacity) {
+    lexer->t_capacity = t_capacity;
+    lexer->l_capacity = l_capacity;
+    lexer->values = malloc((sizeof(int64_t) + sizeof(uint32_t) * 3 + 1) * t_capacity);
+    lexer->lines = malloc(sizeof(LineRun) * l_capacity);
+    if (lexer->values == NULL || lexer->lines == NULL) {
+        fail("tokens: malloc memory failed\n");
+    }
+    lexer->offsets = (uint32_t *) (lexer->values + t_capacity);
+    lexer->lengths = lexer->offsets + t_capacity;
+    lexer->ids = lexer->lengths + t_capacity;
+    lexer->kinds = (uint8_t *) (lexer->ids + t_capacity);
+}
+
+/**
+ * @brief 词法单元数组扩容(重新分配内存)
+ * @param lexer 词法分析器
+ * @param capacity 新容量（大于当前容量时才扩容）
+ */
+void resize(Lexer *lexer, const size_t capacity) {
+    if (capacity <= lexer->t_capacity) {
+        return;
+    }
+    const Lexer old = *lexer;
+    alloc_tokens(lexer, capacity, old.l_capacity);
+    free(lexer->lines);
+    lexer->lines = old.lines;
+    memcpy(lexer->values, old.values, sizeof(int64_t) * old.t_size);
+    memcpy(lexer->offsets, old.offsets, sizeof(uint32_t) * old.t_size);
+    memcpy(lexer->lengths, old.lengths, sizeof(uint32_t) * old.t_size);
+    memcpy(lexer->ids, old.ids, sizeof(uint32_t) * old.t_size);
+    memcpy(lexer->kinds, old.kinds, old.t_size);
+    free(old.values);
+}
+
+/**
+ * @brief 添加标识符 token：扫描完成后再判断是否为关键字，不是关键字时驻留并记录编号
  * @param lexer 词法分析器
  */
 void identifier(Lexer *lexer) {
-    const size_t start = lexer->s_index, length = lexer->s_length;
-    while (lexer->s_index < length) {
-        const char pc = lexer->source[lexer->s_index];
-        if (is_alpha(pc) || is_digit(pc)) {
-            ++lexer->s_index;
-        } else {
-            --lexer->s_index;
+    const size_t start = lexer->s_index;
+    size_t end = start + 1;
+    while (end < start + IDENT_SHORT && end < lexer->s_length && (is_alpha(lexer->source[end]) || is_digit(lexer->source[end]))) {
+        ++end; // 短标识符逐字节扫描
+    }
+    if (end == start + IDENT_SHORT) {
+        end = lexer->scanner->ident(lexer->source, end, lexer->s_length);
+    }
+    lexer->s_index = end - 1;
+    const size_t count = end - start;
+    const char *chars = lexer->source + start;
+    const TokenKind kind = classify(chars, count);
+    add_lexeme(lexer, kind, start, count, 0);
+    if (kind == TK_ID) {
+        lexer->ids[(lexer->t_size - 1) & lexer->t_mask] = intern_id(lexer->interner, chars, count, hash_chars(chars, count));
+    }
+}
+
+/**
+ * @brief 判断标识符是否为关键字：按长度和首字母（必要时加上第 2、3 个字母）确定唯一的候选关键字，再比较一次
+ * @param chars 标识符
+ * @param length 长度
+ * @return 关键字的 token 类型；不是关键字时返回 TK_ID
+ */
+TokenKind classify(const char *chars, const size_t length) {
+    const char *word = NULL;
+    TokenKind kind = TK_ID;
+    switch (length) {
+        case 2:
+            if (chars[0] == 'd') {
+                word = "do";
+                kind = TK_DO;
+            } else if (chars[0] == 'i') {
+                word = "if";
+                kind = TK_IF;
+            }
+            break;
+        case 3:
+            if (chars[0] == 'f') {
+                word = "for";
+                kind = TK_FOR;
+            } else if (chars[0] == 'i') {
+                word = "int";
+                kind = TK_INT;
+            }
+            break;
+        case 4:
+            switch (chars[0]) {
+                case 'c':
+                    if (chars[1] == 'a') {
+                        word = "case";
+                        kind = TK_CASE;
+                    } else {
+                        word = "char";
+                        kind = TK_CHAR;
+                    }
+                    break;
+                case 'e':
+                    if (chars[1] == 'l') {
+                        word = "else";
+                        kind = TK_ELSE;
+                    } else {
+                        word = "enum";
+                        kind = TK_ENUM;
+                    }
+                    break;
+                case 'g':
+                    word = "goto";
+                    kind = TK_GOTO;
+                    break;
+                case 'l':
+                    word = "long";
+                    kind = TK_LONG;
+                    break;
+                case 'v':
+                    word = "void";
+                    kind = TK_VOID;
+                    break;
+                default:
+                    break;
+            }
+            break;
+        case 5:
+            switch (chars[0]) {
+                case 'b':
+                    word = "break";
+                    kind = TK_BREAK;
+                    break;
+                case 'f':
+                    word = "float";
+                    kind = TK_FLOAT;
+                    break;
+                case 's':
+                    word = "short";
+                    kind = TK_SHORT;
+                    break;
+                case 'w':
+                    word = "while";
+                    kind = TK_WHILE;
+                    break;
+                default:
+                    break;
+            }
+            break;
+        case 6:
+            switch (chars[0]) {
+                case 'd':
+                    word = "double";
+                    kind = TK_DOUBLE;
+                    break;
+                case 'e':
+                    word = "extern";
+                    kind = TK_EXTERN;
+                    break;
+                case 'r':
+                    word = "return";
+                    kind = TK_RETURN;
+                    break;
+                case 's':
+                    if (chars[1] == 'w') {
+                        word = "switch";
+                        kind = TK_SWITCH;
+                    } else if (chars[2] == 'g') {
+                        word = "signed";
+                        kind = TK_SIGNED;
+                    } else {
+                        word = "sizeof";
+                        kind = TK_SIZEOF;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            break;
+        case 7:
+            word = "default";
+            kind = TK_DEFAULT;
+            break;
+        case 8:
+            if (chars[0] == 'c') {
+                word = "continue";
+                kind = TK_CONTINUE;
+            } else if (chars[0] == 'u') {
+                word = "unsigned";
+                kind = TK_UNSIGNED;
+            }
+            break;
+        default:
             break;
-        }
     }
-    const char *lexeme = substr(lexer->source, start, lexer->s_index + 1 - start);
-    add_token(lexer, TK_ID, lexeme);
+    return word != NULL && memcmp(chars, word, length) == 0 ? kind : TK_ID;
 }
 
 /**
- * @brief 添加数值型 token
+ * @brief 添加数值型 token，并解析其值（语法分析时无需再解析）
  * @param lexer 词法分析器
  */
 void number(Lexer *lexer) {
     const size_t start = lexer->s_index;
-    int dot = 0, invalid = 0, radix = 10;
+    int radix = 10;
     if (lexer->s_length - lexer->s_index > 2) {
         const char first = lexer->source[lexer->s_index];
         const char second = lexer->source[lexer->s_index + 1];
@@ -458,9 +848,6 @@ void number(Lexer *lexer) {
         const char c = lexer->source[lexer->s_index];
         if (radix == 10) {
             if (is_digit(c) || c == '.') {
-                if (c == '.') {
-                    dot++;
-                }
                 ++lexer->s_index;
                 continue;
             }
@@ -475,16 +862,13 @@ void number(Lexer *lexer) {
     }
 
     const size_t count = lexer->s_index + 1 - start;
-    if (dot > 1 || (count <= 1 && dot == 1)) {
-        invalid = 1;
-    }
-
-    char *lexeme = substr(lexer->source, start, count);
-    if (invalid) {
-        printf("line:%ld, Invalid number: %s", lexer->line, lexeme);
-        exit(-1);
+    char *end;
+    const int64_t value = strtoll(lexer->source + start, &end, 0);
+    if (end != lexer->source + start + count) {
+        // 仅支持整数（含小数点的数值、非法的八进制数均无法完整解析）
+        fail("line:%ld, Invalid number: %.*s\n", lexer->line, (int) count, lexer->source + start);
     }
-    add_token(lexer, TK_NUMBER, lexeme);
+    add_lexeme(lexer, TK_NUMBER, start, count, value);
 }
 
 /**
@@ -492,18 +876,9 @@ void number(Lexer *lexer) {
  * @param lexer 词法分析器
  */
 void string(Lexer *lexer) {
-    ++lexer->s_index; // 跳过引号
-    const size_t start = lexer->s_index, length = lexer->s_length;
-    while (lexer->s_index < length) {
-        const char pc = lexer->source[lexer->s_index];
-        if (pc == '"' || pc == '\'') {
-            break;
-        }
-        ++lexer->s_index;
-    }
-    const size_t count = lexer->s_index - start;
-    const char *lexeme = substr(lexer->source, start, count);
-    add_token(lexer, TK_STRING, lexeme);
+    const size_t start = lexer->s_index + 1; // 跳过引号
+    lexer->s_index = lexer->scanner->quote(lexer->source, start, lexer->s_length);
+    add_lexeme(lexer, TK_STRING, start, lexer->s_index - start, 0);
 }
 
 /**
@@ -523,21 +898,3 @@ int is_digit(const char c) {
 int is_alpha(const char c) {
     return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
 }
-
-/**
- * @brief 截取子串
- * @param source 源字符串
- * @param start 起始位置
- * @param count 长度
- * @return 子串
- */
-char *substr(const char *source, const size_t start, const size_t count) {
-    char *lexeme = malloc(count + 1);
-    if (lexeme == NULL) {
-        printf("lexeme: malloc memory failed");
-        exit(-2);
-    }
-    strncpy(lexeme, source + start, count);
-    lexeme[count] = '\0';
-    return lexeme;
-}
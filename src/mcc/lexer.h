@@ -6,6 +6,10 @@
 #define MCC_LEXER_H
 
 #include <stddef.h>
+#include <stdint.h>
+
+#include "intern.h"
+#include "scan.h"
 
 // token 类型
 typedef enum {
@@ -30,6 +34,7 @@ typedef enum {
     TK_UNSIGNED, // unsigned（不支持）
     TK_VOID, // void
     TK_ENUM, // enum
+    TK_EXTERN, // extern（声明原生函数，同函数原型）
 
     // control
     TK_BREAK, // break（不支持）
@@ -86,34 +91,63 @@ typedef enum {
     TK_RIGHT_BRACKET, // ]
 } TokenKind;
 
-// 词法单元
+// 行号表条目：从第 index 个词法单元开始位于第 line 行（仅记录每行的首个词法单元）
 typedef struct {
-    size_t line; // 所在行号
-    TokenKind kind; // token 类型
-    const char *lexeme; // token 词素
-} Token;
+    uint32_t index; // 本行首个词法单元的索引
+    uint32_t line; // 行号
+} LineRun;
 
-// 词法分析器
+// 词法分析器：词法单元按列存储（类型、源码位置、字面量的值分别为一个数组），词素不复制，直接引用源码；
+// 标识符在扫描时驻留，语法分析时经编号直接取得符号名
 typedef struct {
-    char *source; // 源文件文本
+    char *source; // 源文件文本（词法单元的词素位于其中，由调用者释放）
     size_t s_length; // 源码长度
     size_t s_index; // 读取字符的索引下标
     size_t line; // 当前行号
-    Token *tokens; // Token 序列
-    size_t t_capacity; // tokens 数组容量
-    size_t t_size; // tokens 数组已写入数量
+    uint8_t *kinds; // 词法单元类型（TokenKind）
+    uint32_t *offsets; // 词素在源码中的起始位置
+    uint32_t *lengths; // 词素长度（字符串不含引号）
+    int64_t *values; // 整数字面量的值（扫描时解析，其它词法单元为 0）
+    uint32_t *ids; // 标识符在驻留表中的编号（扫描时驻留，其它词法单元为 0）
+    size_t t_capacity; // 词法单元数组容量
+    size_t t_size; // 词法单元数量（流式词法分析时为已生成的词法单元总数）
+    size_t t_mask; // 下标掩码：第 i 个词法单元位于各数组的 [i & t_mask]（流式词法分析时为容量 - 1，否则为全 1）
+    LineRun *lines; // 行号表（按行压缩）
+    size_t l_capacity; // 行号表容量
+    size_t l_size; // 行号表条目数量（流式词法分析时为已生成的条目总数）
+    size_t l_mask; // 行号表下标掩码（同 t_mask）
+    size_t l_hint; // 上次查找到的行号表条目（顺序访问时无需二分查找）
+    const Scanner *scanner; // 字符扫描实现（按 CPU 支持的指令集选择 SIMD 或逐字节）
+    Interner *interner; // 字符串驻留表（由调用者释放，语法分析器初始化时接管）
 } Lexer;
 
 /**
  * @brief 初始化 lexer
  * @param lexer 词法分析器
+ * @param source 源文件文本（长度不超过 4GB）
+ * @param interner 字符串驻留表（已初始化）
+ */
+void lexer_init(Lexer *lexer, char *source, Interner *interner);
+
+/**
+ * @brief 初始化流式词法分析器：按需逐个生成词法单元，仅保留最近的若干个
+ * @param lexer 词法分析器
  * @param source 源文件文本
+ * @param capacity 环形缓冲区容量（2 的幂），即可同时访问的词法单元数量
+ * @param interner 字符串驻留表（已初始化）
  */
-void lexer_init(Lexer *lexer, char *source);
+void lexer_init_stream(Lexer *lexer, char *source, size_t capacity, Interner *interner);
+
+/**
+ * @brief 流式词法分析：扫描并生成下一个词法单元
+ * @param lexer 词法分析器
+ * @return 1:生成了词法单元 0:已到源码末尾
+ */
+int lexer_next(Lexer *lexer);
 
 /**
  * @brief 释放 lexer 持有的内存资源
- * @details 释放：源文件文本；不释放：词法单元序列（语法分析器运行时必需）
+ * @details 释放：词法单元数组，行号表；不释放：源文件文本，字符串驻留表
  * @param lexer 词法分析器
  */
 void lexer_free(Lexer *lexer);
@@ -124,4 +158,34 @@ void lexer_free(Lexer *lexer);
  */
 void lexer_analyse(Lexer *lexer);
 
+/**
+ * @brief 并行扫描源文件并生成词法单元序列
+ * @details 在不处于字符串、注释中的换行处将源码切分为若干块，多个线程各自扫描一块，
+ * 最后按顺序拼接，结果与 lexer_analyse 完全相同；源码较小时直接顺序扫描
+ * @param lexer 词法分析器
+ * @param jobs 线程数（0 表示按 CPU 核数）
+ */
+void lexer_analyse_parallel(Lexer *lexer, size_t jobs);
+
+/**
+ * @brief 查找词法单元所在行号
+ * @details 顺序访问时直接使用上次查找到的行号表条目，否则二分查找；超出末尾时为最后一个词法单元的行号
+ * @param lexer 词法分析器
+ * @param index 词法单元索引
+ * @return 行号
+ */
+size_t lexer_line(Lexer *lexer, size_t index);
+
+/**
+ * @brief 追加另一词法分析器的词法单元 [from, to)，行号和源码位置分别平移
+ * @details 两者的驻留表不同时，标识符驻留到 lexer 的驻留表并换用其编号
+ * @param lexer 词法分析器（非流式）
+ * @param other 词法单元来源（非流式）
+ * @param from 起始索引
+ * @param to 结束索引
+ * @param l_delta 行号平移量
+ * @param s_delta 源码位置平移量
+ */
+void lexer_append(Lexer *lexer, Lexer *other, size_t from, size_t to, long l_delta, long s_delta);
+
 #endif //MCC_LEXER_H
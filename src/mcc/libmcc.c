@@ -0,0 +1,341 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "libmcc.h"
+#include "parser.h"
+#include "link.h"
+#include "vm.h"
+#include "source.h"
+#include "scheduler.h"
+#include "fail.h"
+
+// 函数表条目
+typedef struct {
+    const char *name; // 函数名（驻留于编译结果的驻留表）
+    size_t offset; // 函数入口在代码段中的偏移（以 int64_t 为单位）
+    int params; // 参数个数
+} MccFunction;
+
+struct MccProgram {
+    int64_t *text; // 代码段（从 o_text[0] 开始）
+    size_t t_words; // 代码段大小（以 int64_t 为单位）
+    int64_t t_base; // 编译时代码段的地址（重定位时计算偏移）
+    char *data; // 数据段：字符串常量（全局变量初始值为 0）
+    size_t d_size; // 数据段大小（字节）
+    int64_t d_base; // 编译时数据段的地址
+    Reloc *relocs; // 重定位表：代码段中保存绝对地址的位置
+    size_t r_size; // 重定位表：条目数量
+    MccFunction *functions; // 函数表（已定义的函数）
+    size_t f_size; // 函数表：函数数量
+    Interner names; // 函数名驻留表
+    SymbolTable table; // 函数名 -> 函数表中的索引
+};
+
+struct MccVM {
+    VM vm; // 虚拟机
+    Arena t_arena; // 代码段（编译结果的副本，已重定位）
+    Arena d_arena; // 数据段（编译结果的副本，全局变量为此虚拟机私有）
+    const MccProgram *program; // 编译结果
+    MccDone done; // 由调度器运行时：运行结束的回调
+    void *d_ctx; // 回调的上下文
+};
+
+struct MccScheduler {
+    Scheduler sched; // 调度器
+};
+
+// 设置错误信息，返回错误码
+int mcc_error(MccError *error, int code, const char *format, ...);
+
+// 查找函数并检查参数个数
+int mcc_entry(const MccVM *vm, const char *name, int argc, int64_t **entry, MccError *error);
+
+// 调度器中的虚拟机运行结束：转换为 MccDone 回调
+void mcc_done(void *ctx, VM *vm, int64_t result, const char *error);
+
+// 从语法分析器复制编译结果
+void mcc_load(MccProgram *program, const Parser *parser);
+
+// 释放语法分析器
+void mcc_parser_free(Parser *parser);
+
+MccProgram *mcc_compile(const char *source, MccError *error) {
+    char *text = source_copy(source, strlen(source));
+    Parser *parser = calloc(1, sizeof(Parser));
+    MccProgram *program = calloc(1, sizeof(MccProgram));
+    if (text == NULL || parser == NULL || program == NULL) {
+        source_free(text);
+        free(parser);
+        free(program);
+        mcc_error(error, MCC_ENOMEM, "compile: malloc memory failed");
+        return NULL;
+    }
+    FailPoint point;
+    FailPoint *outer = fail_catch(&point);
+    if (setjmp(point.jump) != 0) {
+        // 编译错误：释放已分配的资源（语法分析器已清零，未分配的字段为 NULL）
+        fail_restore(outer);
+        mcc_parser_free(parser);
+        mcc_program_free(program);
+        mcc_error(error, MCC_ECOMPILE, "%s", point.message);
+        return NULL;
+    }
+    parser_init_stream(parser, text, 0);
+    parser_parse(parser);
+    link_units(parser, 1, parser); // 填入仅有声明的函数的入口地址
+    mcc_load(program, parser);
+    fail_restore(outer);
+    mcc_parser_free(parser);
+    mcc_error(error, MCC_OK, "");
+    return program;
+}
+
+void mcc_program_free(MccProgram *program) {
+    if (program == NULL) {
+        return;
+    }
+    free(program->text);
+    free(program->data);
+    free(program->relocs);
+    free(program->functions);
+    intern_free(&program->names);
+    symtab_free(&program->table);
+    free(program);
+}
+
+MccVM *mcc_vm_create(const MccProgram *program, MccError *error) {
+    MccVM *vm = calloc(1, sizeof(MccVM));
+    if (vm == NULL) {
+        mcc_error(error, MCC_ENOMEM, "vm: malloc memory failed");
+        return NULL;
+    }
+    vm->program = program;
+    const size_t t_size = program->t_words * sizeof(int64_t);
+    const size_t d_size = program->d_size > 0 ? program->d_size : 1;
+    FailPoint point;
+    FailPoint *outer = fail_catch(&point);
+    if (setjmp(point.jump) != 0) {
+        fail_restore(outer);
+        mcc_vm_free(vm);
+        mcc_error(error, MCC_ENOMEM, "%s", point.message);
+        return NULL;
+    }
+    // 内存区按需保留，容量与编译结果相同（对齐到内存块）
+    if (arena_init(&vm->t_arena, (t_size + ARENA_CHUNK - 1) / ARENA_CHUNK * ARENA_CHUNK) != 0 ||
+        arena_init(&vm->d_arena, (d_size + ARENA_CHUNK - 1) / ARENA_CHUNK * ARENA_CHUNK) != 0 ||
+        arena_commit(&vm->t_arena, t_size) != 0 || arena_commit(&vm->d_arena, d_size) != 0) {
+        fail("vm: mmap memory failed\n");
+    }
+    vm_setup(&vm->vm, &vm->t_arena, &vm->d_arena, 0);
+    vm->vm.quiet = 1;
+    vm_segments(&vm->vm, vm->t_arena.base, vm->t_arena.capacity, vm->d_arena.base, vm->d_arena.capacity);
+    fail_restore(outer);
+
+    // 复制代码段和数据段，代码段中的绝对地址改为此虚拟机的地址
+    int64_t *text = (int64_t *) vm->t_arena.base;
+    memcpy(text, program->text, t_size);
+    memcpy(vm->d_arena.base, program->data, program->d_size);
+    const int64_t t_delta = (int64_t) text - program->t_base;
+    const int64_t d_delta = (int64_t) vm->d_arena.base - program->d_base;
+    for (size_t i = 0; i < program->r_size; ++i) {
+        text[program->relocs[i].offset] += program->relocs[i].kind == RELOC_TEXT ? t_delta : d_delta;
+    }
+    mcc_error(error, MCC_OK, "");
+    return vm;
+}
+
+int mcc_call(MccVM *vm, const char *name, const int64_t *args, const int argc, int64_t *result, MccError *error) {
+    int64_t *entry;
+    const int code = mcc_entry(vm, name, argc, &entry, error);
+    if (code != MCC_OK) {
+        return code;
+    }
+    FailPoint point;
+    FailPoint *outer = fail_catch(&point);
+    if (setjmp(point.jump) != 0) {
+        fail_restore(outer);
+        return mcc_error(error, MCC_ERUNTIME, "%s", point.message);
+    }
+    vm_enter(&vm->vm, entry, args, argc);
+    const int64_t value = vm_run(&vm->vm);
+    fail_restore(outer);
+    if (result != NULL) {
+        *result = value;
+    }
+    return mcc_error(error, MCC_OK, "");
+}
+
+void mcc_vm_free(MccVM *vm) {
+    if (vm == NULL || vm->vm.threads > 0) {
+        return; // 仍有未 join 的线程：不释放（线程可能仍在访问），由进程退出时回收
+    }
+    vm_free(&vm->vm); // 同时释放代码段和数据段
+    arena_free(&vm->t_arena);
+    arena_free(&vm->d_arena);
+    free(vm);
+}
+
+MccScheduler *mcc_scheduler_create(const int workers, const int64_t budget, MccError *error) {
+    MccScheduler *sched = calloc(1, sizeof(MccScheduler));
+    if (sched == NULL) {
+        mcc_error(error, MCC_ENOMEM, "scheduler: malloc memory failed");
+        return NULL;
+    }
+    FailPoint point;
+    FailPoint *outer = fail_catch(&point);
+    if (setjmp(point.jump) != 0) {
+        fail_restore(outer);
+        free(sched); // 已创建的部分工作线程及运行队列无法回收
+        mcc_error(error, MCC_ENOMEM, "%s", point.message);
+        return NULL;
+    }
+    sched_init(&sched->sched, workers > 0 ? (size_t) workers : 0, budget);
+    fail_restore(outer);
+    mcc_error(error, MCC_OK, "");
+    return sched;
+}
+
+int mcc_spawn(MccScheduler *sched, MccVM *vm, const char *name, const int64_t *args, const int argc,
+              const MccDone done, void *ctx, MccError *error) {
+    int64_t *entry;
+    const int code = mcc_entry(vm, name, argc, &entry, error);
+    if (code != MCC_OK) {
+        return code;
+    }
+    FailPoint point;
+    FailPoint *outer = fail_catch(&point);
+    if (setjmp(point.jump) != 0) {
+        fail_restore(outer);
+        return mcc_error(error, MCC_ENOMEM, "%s", point.message);
+    }
+    vm->done = done;
+    vm->d_ctx = ctx;
+    vm_enter(&vm->vm, entry, args, argc);
+    sched_spawn(&sched->sched, &vm->vm, mcc_done, vm);
+    fail_restore(outer);
+    return mcc_error(error, MCC_OK, "");
+}
+
+void mcc_scheduler_wait(MccScheduler *sched) {
+    sched_wait(&sched->sched);
+}
+
+void mcc_scheduler_free(MccScheduler *sched) {
+    if (sched == NULL) {
+        return;
+    }
+    sched_free(&sched->sched);
+    free(sched);
+}
+
+/**
+ * @brief 查找函数并检查参数个数
+ * @param vm 虚拟机
+ * @param name 函数名
+ * @param argc 参数个数
+ * @param entry 函数入口（此虚拟机代码段中的地址）
+ * @param error 错误信息（可为 NULL）
+ * @return 错误码（MCC_OK 表示找到）
+ */
+int mcc_entry(const MccVM *vm, const char *name, const int argc, int64_t **entry, MccError *error) {
+    const MccProgram *program = vm->program;
+    const int64_t index = symtab_find(&program->table, name, hash_string(name));
+    if (index == SYMTAB_NONE) {
+        return mcc_error(error, MCC_ENOFUNC, "undefined function %s", name);
+    }
+    const MccFunction *fn = program->functions + index;
+    if (argc != fn->params) {
+        return mcc_error(error, MCC_EARGS, "%s expects %d arguments, but got %d", name, fn->params, argc);
+    }
+    *entry = (int64_t *) vm->t_arena.base + fn->offset;
+    return MCC_OK;
+}
+
+/**
+ * @brief 调度器中的虚拟机运行结束：转换为 MccDone 回调
+ * @param ctx 虚拟机（MccVM）
+ * @param vm 虚拟机（MccVM 中的 VM）
+ * @param result 函数返回值
+ * @param error 错误信息（NULL 表示正常结束）
+ */
+void mcc_done(void *ctx, VM *vm, const int64_t result, const char *error) {
+    (void) vm;
+    MccVM *mvm = ctx;
+    MccError status;
+    if (error == NULL) {
+        mcc_error(&status, MCC_OK, "");
+    } else {
+        mcc_error(&status, MCC_ERUNTIME, "%s", error);
+    }
+    mvm->done(mvm->d_ctx, mvm, result, &status);
+}
+
+/**
+ * @brief 设置错误信息
+ * @param error 错误信息（可为 NULL）
+ * @param code 错误码
+ * @param format 格式字符串（同 printf）
+ * @return 错误码
+ */
+int mcc_error(MccError *error, const int code, const char *format, ...) {
+    if (error != NULL) {
+        va_list args;
+        va_start(args, format);
+        error->code = code;
+        vsnprintf(error->message, MCC_ERROR_SIZE, format, args);
+        va_end(args);
+    }
+    return code;
+}
+
+/**
+ * @brief 从语法分析器复制编译结果：代码段、数据段、重定位表及已定义的函数
+ * @param program 编译结果
+ * @param parser 语法分析器（已完成语法分析和链接）
+ */
+void mcc_load(MccProgram *program, const Parser *parser) {
+    program->t_words = parser->text - parser->o_text + 1; // 代码段从 o_text[0] 开始计算偏移
+    program->d_size = parser->data - parser->o_data;
+    program->t_base = (int64_t) parser->o_text;
+    program->d_base = (int64_t) parser->o_data;
+    program->r_size = parser->r_size;
+    program->text = malloc(sizeof(int64_t) * program->t_words);
+    program->data = malloc(program->d_size > 0 ? program->d_size : 1);
+    program->relocs = malloc(sizeof(Reloc) * (program->r_size > 0 ? program->r_size : 1));
+    program->functions = malloc(sizeof(MccFunction) * (parser->f_size > 0 ? parser->f_size : 1));
+    if (program->text == NULL || program->data == NULL || program->relocs == NULL || program->functions == NULL) {
+        fail("compile: malloc memory failed\n");
+    }
+    memcpy(program->text, parser->o_text, sizeof(int64_t) * program->t_words);
+    memcpy(program->data, parser->o_data, program->d_size);
+    memcpy(program->relocs, parser->relocs, sizeof(Reloc) * program->r_size);
+
+    intern_init(&program->names);
+    symtab_init(&program->table, 64);
+    for (size_t i = 0; i < parser->f_size; ++i) {
+        const Function *fn = parser->functions + i;
+        const char *name = parser->g_symbols[fn->symbol].name;
+        const int hash = intern_hash(name);
+        name = intern(&program->names, name, strlen(name), hash);
+        program->functions[program->f_size] = (MccFunction){name, fn->entry - parser->o_text, fn->params};
+        symtab_put(&program->table, name, hash, (uint32_t) program->f_size++);
+    }
+}
+
+/**
+ * @brief 释放语法分析器（含代码段和数据段：编译结果已复制）
+ * @param parser 语法分析器
+ */
+void mcc_parser_free(Parser *parser) {
+    parser_free(parser);
+    parser_free_tables(parser);
+    arena_free(&parser->t_arena);
+    arena_free(&parser->d_arena);
+    free(parser);
+}
@@ -0,0 +1,126 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_LIBMCC_H
+#define MCC_LIBMCC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define MCC_ERROR_SIZE 256 // 错误信息的最大长度（含结尾的 0）
+
+// 错误码
+enum {
+    MCC_OK, // 成功
+    MCC_ECOMPILE, // 编译错误（词法分析、语法分析、链接）
+    MCC_ENOFUNC, // 函数未定义
+    MCC_EARGS, // 参数个数与函数定义不符
+    MCC_ERUNTIME, // 运行错误（未知指令、未知系统调用等）
+    MCC_ENOMEM // 内存不足
+};
+
+// 错误信息
+typedef struct {
+    int code; // 错误码（MCC_OK 表示成功）
+    char message[MCC_ERROR_SIZE]; // 错误信息
+} MccError;
+
+// 编译结果：代码段、数据段、重定位表及函数表；编译后只读，可由多个虚拟机（可位于不同线程）同时共享
+typedef struct MccProgram MccProgram;
+
+// 虚拟机实例：私有的代码段、数据段（全局变量）、栈和堆；同一时刻只能由一个线程使用
+typedef struct MccVM MccVM;
+
+/**
+ * @brief 编译源码
+ * @details 不打印信息，不退出进程；错误通过返回值及 error 报告。可在多个线程中同时调用
+ * @param source 源码（以 0 结尾）
+ * @param error 错误信息（可为 NULL）
+ * @return 编译结果；失败时返回 NULL
+ */
+MccProgram *mcc_compile(const char *source, MccError *error);
+
+/**
+ * @brief 释放编译结果（须在由其创建的虚拟机全部释放之后）
+ * @param program 编译结果
+ */
+void mcc_program_free(MccProgram *program);
+
+/**
+ * @brief 创建虚拟机：复制编译结果的代码段、数据段并重定位，分配栈和堆
+ * @details 编译结果只读，多个线程可同时基于同一编译结果创建虚拟机
+ * @param program 编译结果
+ * @param error 错误信息（可为 NULL）
+ * @return 虚拟机；失败时返回 NULL
+ */
+MccVM *mcc_vm_create(const MccProgram *program, MccError *error);
+
+/**
+ * @brief 调用函数，运行至函数返回（或执行 exit）
+ * @details 全局变量及堆在多次调用之间保留
+ * @param vm 虚拟机
+ * @param name 函数名
+ * @param args 参数（按声明顺序）
+ * @param argc 参数个数（须与函数定义一致）
+ * @param result 函数返回值（可为 NULL）
+ * @param error 错误信息（可为 NULL）
+ * @return 错误码（MCC_OK 表示成功）
+ */
+int mcc_call(MccVM *vm, const char *name, const int64_t *args, int argc, int64_t *result, MccError *error);
+
+/**
+ * @brief 释放虚拟机
+ * @param vm 虚拟机
+ */
+void mcc_vm_free(MccVM *vm);
+
+// 调度器：将大量虚拟机复用到少量工作线程上，每运行一个时间片（指令数）即切换，READ 无数据时让出而不阻塞工作线程
+typedef struct MccScheduler MccScheduler;
+
+/**
+ * 虚拟机运行结束时的回调（在调度器的工作线程中调用）
+ * @param ctx mcc_spawn 传入的上下文
+ * @param vm 虚拟机（回调返回后可再次提交或释放）
+ * @param result 函数返回值
+ * @param error 错误信息（code 为 MCC_OK 表示正常结束）
+ */
+typedef void (*MccDone)(void *ctx, MccVM *vm, int64_t result, const MccError *error);
+
+/**
+ * @brief 创建调度器，启动工作线程
+ * @param workers 工作线程数量（0 表示按 CPU 核数）
+ * @param budget 时间片：每次运行的指令数（0 表示默认值 10000），死循环的脚本也只占用一个时间片
+ * @param error 错误信息（可为 NULL）
+ * @return 调度器；失败时返回 NULL
+ */
+MccScheduler *mcc_scheduler_create(int workers, int64_t budget, MccError *error);
+
+/**
+ * @brief 提交函数调用：在调度器中运行，结束时调用 done；运行结束前虚拟机不可另作他用
+ * @param sched 调度器
+ * @param vm 虚拟机
+ * @param name 函数名
+ * @param args 参数（按声明顺序）
+ * @param argc 参数个数（须与函数定义一致）
+ * @param done 运行结束时的回调
+ * @param ctx 回调的上下文
+ * @param error 错误信息（可为 NULL）
+ * @return 错误码（MCC_OK 表示已提交）
+ */
+int mcc_spawn(MccScheduler *sched, MccVM *vm, const char *name, const int64_t *args, int argc,
+              MccDone done, void *ctx, MccError *error);
+
+/**
+ * @brief 等待所有已提交的函数调用运行结束
+ * @param sched 调度器
+ */
+void mcc_scheduler_wait(MccScheduler *sched);
+
+/**
+ * @brief 停止工作线程并释放调度器（尚未结束的调用不再运行，也不调用回调）
+ * @param sched 调度器
+ */
+void mcc_scheduler_free(MccScheduler *sched);
+
+#endif //MCC_LIBMCC_H
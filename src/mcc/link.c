@@ -0,0 +1,215 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "link.h"
+#include "fail.h"
+
+// 全局变量的地址映射：编译单元中的地址 -> 链接后的地址（同名全局变量映射到首个定义）
+typedef struct {
+    int64_t addr; // 编译单元中的地址
+    int64_t target; // 链接后的地址
+} GlobalMap;
+
+// 从合并后的全局符号表中查找符号
+Symbol *find_linked(Symbol *symbols, const SymbolTable *table, const char *name, int hash);
+
+// 二分查找全局变量的地址映射
+const GlobalMap *find_global(const GlobalMap *maps, size_t size, int64_t addr);
+
+/**
+ * @brief 链接：将多个编译单元合并为一个程序
+ * @param units 编译单元
+ * @param count 编译单元数量
+ * @param out 链接结果
+ */
+void link_units(Parser *units, const size_t count, Parser *out) {
+    const int in_place = count == 1 && out == units;
+
+    // 1. 布局：编译单元 i 的代码段 [1, n] 位于链接结果的 [t_bases[i], t_bases[i] + n)，数据段位于 d_bases[i]（8 字节对齐）
+    size_t *t_bases = malloc(sizeof(size_t) * count);
+    size_t *d_bases = malloc(sizeof(size_t) * count);
+    if (t_bases == NULL || d_bases == NULL) {
+        fail("link: malloc memory failed\n");
+    }
+    size_t t_size = 1, d_size = 0, r_size = 0, ln_size = 0, g_size = 0;
+    for (size_t i = 0; i < count; ++i) {
+        t_bases[i] = t_size;
+        d_bases[i] = d_size;
+        t_size += units[i].text - units[i].o_text;
+        d_size += (units[i].data - units[i].o_data + 7) & ~(size_t) 7;
+        r_size += units[i].r_size;
+        ln_size += units[i].ln_size;
+        g_size += units[i].g_size;
+    }
+    if (!in_place) {
+        memset(out, 0, sizeof(Parser));
+        if (arena_init(&out->t_arena, SEGMENT_CAPACITY) != 0 || arena_init(&out->d_arena, SEGMENT_CAPACITY) != 0) {
+            fail("link: mmap memory failed\n");
+        }
+        if (arena_commit(&out->t_arena, (t_size + 2) * sizeof(int64_t)) != 0 ||
+            arena_commit(&out->d_arena, d_size) != 0) {
+            fail("link: program is too large\n");
+        }
+        out->o_text = (int64_t *) out->t_arena.base;
+        out->o_data = out->d_arena.base;
+        out->relocs = malloc(sizeof(Reloc) * (r_size > 0 ? r_size : 1));
+        out->lines = malloc(sizeof(LineInfo) * (ln_size > 0 ? ln_size : 1));
+        if (out->relocs == NULL || out->lines == NULL) {
+            fail("link: malloc memory failed\n");
+        }
+        out->text = out->o_text + t_size - 1;
+        out->l_text = out->text;
+        out->data = out->o_data + d_size;
+        out->r_capacity = r_size > 0 ? r_size : 1;
+        out->ln_capacity = ln_size > 0 ? ln_size : 1;
+    }
+
+    // 2. 合并全局符号表：已定义的函数（不允许重复定义），全局变量（同名视为同一变量）
+    Symbol *symbols = malloc(sizeof(Symbol) * (g_size > 0 ? g_size : 1));
+    GlobalMap *maps = malloc(sizeof(GlobalMap) * (g_size > 0 ? g_size : 1));
+    size_t *m_bases = malloc(sizeof(size_t) * (count + 1));
+    if (symbols == NULL || maps == NULL || m_bases == NULL) {
+        fail("link: malloc memory failed\n");
+    }
+    SymbolTable funcs, globals; // 合并后的全局符号表的索引：函数和全局变量分别查找
+    symtab_init(&funcs, 256);
+    symtab_init(&globals, 256);
+    size_t s_size = 0, m_size = 0;
+    // 链接错误：先释放临时内存再报告（嵌入使用时错误作为返回值，进程不退出）
+    const char *duplicate = NULL, *undefined = NULL;
+    for (size_t i = 0; i < count && duplicate == NULL; ++i) {
+        const Parser *unit = units + i;
+        const int64_t t_delta = (int64_t) (out->o_text + t_bases[i] - 1) - (int64_t) unit->o_text;
+        const int64_t d_delta = (int64_t) (out->o_data + d_bases[i]) - (int64_t) unit->o_data;
+        m_bases[i] = m_size;
+        for (size_t j = 0; j < unit->g_size && duplicate == NULL; ++j) {
+            const Symbol *symbol = unit->g_symbols + j;
+            const int hash = intern_hash(symbol->name);
+            if (symbol->class == FUNC && symbol->value != 0) {
+                if (find_linked(symbols, &funcs, symbol->name, hash) != NULL) {
+                    duplicate = symbol->name;
+                    break;
+                }
+                symtab_put(&funcs, symbol->name, hash, (uint32_t) s_size);
+                symbols[s_size] = *symbol;
+                symbols[s_size++].value = symbol->value + t_delta;
+            } else if (symbol->class == GLOBAL) {
+                const Symbol *linked = find_linked(symbols, &globals, symbol->name, hash);
+                if (linked == NULL) {
+                    symtab_put(&globals, symbol->name, hash, (uint32_t) s_size);
+                    symbols[s_size] = *symbol;
+                    symbols[s_size].value = symbol->value + d_delta;
+                    linked = symbols + s_size++;
+                }
+                maps[m_size++] = (GlobalMap){symbol->value, linked->value}; // 全局变量按声明顺序分配，地址递增
+            }
+        }
+        if (unit->main_entry != NULL) {
+            out->main_entry = unit->main_entry + (t_bases[i] - 1) + (out->o_text - unit->o_text);
+        }
+    }
+    m_bases[count] = m_size;
+
+    // 3. 拼接代码段和数据段，按重定位表修正绝对地址，合并重定位表和行号表
+    for (size_t i = 0; i < count && !in_place && duplicate == NULL; ++i) {
+        const Parser *unit = units + i;
+        const size_t t_words = unit->text - unit->o_text;
+        const int64_t t_delta = (int64_t) (out->o_text + t_bases[i] - 1) - (int64_t) unit->o_text;
+        const int64_t d_delta = (int64_t) (out->o_data + d_bases[i]) - (int64_t) unit->o_data;
+        int64_t *text = out->o_text + t_bases[i] - 1; // 编译单元的 o_text[w] 对应 text[w]
+        memcpy(text + 1, unit->o_text + 1, sizeof(int64_t) * t_words);
+        memcpy(out->o_data + d_bases[i], unit->o_data, unit->data - unit->o_data);
+        for (size_t j = 0; j < unit->r_size; ++j) {
+            const Reloc *reloc = unit->relocs + j;
+            int64_t *slot = text + reloc->offset;
+            if (reloc->kind == RELOC_TEXT) {
+                if (*slot != 0) {
+                    *slot += t_delta; // 为 0 表示待链接的调用，稍后填入
+                }
+            } else {
+                const GlobalMap *map = find_global(maps + m_bases[i], m_bases[i + 1] - m_bases[i], *slot);
+                *slot = map != NULL ? map->target : *slot + d_delta;
+            }
+            out->relocs[out->r_size++] = (Reloc){(uint32_t) (reloc->offset + t_bases[i] - 1), reloc->kind};
+        }
+        for (size_t j = 0; j < unit->ln_size; ++j) {
+            const LineInfo *line = unit->lines + j;
+            out->lines[out->ln_size++] = (LineInfo){(uint32_t) (line->offset + t_bases[i] - 1), line->line};
+        }
+    }
+
+    // 4. 填入仅有声明的函数的入口地址：先查找本编译单元，再查找合并后的全局符号表，最后使用原生函数桩
+    for (size_t i = 0; i < count && duplicate == NULL && undefined == NULL; ++i) {
+        const Parser *unit = units + i;
+        const int64_t t_delta = (int64_t) (out->o_text + t_bases[i] - 1) - (int64_t) unit->o_text;
+        for (size_t j = 0; j < unit->fx_size && undefined == NULL; ++j) {
+            const Fixup *fixup = unit->fixups + j;
+            const int hash = intern_hash(fixup->name);
+            const Symbol *symbol = find_linked(unit->g_symbols, &unit->g_table, fixup->name, hash);
+            int64_t target = symbol != NULL && symbol->class == FUNC && symbol->value != 0 ? symbol->value + t_delta : 0;
+            if (target == 0) {
+                const Symbol *linked = find_linked(symbols, &funcs, fixup->name, hash);
+                target = linked != NULL ? linked->value : 0;
+            }
+            if (target == 0 && symbol != NULL && symbol->class == NATIVE) {
+                target = symbol->value + t_delta; // 程序中没有同名定义：调用本编译单元中的原生函数桩
+            }
+            if (target == 0) {
+                undefined = fixup->name;
+                break;
+            }
+            out->o_text[t_bases[i] - 1 + fixup->offset] = target;
+        }
+    }
+    free(t_bases);
+    free(d_bases);
+    free(symbols);
+    symtab_free(&funcs);
+    symtab_free(&globals);
+    free(maps);
+    free(m_bases);
+    if (duplicate != NULL) {
+        fail("link: duplicate definition of %s\n", duplicate);
+    }
+    if (undefined != NULL) {
+        fail("link: undefined function %s\n", undefined);
+    }
+}
+
+/**
+ * @brief 从全局符号表中查找符号
+ * @param symbols 符号表
+ * @param table 符号表的索引
+ * @param name 名称
+ * @param hash 名称的哈希值
+ * @return 符号；不存在时返回 NULL
+ */
+Symbol *find_linked(Symbol *symbols, const SymbolTable *table, const char *name, const int hash) {
+    const int64_t i = symtab_find(table, name, hash);
+    return i != SYMTAB_NONE ? symbols + i : NULL;
+}
+
+/**
+ * @brief 二分查找全局变量的地址映射
+ * @param maps 地址映射（按编译单元中的地址升序）
+ * @param size 映射数量
+ * @param addr 编译单元中的地址
+ * @return 地址映射；不是全局变量的地址时返回 NULL
+ */
+const GlobalMap *find_global(const GlobalMap *maps, const size_t size, const int64_t addr) {
+    size_t low = 0, high = size;
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (maps[mid].addr < addr) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < size && maps[low].addr == addr ? maps + low : NULL;
+}
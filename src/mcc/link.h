@@ -0,0 +1,23 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_LINK_H
+#define MCC_LINK_H
+
+#include <stddef.h>
+
+#include "parser.h"
+
+/**
+ * @brief 链接：将多个编译单元合并为一个程序
+ * @details 各编译单元的代码段、数据段依次拼接，按重定位表修正绝对地址，重定位表和行号表随之合并；
+ * 同名全局变量视为同一变量（以首个定义为准），仅有声明的函数按合并后的全局符号表填入入口地址。
+ * 只有一个编译单元且 out 与 units 相同时，原地链接（仅填入函数入口地址）
+ * @param units 编译单元（语法分析已完成，未调用 parser_free）
+ * @param count 编译单元数量
+ * @param out 链接结果（代码段、数据段、main 函数入口、重定位表、行号表）
+ */
+void link_units(Parser *units, size_t count, Parser *out);
+
+#endif //MCC_LINK_H
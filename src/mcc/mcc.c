@@ -6,86 +6,426 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <string.h>
 
 #include "parser.h"
 #include "lexer.h"
 #include "vm.h"
+#include "bytecode.h"
+#include "image.h"
+#include "cache.h"
+#include "watch.h"
+#include "link.h"
+#include "pool.h"
+#include "source.h"
 
 /**
- * 读取文件
+ * 读取文件：普通文件直接映射，标准输入（"-"）和管道流式读取，不限大小
  *
  * @param filename  源文件名
- * @param pool_size  源文件缓冲区大小
- * @return 源文件内容
+ * @param length  源文件长度
+ * @param copy  是否复制到私有内存（热重载需要稳定的旧文本）
+ * @return 源文件内容（以 0 结尾，由 source_free 释放）
  */
-char *read_file(const char *filename, const size_t pool_size) {
-    int fd;
-    if ((fd = open(filename, 0)) < 0) {
+char *read_file(const char *filename, size_t *length, const int copy) {
+    char *source = source_load(filename, length, copy);
+    if (source == NULL) {
         printf("could not open(%s)\n", filename);
         exit(-1);
     }
+    return source;
+}
 
-    char *source = malloc(pool_size);
-    if (source == NULL) {
-        printf("could not malloc(%ld) source area\n", pool_size);
+/**
+ * 根据源文件名生成映像文件名：file.c -> file.mcb
+ *
+ * @param filename 源文件名
+ * @return 映像文件名
+ */
+char *image_name(const char *filename) {
+    const size_t length = strlen(filename);
+    char *name = malloc(length + 5);
+    if (name == NULL) {
+        printf("could not malloc(%ld) image name\n", length + 5);
         exit(-1);
     }
-    ssize_t length;
-    if ((length = read(fd, source, pool_size - 1)) <= 0) {
-        printf("read() returned %ld\n", length);
+    strcpy(name, filename);
+    if (length > 2 && strcmp(name + length - 2, ".c") == 0) {
+        name[length - 2] = '\0';
+    }
+    strcat(name, ".mcb");
+    return name;
+}
+
+/**
+ * 延迟编译回调：虚拟机首次调用函数时编译函数体
+ *
+ * @param ctx 语法分析器
+ * @param index 延迟编译的函数索引
+ * @return 函数入口
+ */
+int64_t *compile_lazy(void *ctx, const int64_t index) {
+    return parser_compile_lazy(ctx, index);
+}
+
+// 编译单元：多个源文件在线程池中并行编译，各自拥有词法分析器、语法分析器、代码段和数据段
+typedef struct {
+    const char *path; // 源文件路径
+    int src; // 是否打印指令
+    Parser *parser; // 语法分析器（语法分析完成后用于链接）
+} Unit;
+
+/**
+ * 编译任务：读取源文件，词法分析，语法分析
+ *
+ * @param arg 编译单元
+ */
+void compile_unit(void *arg) {
+    const Unit *unit = arg;
+    size_t length;
+    char *source = read_file(unit->path, &length, 0);
+    parser_init_stream(unit->parser, source, unit->src);
+    parser_parse(unit->parser);
+}
+
+/**
+ * 并行编译多个源文件并链接
+ *
+ * @param files 源文件
+ * @param count 源文件数量
+ * @param jobs 线程数（0 表示按 CPU 核数）
+ * @param src 是否打印指令（打印时按顺序逐个编译）
+ * @param out 链接结果
+ */
+void compile_units(char **files, const size_t count, size_t jobs, const int src, Parser *out) {
+    Unit *units = malloc(sizeof(Unit) * count);
+    Parser *parsers = malloc(sizeof(Parser) * count);
+    if (units == NULL || parsers == NULL) {
+        printf("could not malloc(%ld) units\n", count);
         exit(-1);
     }
-    source[length] = 0; //字符串结尾置0
-    close(fd);
+    if (src) {
+        jobs = 1; // 打印指令时逐个编译，保持输出顺序
+    } else if (jobs == 0 || jobs > count) {
+        const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        jobs = cpus > 0 && (size_t) cpus < count ? (size_t) cpus : count;
+    }
+    ThreadPool pool;
+    pool_init(&pool, jobs);
+    for (size_t i = 0; i < count; ++i) {
+        units[i] = (Unit){files[i], src, parsers + i};
+        pool_submit(&pool, compile_unit, units + i);
+    }
+    pool_wait(&pool);
+    pool_free(&pool);
 
-    return source;
+    link_units(parsers, count, out);
+    for (size_t i = 0; i < count; ++i) {
+        parser_free(parsers + i);
+        parser_free_tables(parsers + i);
+        arena_free(&parsers[i].t_arena);
+        arena_free(&parsers[i].d_arena);
+    }
+    free(parsers);
+    free(units);
+}
+
+/**
+ * 词法分析基准测试：重复扫描源文件（至少 3 次、至少 1 秒），打印吞吐量
+ *
+ * @param source 源文件文本
+ * @param jobs 线程数（大于 1 时并行词法分析）
+ */
+void lex_bench(char *source, const size_t jobs) {
+    const size_t length = strlen(source);
+    size_t runs = 0, tokens = 0;
+    const uint64_t start = cache_now();
+    uint64_t elapsed = 0;
+    while (runs < 3 || elapsed < 1000000000) {
+        Lexer lexer;
+        Interner interner;
+        intern_init(&interner);
+        lexer_init(&lexer, source, &interner);
+        lexer_analyse_parallel(&lexer, jobs > 1 ? jobs : 1);
+        tokens = lexer.t_size;
+        lexer_free(&lexer);
+        intern_free(&interner);
+        ++runs;
+        elapsed = cache_now() - start;
+    }
+    const double seconds = (double) elapsed / 1e9;
+    printf("lex(%s): %ld bytes, %ld tokens, %ld runs, %.1f MB/s, %.2f M tokens/s\n", scan_select()->name, length, tokens, runs,
+           (double) (length * runs) / seconds / 1e6, (double) (tokens * runs) / seconds / 1e6);
+}
+
+/**
+ * 统计命令行中连续的源文件（.c）数量
+ *
+ * @param argc 参数个数
+ * @param argv 参数
+ * @return 源文件数量（至少为 1）
+ */
+int count_units(const int argc, char **argv) {
+    int count = 0;
+    while (count < argc) {
+        const size_t length = strlen(argv[count]);
+        if (length < 3 || strcmp(argv[count] + length - 2, ".c") != 0) {
+            break;
+        }
+        ++count;
+    }
+    return count > 1 ? count : 1;
 }
 
 int main(int argc, char **argv) {
     int src = 0; // 如果为真，则打印生成的字节码，但不运行虚拟机；如果为假，则运行虚拟机。
     int debug = 0; // 是否打印 vm 正在执行的每一个字节码
+    int compact = 0; // 是否将指令编码为紧凑字节码后再运行
+    int lazy = 0; // 是否延迟编译函数体（首次调用时编译）
+    int compile = 0; // 是否仅编译并输出程序映像
+    const char *output = NULL; // 程序映像文件名
+    int use_cache = 0; // 是否使用编译缓存
+    int cache_stats = 0; // 是否打印编译缓存统计信息
+    int lex_only = 0; // 是否仅进行词法分析基准测试
+    const char *restore = NULL; // 快照文件名（从快照恢复运行）
+    int watch = 0; // 是否监视源文件并热重载修改的函数
+    size_t jobs = 0; // 并行编译的线程数（0 表示按 CPU 核数）
 
     --argc;
     ++argv;
-    if (argc > 0 && **argv == '-' && (*argv)[1] == 's') {
-        src = 1;
+    while (argc > 0 && **argv == '-' && strcmp(*argv, SOURCE_STDIN) != 0) {
+        const char opt = (*argv)[1];
+        if (strcmp(*argv, "--cache") == 0) {
+            use_cache = 1;
+        } else if (strcmp(*argv, "--cache-stats") == 0) {
+            cache_stats = 1;
+        } else if (strcmp(*argv, "--lex-bench") == 0) {
+            lex_only = 1;
+        } else if (strcmp(*argv, "--watch") == 0) {
+            watch = 1;
+        } else if (strcmp(*argv, "--restore") == 0 && argc > 1) {
+            --argc;
+            ++argv;
+            restore = *argv;
+        } else if (opt == 's') {
+            src = 1;
+        } else if (opt == 'd') {
+            debug = 1;
+        } else if (opt == 'b') {
+            compact = 1;
+        } else if (opt == 'l') {
+            lazy = 1;
+        } else if (opt == 'c') {
+            compile = 1;
+        } else if (opt == 'o' && argc > 1) {
+            --argc;
+            ++argv;
+            output = *argv;
+        } else if (opt == 'j' && argc > 1) {
+            --argc;
+            ++argv;
+            jobs = strtoul(*argv, NULL, 10);
+        } else {
+            argc = 0; // 未知参数：打印用法
+            break;
+        }
         --argc;
         ++argv;
     }
-    if (argc > 0 && **argv == '-' && (*argv)[1] == 'd') {
-        debug = 1;
-        --argc;
-        ++argv;
+    if (compile && argc >= 3 && strcmp(argv[argc - 2], "-o") == 0) {
+        output = argv[argc - 1]; // mcc -c file.c -o file.mcb
+        argc -= 2;
+    }
+    const int units = argc > 0 ? count_units(argc, argv) : 0; // 源文件数量：多个源文件时并行编译并链接
+    Cache cache = {0};
+    if (use_cache || cache_stats) {
+        cache_init(&cache);
+    }
+    if (cache_stats && argc < 1) {
+        cache_print_stats(&cache);
+        cache_free(&cache);
+        return 0;
+    }
+    if (restore != NULL) {
+        // 从快照恢复：跳过编译及初始化，快照中的参数替换为当前参数
+        VM vm;
+        vm_restore(&vm, restore, debug, argc + 1, argv - 1); // argv[0] 为快照文件名
+        if (vm.compact) {
+            bytecode_run(&vm);
+        } else {
+            vm_run(&vm);
+        }
+        vm_free(&vm);
+        cache_free(&cache);
+        return 0;
     }
-    if (argc < 1) {
-        printf("usage: mcc [-s] [-d] file ...\n");
+    if (argc < 1 || (compile && argc > units)) {
+        printf("usage: mcc [-s] [-d] [-b] [-l] [-c [-o image]] [-j jobs] [--cache] [--cache-stats] [--watch] "
+            "file.c ... [arg ...]\n");
+        printf("       mcc [-d] --restore snapshot [arg ...]\n");
+        printf("       mcc [-j jobs] --lex-bench file.c\n");
         return -1;
     }
 
-    const size_t pool_size = 256 * 1024; // 内存申请（文本存储、数据段、代码段、符号表）
-    char *source = read_file(*argv, pool_size); // 读取源文件
+    Image image = {0};
+    Parser parser;
+    uint64_t compile_time = 0;
+    Watch watcher;
+    int64_t *o_text, *text, *entry;
+    char *source = NULL;
+    size_t length = 0;
+    if (units > 1) {
+        use_cache = 0; // 编译缓存以单个源文件为键
+    } else if (!compile && strcmp(*argv, SOURCE_STDIN) != 0 && image_probe(*argv)) {
+        // 程序映像：跳过词法分析和语法分析
+        image_load(&image, *argv);
+    } else {
+        source = read_file(*argv, &length, watch); // 读取源文件（热重载时复制，避免映射的页面随编辑变化）
+        if (lex_only) {
+            lex_bench(source, jobs);
+            source_free(source);
+            cache_free(&cache);
+            return 0;
+        }
+        if (use_cache) {
+            // 编译缓存：命中时直接加载缓存的程序映像，跳过词法分析和语法分析
+            cache_key(&cache, source, length);
+            if (!src && !compile && cache_load(&cache, &image)) {
+                source_free(source);
+                source = NULL;
+            }
+        }
+    }
+    // 延迟编译仅用于直接运行源文件：打印指令、紧凑字节码、程序映像和编译缓存均需要完整的代码段
+    lazy = lazy && image.text == NULL && !src && !compact && !compile && !use_cache && units == 1;
+    // 热重载：直接运行源文件时有效，函数经跳转桩调用
+    watch = watch && image.text == NULL && !src && !compact && !compile && !use_cache && units == 1;
+    lazy = lazy && !watch;
+    if (image.text != NULL) {
+        o_text = image.text;
+        text = image.text + image.t_size - 1;
+        entry = image.entry;
+    } else if (units > 1) {
+        const uint64_t start = cache_now();
+        compile_units(argv, units, jobs, src, &parser);
+        compile_time = cache_now() - start;
+    } else {
+        const uint64_t start = cache_now();
 
-    // 词法分析
-    Lexer lexer;
-    lexer_init(&lexer, source);
-    lexer_analyse(&lexer);
-    lexer_free(&lexer);
+        if (lazy || watch || jobs > 1) {
+            // 词法分析：延迟编译和热重载需要全部词法单元，-j 指定多个线程时并行词法分析
+            Lexer *lexer = malloc(sizeof(Lexer));
+            Interner *interner = malloc(sizeof(Interner)); // 由语法分析器释放
+            if (lexer == NULL || interner == NULL) {
+                printf("could not malloc(%ld) lexer\n", sizeof(Lexer) + sizeof(Interner));
+                return -1;
+            }
+            intern_init(interner);
+            lexer_init(lexer, source, interner);
+            lexer_analyse_parallel(lexer, jobs);
+            parser_init(&parser, lexer, src);
+            if (watch) {
+                watch_init(&watcher, *argv, &parser); // 源文件文本由语法分析器保留，用于比较修改区域
+            }
+        } else {
+            // 流式词法分析：语法分析需要下一词法单元时才扫描源码
+            parser_init_stream(&parser, source, src);
+        }
 
-    // 语法分析，代码生成
-    Parser parser;
-    parser_init(&parser, lexer.tokens, lexer.t_size, pool_size, src);
-    parser_parse(&parser);
-    parser_free(&parser);
+        // 语法分析，代码生成
+        parser.lazy = lazy;
+        parser.watch = watch;
+        parser_parse(&parser);
+        link_units(&parser, 1, &parser); // 填入仅有声明的函数的入口地址
+        if (!lazy && !watch) {
+            parser_free(&parser); // 延迟编译：运行结束后再释放（编译函数体时仍需词法单元、符号表、重定位表和行号表）
+        }
+
+        compile_time = cache_now() - start;
+        if (use_cache && !src) {
+            cache_store(&cache, &parser, compile_time);
+        }
+    }
+    if (image.text == NULL) {
+        if (compile) {
+            char *name = output != NULL ? (char *) output : image_name(*argv);
+            image_write(&parser, name, compile_time);
+            if (name != output) {
+                free(name);
+            }
+            parser_free_tables(&parser);
+            arena_free(&parser.t_arena);
+            arena_free(&parser.d_arena);
+            cache_free(&cache);
+            return 0;
+        }
+        if (!lazy && !watch) {
+            parser_free_tables(&parser);
+        }
+        o_text = parser.o_text;
+        text = parser.text;
+        entry = parser.main_entry;
+    }
+
+    Bytecode bc;
+    if (compact && entry != NULL) {
+        bytecode_encode(&bc, o_text, text, entry);
+    }
 
     if (src) {
+        if (compact && entry != NULL) {
+            bytecode_print(&bc);
+            printf("text: %ld bytes, compact: %ld bytes\n", (text - o_text) * sizeof(int64_t), bc.size);
+            bytecode_free(&bc);
+        }
         return 0;
     }
 
-    // 虚拟机运行
+    // 多个源文件：程序参数中只保留第一个源文件作为 argv[0]
+    if (units > 1) {
+        argv[units - 1] = argv[0];
+        argc -= units - 1;
+        argv += units - 1;
+    }
+
+    // 虚拟机运行（程序映像的代码段和数据段由映像自行释放）
     VM vm;
-    vm_init(&vm, parser.o_text, parser.o_data, pool_size, parser.main_entry, debug, argc, argv);
-    vm_run(&vm);
+    if (image.text != NULL) {
+        vm_init(&vm, NULL, NULL, entry, debug, argc, argv);
+        vm_segments(&vm, image.text, image.t_size * sizeof(int64_t), image.data, image.d_size);
+    } else {
+        vm_init(&vm, &parser.t_arena, &parser.d_arena, entry, debug, argc, argv);
+        vm_segments(&vm, parser.o_text, parser.t_arena.capacity, parser.o_data, parser.d_arena.capacity);
+        if (lazy) {
+            vm.compile = compile_lazy;
+            vm.ctx = &parser;
+        }
+        if (watch) {
+            vm.watch = watch_poll;
+            vm.w_ctx = &watcher;
+        }
+    }
+    if (compact) {
+        bytecode_prepare(&vm, &bc);
+        bytecode_run(&vm);
+        bytecode_free(&bc);
+    } else {
+        vm_run(&vm);
+    }
     vm_free(&vm);
+    image_free(&image);
+    if (watch) {
+        watch_free(&watcher);
+    }
+    if (lazy || watch) {
+        parser_free(&parser);
+        parser_free_tables(&parser);
+    }
+
+    if (cache_stats) {
+        cache_print_stats(&cache);
+    }
+    cache_free(&cache);
 
     return 0;
 }
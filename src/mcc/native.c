@@ -0,0 +1,67 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#define _GNU_SOURCE
+
+#include <dlfcn.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "native.h"
+#include "fail.h"
+
+// 原生函数的调用类型：参数均按 int64_t 传递，多余的参数被调用者忽略
+typedef int64_t (*NativeFn)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t,
+                            int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t);
+
+int64_t process_epoch; // 当前进程的标识（0 表示尚未生成）
+
+void *native_lookup(const char *name) {
+    return dlsym(RTLD_DEFAULT, name);
+}
+
+int64_t native_epoch(void) {
+    const int64_t epoch = __atomic_load_n(&process_epoch, __ATOMIC_ACQUIRE);
+    if (epoch != 0) {
+        return epoch;
+    }
+    // 进程号与启动时刻：快照等在其它进程（即使进程号相同）中恢复时不会误用已解析的地址
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    int64_t expected = 0;
+    const int64_t value = ((int64_t) getpid() << 32 ^ (now.tv_sec * 1000000000 + now.tv_nsec)) | 1;
+    __atomic_compare_exchange_n(&process_epoch, &expected, value, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    return __atomic_load_n(&process_epoch, __ATOMIC_ACQUIRE);
+}
+
+void native_marshal(const int64_t *args, const int argc, int64_t *out) {
+    if (argc > NATIVE_ARGS_MAX) {
+        fail("too many native arguments: %d (max %d)\n", argc, NATIVE_ARGS_MAX);
+    }
+    for (int i = 0; i < NATIVE_ARGS_MAX; ++i) {
+        out[i] = i < argc ? args[argc - 1 - i] : 0;
+    }
+}
+
+int64_t native_call(Native *native, const int64_t *args, const int argc) {
+    const int64_t epoch = native_epoch();
+    int64_t fn;
+    if (__atomic_load_n(&native->epoch, __ATOMIC_ACQUIRE) == epoch) {
+        fn = __atomic_load_n(&native->fn, __ATOMIC_RELAXED);
+    } else {
+        // 编译时所在的进程之外首次调用：多个线程同时解析时写入相同的地址
+        fn = (int64_t) native_lookup(native->name);
+        if (fn == 0) {
+            fail("undefined native function %s\n", native->name);
+        }
+        __atomic_store_n(&native->fn, fn, __ATOMIC_RELAXED);
+        __atomic_store_n(&native->epoch, epoch, __ATOMIC_RELEASE);
+    }
+    int64_t a[NATIVE_ARGS_MAX];
+    native_marshal(args, argc, a);
+    const int64_t result = ((NativeFn) fn)(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7],
+                                           a[8], a[9], a[10], a[11], a[12], a[13], a[14], a[15]);
+    // 返回 int 的函数只设置低 32 位
+    return native->width == 1 ? (unsigned char) result : native->width == 4 ? (int32_t) result : result;
+}
@@ -0,0 +1,52 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_NATIVE_H
+#define MCC_NATIVE_H
+
+#include <stdint.h>
+
+#define NATIVE_ARGS_MAX 16 // 原生函数的最大参数个数（均按 int64_t 经整数寄存器及栈传递）
+
+// 原生函数：位于数据段（8 字节对齐），函数桩（IMM native; NATV）经此调用 libc 等已加载的函数
+// 函数地址在编译时解析；程序映像、编译缓存及快照在其它进程中加载时，按 epoch 识别并重新解析
+typedef struct {
+    int64_t fn; // 函数地址
+    int64_t epoch; // 解析 fn 的进程标识（0 表示尚未解析）
+    int32_t width; // 返回值的字节数：1 char，4 int（符号扩展），8 指针
+    int32_t params; // 声明的参数个数（经函数值调用时使用）
+    char name[]; // 函数名
+} Native;
+
+/**
+ * @brief 按名称查找已加载的函数（dlsym）
+ * @param name 函数名
+ * @return 函数地址；不存在时返回 NULL
+ */
+void *native_lookup(const char *name);
+
+/**
+ * @brief 当前进程的标识（首次调用时生成，非 0）
+ * @return 进程标识
+ */
+int64_t native_epoch(void);
+
+/**
+ * @brief 将虚拟机栈上的参数按调用顺序排列，不足 NATIVE_ARGS_MAX 的部分填 0
+ * @param args 虚拟机栈上的参数（参数依次入栈：args[argc - 1] 为第一个参数）
+ * @param argc 参数个数
+ * @param out 按调用顺序排列的参数（NATIVE_ARGS_MAX 个）
+ */
+void native_marshal(const int64_t *args, int argc, int64_t *out);
+
+/**
+ * @brief 调用原生函数，函数地址不属于当前进程时重新解析
+ * @param native 原生函数
+ * @param args 虚拟机栈上的参数（args[argc - 1] 为第一个参数）
+ * @param argc 参数个数
+ * @return 函数返回值（按 width 截断并扩展为 int64_t）
+ */
+int64_t native_call(Native *native, const int64_t *args, int argc);
+
+#endif //MCC_NATIVE_H
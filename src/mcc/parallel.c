@@ -0,0 +1,256 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parallel.h"
+
+// 创建工作者及工作线程
+Parallel *parallel_create(VM *root);
+
+// 工作线程的任务：执行自己的区间，区间为空时从其它工作者窃取
+void parallel_work(void *arg);
+
+// 从自己的区间取出一块
+int parallel_take(Worker *worker, int64_t *begin, int64_t *end);
+
+// 从其它工作者窃取一半区间
+int parallel_steal(Worker *worker);
+
+// 在虚拟机上运行 fn(i, ctx)
+void parallel_call(VM *vm, int64_t *fn, int64_t i, int64_t ctx);
+
+// 在调用线程中顺序执行
+int64_t parallel_serial(VM *vm, int64_t lo, int64_t hi, int64_t *fn, int64_t ctx);
+
+int64_t parallel_for(VM *vm, const int64_t lo, const int64_t hi, int64_t *fn, const int64_t ctx) {
+    if (vm->compact) {
+        // 紧凑字节码中函数名的值仍为定长指令的地址，无法作为循环体
+        fail("parallel_for is not supported when running compact bytecode\n");
+    }
+    if (lo >= hi) {
+        return 0;
+    }
+    VM *root = vm->root;
+    int idle = 0;
+    if (!__atomic_compare_exchange_n(&root->p_busy, &idle, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        // 工作者正在执行其它循环（嵌套在循环体中，或由其它线程调用）：等待会导致死锁
+        return parallel_serial(vm, lo, hi, fn, ctx);
+    }
+    if (root->parallel == NULL) {
+        root->parallel = parallel_create(root);
+    }
+    Parallel *parallel = root->parallel;
+    parallel->fn = fn;
+    parallel->ctx = ctx;
+    parallel->failed = 0;
+    // 区间平均分给各工作者（前 count % size 个工作者多分 1 个），全部分好后再提交任务
+    const int64_t count = hi - lo;
+    const int64_t size = (int64_t) parallel->size;
+    int64_t begin = lo;
+    for (int64_t i = 0; i < size; ++i) {
+        Worker *worker = parallel->workers + i;
+        worker->begin = begin;
+        begin += count / size + (i < count % size);
+        worker->end = begin;
+    }
+    for (size_t i = 0; i < parallel->size; ++i) {
+        pool_submit(&parallel->pool, parallel_work, parallel->workers + i);
+    }
+    pool_wait(&parallel->pool);
+    const int failed = parallel->failed;
+    char message[FAIL_SIZE];
+    memcpy(message, parallel->message, FAIL_SIZE);
+    __atomic_store_n(&root->p_busy, 0, __ATOMIC_RELEASE);
+    if (failed) {
+        fail("%s\n", message);
+    }
+    return count;
+}
+
+void parallel_report(const Parallel *parallel) {
+    for (size_t i = 0; i < parallel->size; ++i) {
+        const Worker *worker = parallel->workers + i;
+        printf("parallel_for worker %zu: iterations = %ld, steals = %ld, cycle = %ld\n",
+               i, worker->iterations, worker->steals, worker->vm.cycle);
+    }
+}
+
+void parallel_free(Parallel *parallel) {
+    pool_free(&parallel->pool);
+    for (size_t i = 0; i < parallel->size; ++i) {
+        vm_free(&parallel->workers[i].vm);
+        pthread_mutex_destroy(&parallel->workers[i].lock);
+    }
+    free(parallel->workers);
+    free(parallel);
+}
+
+/**
+ * @brief 创建工作者及工作线程，工作者的虚拟机与根虚拟机共享代码段、数据段和堆
+ * @details 数量由环境变量 MCC_WORKERS 指定，默认按 CPU 核数
+ * @param root 根虚拟机
+ * @return 并行循环
+ */
+Parallel *parallel_create(VM *root) {
+    Parallel *parallel = calloc(1, sizeof(Parallel));
+    if (parallel == NULL) {
+        fail("parallel_for: malloc memory failed\n");
+    }
+    const char *workers = getenv("MCC_WORKERS");
+    const long size = workers != NULL ? strtol(workers, NULL, 10) : 0;
+    pool_init(&parallel->pool, size > 0 ? (size_t) size : 0);
+    parallel->size = parallel->pool.size;
+    parallel->workers = calloc(parallel->size, sizeof(Worker));
+    if (parallel->workers == NULL) {
+        fail("parallel_for: malloc memory failed\n");
+    }
+    for (size_t i = 0; i < parallel->size; ++i) {
+        Worker *worker = parallel->workers + i;
+        if (vm_share(&worker->vm, root) != 0) {
+            fail("parallel_for: vm stack mmap error\n");
+        }
+        pthread_mutex_init(&worker->lock, NULL);
+        worker->index = i;
+        worker->parallel = parallel;
+    }
+    return parallel;
+}
+
+/**
+ * @brief 工作线程的任务：按块执行自己的区间，区间为空时从其它工作者窃取，所有区间为空时结束
+ * @details 区间只会缩小或整体转移给窃取者，没有新的迭代产生，因此找不到可窃取的区间即可结束；
+ *          运行错误只保留第一个，其它工作者在取下一块之前停止
+ * @param arg 工作者
+ */
+void parallel_work(void *arg) {
+    Worker *worker = arg;
+    Parallel *parallel = worker->parallel;
+    FailPoint point;
+    FailPoint *outer = fail_catch(&point);
+    if (setjmp(point.jump) != 0) {
+        fail_restore(outer);
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&parallel->failed, &expected, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            memcpy(parallel->message, point.message, FAIL_SIZE);
+        }
+        return;
+    }
+    int64_t begin, end;
+    while (!__atomic_load_n(&parallel->failed, __ATOMIC_ACQUIRE)) {
+        if (!parallel_take(worker, &begin, &end)) {
+            if (!parallel_steal(worker)) {
+                break;
+            }
+            continue;
+        }
+        for (int64_t i = begin; i < end; ++i) {
+            parallel_call(&worker->vm, parallel->fn, i, parallel->ctx);
+        }
+        worker->iterations += end - begin;
+    }
+    fail_restore(outer);
+}
+
+/**
+ * @brief 从自己区间的 begin 端取出一块
+ * @details 自适应分块：块大小为剩余迭代数的 1/(2 * 工作者数)（至少 1，至多 PARALLEL_CHUNK_MAX），
+ *          剩余较多时块大、加锁次数少；临近结束或被窃取后块随之变小，剩余部分仍可被空闲的工作者窃取
+ * @param worker 工作者
+ * @param begin 块的起始值
+ * @param end 块的结束值（不含）
+ * @return 1:取出 0:区间为空
+ */
+int parallel_take(Worker *worker, int64_t *begin, int64_t *end) {
+    pthread_mutex_lock(&worker->lock);
+    const int64_t remaining = worker->end - worker->begin;
+    if (remaining <= 0) {
+        pthread_mutex_unlock(&worker->lock);
+        return 0;
+    }
+    int64_t chunk = remaining / (int64_t) (2 * worker->parallel->size);
+    if (chunk < 1) {
+        chunk = 1;
+    } else if (chunk > PARALLEL_CHUNK_MAX) {
+        chunk = PARALLEL_CHUNK_MAX;
+    }
+    *begin = worker->begin;
+    worker->begin += chunk;
+    *end = worker->begin;
+    pthread_mutex_unlock(&worker->lock);
+    return 1;
+}
+
+/**
+ * @brief 从其它工作者区间的 end 端窃取一半（向上取整），放入自己的区间（此时为空）
+ * @details 从下一个编号开始依次尝试，使各窃取者分散到不同的工作者
+ * @param worker 窃取者
+ * @return 1:窃取成功 0:其它工作者的区间均为空
+ */
+int parallel_steal(Worker *worker) {
+    const Parallel *parallel = worker->parallel;
+    for (size_t k = 1; k < parallel->size; ++k) {
+        Worker *victim = parallel->workers + (worker->index + k) % parallel->size;
+        pthread_mutex_lock(&victim->lock);
+        const int64_t remaining = victim->end - victim->begin;
+        if (remaining > 0) {
+            const int64_t begin = victim->end - (remaining + 1) / 2;
+            const int64_t end = victim->end;
+            victim->end = begin;
+            pthread_mutex_unlock(&victim->lock);
+            pthread_mutex_lock(&worker->lock);
+            worker->begin = begin;
+            worker->end = end;
+            pthread_mutex_unlock(&worker->lock);
+            ++worker->steals;
+            return 1;
+        }
+        pthread_mutex_unlock(&victim->lock);
+    }
+    return 0;
+}
+
+/**
+ * @brief 在虚拟机上运行 fn(i, ctx)，从栈顶开始设置栈帧，函数返回后 vm_run 返回
+ * @param vm 虚拟机
+ * @param fn 循环体的函数入口
+ * @param i 迭代值
+ * @param ctx 循环体的第二个参数
+ */
+void parallel_call(VM *vm, int64_t *fn, const int64_t i, const int64_t ctx) {
+    const int64_t args[] = {i, ctx};
+    vm_enter(vm, fn, args, 2);
+    vm_run(vm);
+}
+
+/**
+ * @brief 在调用线程中顺序执行：使用临时的虚拟机（调用者的栈仍在使用中）
+ * @param vm 调用 parallel_for 的虚拟机
+ * @param lo 起始值
+ * @param hi 结束值（不含）
+ * @param fn 循环体的函数入口
+ * @param ctx 循环体的第二个参数
+ * @return 执行的迭代数
+ */
+int64_t parallel_serial(VM *vm, const int64_t lo, const int64_t hi, int64_t *fn, const int64_t ctx) {
+    VM serial;
+    if (vm_share(&serial, vm) != 0) {
+        fail("parallel_for: vm stack mmap error\n");
+    }
+    FailPoint point;
+    FailPoint *outer = fail_catch(&point);
+    if (setjmp(point.jump) != 0) {
+        fail_restore(outer);
+        vm_free(&serial);
+        fail("%s\n", point.message);
+    }
+    for (int64_t i = lo; i < hi; ++i) {
+        parallel_call(&serial, fn, i, ctx);
+    }
+    fail_restore(outer);
+    vm_free(&serial);
+    return hi - lo;
+}
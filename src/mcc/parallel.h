@@ -0,0 +1,68 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_PARALLEL_H
+#define MCC_PARALLEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#include "vm.h"
+#include "pool.h"
+#include "fail.h"
+
+#define PARALLEL_CHUNK_MAX 1024 // 工作者单次从自己的区间取出的最大迭代数
+
+typedef struct Parallel Parallel;
+
+// 工作者：一个工作线程使用的虚拟机及其待执行的迭代区间（双端队列）
+typedef struct {
+    VM vm; // 工作者的虚拟机（独立的栈，与根虚拟机共享代码段、数据段和堆）
+    int64_t begin; // 待执行区间 [begin, end)：工作者从 begin 端按块取出，窃取者从 end 端取走一半
+    int64_t end;
+    pthread_mutex_t lock; // 保护待执行区间
+    int64_t iterations; // 已执行的迭代数（累计）
+    int64_t steals; // 成功窃取的次数（累计）
+    size_t index; // 工作者编号
+    Parallel *parallel; // 所属的并行循环
+} Worker;
+
+// 并行循环：固定数量的工作者，每次 parallel_for 将区间平均分给各工作者，空闲的工作者从其它工作者窃取
+struct Parallel {
+    ThreadPool pool; // 工作线程（与工作者一一对应）
+    Worker *workers; // 工作者
+    size_t size; // 工作者数量
+    int64_t *fn; // 当前循环体：fn(i, ctx)
+    int64_t ctx; // 当前循环体的参数
+    int failed; // 当前循环是否发生运行错误（其它工作者随即停止取出迭代）
+    char message[FAIL_SIZE]; // 第一个运行错误的信息
+};
+
+/**
+ * @brief 并行执行 fn(i, ctx)，i 取 [lo, hi) 中的每个值，全部执行完毕后返回
+ * @details 工作者在首次调用时创建（数量由环境变量 MCC_WORKERS 指定，默认按 CPU 核数）；
+ *          嵌套或并发的调用在调用线程中顺序执行；循环体发生运行错误时，在调用线程中报告同样的错误
+ * @param vm 调用 parallel_for 的虚拟机
+ * @param lo 起始值
+ * @param hi 结束值（不含）
+ * @param fn 循环体的函数入口
+ * @param ctx 循环体的第二个参数
+ * @return 执行的迭代数
+ */
+int64_t parallel_for(VM *vm, int64_t lo, int64_t hi, int64_t *fn, int64_t ctx);
+
+/**
+ * @brief 打印每个工作者执行的迭代数、窃取次数和指令数
+ * @param parallel 并行循环
+ */
+void parallel_report(const Parallel *parallel);
+
+/**
+ * @brief 停止工作线程并释放工作者
+ * @param parallel 并行循环
+ */
+void parallel_free(Parallel *parallel);
+
+#endif //MCC_PARALLEL_H
@@ -9,30 +9,107 @@
 
 #include "parser.h"
 #include "vm.h"
-
-// 计算字符串的哈希值
-int hash_string(const char *chars);
+#include "source.h"
+#include "native.h"
+#include "fail.h"
+
+#define STRING_CAPACITY 256 // 字符串常量池初始容量
+#define RELOC_CAPACITY 1024 // 重定位表初始容量
+#define LINE_CAPACITY 256 // 行号表初始容量
+#define FUNCTION_CAPACITY 64 // 函数表初始容量
+#define FIXUP_CAPACITY 64 // 待链接调用表初始容量
+#define STREAM_CAPACITY 1024 // 流式词法分析：环形缓冲区容量（可同时访问的词法单元数量）
+#define SYMBOL_CAPACITY 256 // 符号表索引初始容量
+#define SCOPE_CAPACITY 16 // 作用域栈初始容量
+#define TEXT_MARGIN 64 // 代码段的最小剩余空间（以 int64_t 为单位）：两次检查之间生成的指令不超过此数量
+
+// 运算符优先级（由低到高）：0 表示不是运算符
+enum {
+    PREC_NONE,
+    PREC_ASSIGN, // =
+    PREC_CONDITION, // ?:
+    PREC_LOR, // ||
+    PREC_LAND, // &&
+    PREC_OR, // |
+    PREC_XOR, // ^
+    PREC_AND, // &
+    PREC_EQUALITY, // == !=
+    PREC_RELATIONAL, // < > <= >=
+    PREC_SHIFT, // << >>
+    PREC_ADDITIVE, // + -
+    PREC_MULTIPLICATIVE, // * / %
+    PREC_POSTFIX // ++ -- []（一元运算符的操作数按此优先级解析）
+};
+
+// 二元运算符（含后缀运算符）的解析规则
+typedef struct Operator Operator;
+
+struct Operator {
+    int precedence; // 优先级
+    int right; // 是否右结合
+    int opcode; // 运算指令（逻辑运算为短路跳转指令）
+    void (*emit)(Parser *parser, const Operator *op, int type, int bp_index); // 解析右操作数并生成指令（左操作数的值位于 rax）
+};
 
 // 添加系统函数到全局符号表
 void add_sys_calls(Parser *parser, const char *name, int value);
 
 // 断言当前词法单元类型是否为期望值
-void assert(TokenKind expected, const Token *token);
+void assert(const Parser *parser, TokenKind expected);
 
 // 打印生成的指令
 void print_src(Parser *parser);
 
+// 打印一行生成的指令（至 end 为止）
+void print_text(Parser *parser, size_t line, const int64_t *end);
+
 // 获取基本数据类型
-int get_basetype(const Token *token);
+int get_basetype(const Parser *parser);
 
 // 获取数据类型
 int get_datatype(Parser *parser, int basetype);
 
-// 获取指定索引的词法单元
-Token *peek(const Parser *parser, size_t index);
+// 判断指定索引的词法单元是否存在
+int has_token(const Parser *parser, size_t index);
+
+// 获取指定索引的词法单元的类型
+TokenKind peek(const Parser *parser, size_t index);
+
+// 获取指定索引的词法单元所在行号
+size_t line_at(const Parser *parser, size_t index);
+
+// 获取指定索引的词法单元的词素（位于源码中，不以 0 结尾）
+const char *lexeme_at(const Parser *parser, size_t index, size_t *length);
+
+// 获取指定索引的标识符的名称（驻留的字符串）
+const char *name_at(const Parser *parser, size_t index);
+
+// 获取指定索引的整数字面量的值
+int64_t value_at(const Parser *parser, size_t index);
+
+// 获取下一词法单元的类型
+TokenKind advance(Parser *parser);
 
-// 获取下一词法单元
-Token *advance(Parser *parser);
+// 查找全局符号
+Symbol *find_symbol_g(const Parser *parser, const char *name);
+
+// 查找局部符号（当前可见的最内层同名符号）
+Symbol *find_symbol_l(const Parser *parser, const char *name);
+
+// 添加全局符号
+Symbol *add_symbol_g(Parser *parser, const char *name, int datatype, int class, int64_t value);
+
+// 添加局部符号
+void add_symbol_l(Parser *parser, const char *name, int datatype, int64_t value);
+
+// 进入语句块的作用域
+void scope_enter(Parser *parser);
+
+// 退出语句块的作用域
+void scope_exit(Parser *parser);
+
+// 重置局部符号表及作用域栈
+void scope_reset(Parser *parser);
 
 // 解析枚举
 void parse_enum(Parser *parser);
@@ -41,7 +118,25 @@ void parse_enum(Parser *parser);
 void parse_global_variables(Parser *parser, int base_type, int data_type);
 
 // 解析函数
-void parse_function(Parser *parser, int datatype);
+void parse_function(Parser *parser, size_t t_start, int datatype);
+
+// 添加函数到函数表
+Function *add_function(Parser *parser, size_t t_start, size_t symbol, int64_t *stub);
+
+// 判断函数定义是否为声明（原型）：参数列表之后为分号
+int is_prototype(const Parser *parser);
+
+// 记录待链接的调用
+void add_fixup(Parser *parser, const int64_t *slot, const char *name);
+
+// 统计函数声明的参数个数
+int count_params(const Parser *parser);
+
+// 将仅有声明的函数绑定到同名的原生函数：生成函数桩
+void add_native(Parser *parser, Symbol *symbol, int params);
+
+// 跳过括号（含嵌套）：当前词法单元为左括号，跳过至匹配的右括号之后
+void skip_balanced(Parser *parser, TokenKind left, TokenKind right);
 
 // 解析函数参数
 int parse_function_params(Parser *parser);
@@ -49,39 +144,157 @@ int parse_function_params(Parser *parser);
 // 解析函数体
 void parse_function_body(Parser *parser, int bp_index);
 
+// 解析本地变量声明
+void parse_local_variables(Parser *parser);
+
 // 解析语句
 void parse_stmt(Parser *parser, int bp_index);
 
 // 解析表达式
 void parse_expr(Parser *parser, int level, int bp_index);
 
-void parser_init(Parser *parser, Token *tokens, const size_t t_size,
-                 const size_t pool_size, const int src) {
-    parser->tokens = tokens;
-    parser->t_size = t_size;
+// 右操作数的优先级
+int operand_level(const Operator *op);
+
+// 生成二元运算符的指令：赋值、条件、逻辑、位运算及比较、乘除、加、减、后缀递增递减、数组下标
+void emit_assign(Parser *parser, const Operator *op, int type, int bp_index);
+
+void emit_condition(Parser *parser, const Operator *op, int type, int bp_index);
+
+void emit_logical(Parser *parser, const Operator *op, int type, int bp_index);
+
+void emit_binary(Parser *parser, const Operator *op, int type, int bp_index);
+
+void emit_multiply(Parser *parser, const Operator *op, int type, int bp_index);
+
+void emit_add(Parser *parser, const Operator *op, int type, int bp_index);
+
+void emit_sub(Parser *parser, const Operator *op, int type, int bp_index);
+
+void emit_postfix(Parser *parser, const Operator *op, int type, int bp_index);
+
+void emit_index(Parser *parser, const Operator *op, int type, int bp_index);
+
+// 运算符表：按词法单元类型索引，未列出的词法单元优先级为 0（表达式到此结束）
+const Operator OPERATORS[TK_RIGHT_BRACKET + 1] = {
+    [TK_ASSIGN] = {PREC_ASSIGN, 1, 0, emit_assign},
+    [TK_CONDITION] = {PREC_CONDITION, 1, 0, emit_condition},
+    [TK_LOR] = {PREC_LOR, 0, JNZ, emit_logical},
+    [TK_LAND] = {PREC_LAND, 0, JZ, emit_logical},
+    [TK_OR] = {PREC_OR, 0, OR, emit_binary},
+    [TK_XOR] = {PREC_XOR, 0, XOR, emit_binary},
+    [TK_AND] = {PREC_AND, 0, AND, emit_binary},
+    [TK_EQUAL] = {PREC_EQUALITY, 0, EQ, emit_binary},
+    [TK_NE] = {PREC_EQUALITY, 0, NE, emit_binary},
+    [TK_LT] = {PREC_RELATIONAL, 0, LT, emit_binary},
+    [TK_GT] = {PREC_RELATIONAL, 0, GT, emit_binary},
+    [TK_LE] = {PREC_RELATIONAL, 0, LE, emit_binary},
+    [TK_GE] = {PREC_RELATIONAL, 0, GE, emit_binary},
+    [TK_SHL] = {PREC_SHIFT, 0, SHL, emit_binary},
+    [TK_SHR] = {PREC_SHIFT, 0, SHR, emit_binary},
+    [TK_PLUS] = {PREC_ADDITIVE, 0, ADD, emit_add},
+    [TK_MINUS] = {PREC_ADDITIVE, 0, SUB, emit_sub},
+    [TK_STAR] = {PREC_MULTIPLICATIVE, 0, MUL, emit_multiply},
+    [TK_SLASH] = {PREC_MULTIPLICATIVE, 0, DIV, emit_multiply},
+    [TK_MOD] = {PREC_MULTIPLICATIVE, 0, MOD, emit_multiply},
+    [TK_INC] = {PREC_POSTFIX, 0, ADD, emit_postfix},
+    [TK_DEC] = {PREC_POSTFIX, 0, SUB, emit_postfix},
+    [TK_LEFT_BRACKET] = {PREC_POSTFIX, 0, 0, emit_index},
+};
+
+// 记录重定位：代码段中保存绝对地址的位置
+void add_reloc(Parser *parser, const int64_t *slot, int kind);
+
+// 记录行号：后续生成的指令对应的源代码行号
+void add_line(Parser *parser);
+
+// 字符串常量入池（去重），返回常量池条目的索引
+uint32_t intern_string(Parser *parser, const char *lexeme, size_t count);
+
+// 引用字符串常量：已布局时填入地址，否则记录引用，布局时填入
+void ref_string(Parser *parser, int64_t *slot, uint32_t index);
+
+// 布局字符串常量池：后缀相同的字符串合并，其余写入数据段，并填入各引用的地址
+void layout_strings(Parser *parser);
+
+// 将字符串写入数据段
+const char *place_string(Parser *parser, const char *chars, size_t length);
+
+// 按逆序的字节比较两个字符串常量池条目
+int compare_reversed(const void *a, const void *b);
+
+// 确保代码段在当前位置之后至少还有 TEXT_MARGIN 个空位
+void reserve_text(Parser *parser);
+
+// 确保数据段在当前位置之后至少还有 size 个空闲字节
+void reserve_data(Parser *parser, size_t size);
+
+// 符号表扩容：容量翻倍
+Symbol *resize_symbols(Symbol *symbols, size_t *capacity);
+
+void parser_init(Parser *parser, Lexer *lexer, const int src) {
+    parser->lexer = lexer;
+    parser->interner = lexer->interner; // 接管词法分析器的驻留表：标识符已在扫描时驻留
     parser->t_index = 0;
     parser->g_size = 0;
     parser->l_size = 0;
     parser->line = 1;
     parser->src = src;
     parser->expr_type = CHAR;
-    parser->o_text = malloc(pool_size);
-    parser->o_data = malloc(pool_size);
-    parser->g_symbols = malloc(pool_size);
-    parser->l_symbols = malloc(pool_size);
+    // 代码段和数据段为保留的地址空间（按需提交，初始值为 0），不占用 brk 堆，快照恢复时可映射到原地址
+    const int t_ok = arena_init(&parser->t_arena, SEGMENT_CAPACITY) == 0;
+    const int d_ok = arena_init(&parser->d_arena, SEGMENT_CAPACITY) == 0;
+    parser->o_text = (int64_t *) parser->t_arena.base;
+    parser->o_data = parser->d_arena.base;
+    parser->g_capacity = SYMBOL_CAPACITY;
+    parser->g_symbols = malloc(sizeof(Symbol) * parser->g_capacity);
+    parser->l_capacity = SYMBOL_CAPACITY;
+    parser->l_symbols = malloc(sizeof(Symbol) * parser->l_capacity);
+    parser->s_size = 0;
+    parser->s_capacity = STRING_CAPACITY;
+    parser->s_count = 0;
+    parser->s_saved = 0;
+    parser->strings = malloc(sizeof(StringEntry) * parser->s_capacity);
+    intern_init(&parser->s_interner);
+    parser->sr_size = 0;
+    parser->sr_capacity = STRING_CAPACITY;
+    parser->s_refs = malloc(sizeof(StringRef) * parser->sr_capacity);
+    parser->s_laid = 0;
+    parser->li_size = 0;
+    parser->li_capacity = LINE_CAPACITY;
+    parser->listing = malloc(sizeof(LineInfo) * parser->li_capacity);
+    parser->r_size = 0;
+    parser->r_capacity = RELOC_CAPACITY;
+    parser->relocs = malloc(sizeof(Reloc) * parser->r_capacity);
+    parser->ln_size = 0;
+    parser->ln_capacity = LINE_CAPACITY;
+    parser->lines = malloc(sizeof(LineInfo) * parser->ln_capacity);
+    parser->fx_size = 0;
+    parser->fx_capacity = FIXUP_CAPACITY;
+    parser->fixups = malloc(sizeof(Fixup) * parser->fx_capacity);
+    parser->f_size = 0;
+    parser->f_capacity = FUNCTION_CAPACITY;
+    parser->functions = malloc(sizeof(Function) * parser->f_capacity);
+    parser->sc_capacity = SCOPE_CAPACITY;
+    parser->scopes = malloc(sizeof(int) * parser->sc_capacity);
+    parser->lazy = 0;
+    parser->watch = 0;
+    parser->main_entry = NULL;
 
     parser->l_text = parser->text = parser->o_text;
     parser->data = parser->o_data;
 
-    if (parser->text == NULL || parser->data == NULL ||
-        parser->g_symbols == NULL || parser->l_symbols == NULL) {
-        printf("malloc error\n");
-        exit(-1);
+    if (!t_ok || !d_ok ||
+        parser->g_symbols == NULL || parser->l_symbols == NULL ||
+        parser->strings == NULL || parser->s_refs == NULL || parser->listing == NULL ||
+        parser->relocs == NULL || parser->lines == NULL || parser->functions == NULL || parser->fixups == NULL ||
+        parser->scopes == NULL) {
+        fail("malloc error\n");
     }
-    memset(parser->text, 0, pool_size);
-    memset(parser->data, 0, pool_size);
-    memset(parser->g_symbols, 0, pool_size);
-    memset(parser->l_symbols, 0, pool_size);
+    symtab_init(&parser->g_table, SYMBOL_CAPACITY);
+    symtab_init(&parser->l_table, SYMBOL_CAPACITY);
+    scope_reset(parser);
+    add_line(parser);
 
     add_sys_calls(parser, "open", OPEN);
     add_sys_calls(parser, "read", READ);
@@ -90,20 +303,45 @@ void parser_init(Parser *parser, Token *tokens, const size_t t_size,
     add_sys_calls(parser, "malloc", MALC);
     add_sys_calls(parser, "memset", MSET);
     add_sys_calls(parser, "memcmp", MCMP);
+    add_sys_calls(parser, "snapshot", SNAP);
     add_sys_calls(parser, "exit", EXIT);
+    add_sys_calls(parser, "thread_create", THRC);
+    add_sys_calls(parser, "thread_join", THRJ);
+    add_sys_calls(parser, "atomic_add", AADD);
+    add_sys_calls(parser, "atomic_cas", ACAS);
+    add_sys_calls(parser, "mutex_lock", LOCK);
+    add_sys_calls(parser, "mutex_unlock", UNLK);
+    add_sys_calls(parser, "parallel_for", PFOR);
+    add_sys_calls(parser, "coro_create", CNEW);
+    add_sys_calls(parser, "coro_resume", CRES);
+    add_sys_calls(parser, "coro_yield", CYLD);
+    add_sys_calls(parser, "coro_done", CDON);
+    add_sys_calls(parser, "qsort", QSRT);
+    add_sys_calls(parser, "bsearch", BSCH);
+}
+
+void parser_init_stream(Parser *parser, char *source, const int src) {
+    Lexer *lexer = malloc(sizeof(Lexer));
+    Interner *interner = malloc(sizeof(Interner));
+    if (lexer == NULL || interner == NULL) {
+        fail("malloc error\n");
+    }
+    intern_init(interner);
+    lexer_init_stream(lexer, source, STREAM_CAPACITY, interner);
+    parser_init(parser, lexer, src);
 }
 
 void parser_free(Parser *parser) {
-    if (parser->tokens != NULL) {
-        for (size_t i = 0; i < parser->t_size; i++) {
-            Token token = parser->tokens[i];
-            if (token.lexeme != NULL) {
-                free((void *) token.lexeme);
-                token.lexeme = NULL;
-            }
-        }
-        free(parser->tokens);
-        parser->tokens = NULL;
+    if (parser->lexer != NULL) {
+        lexer_free(parser->lexer);
+        source_free(parser->lexer->source);
+        free(parser->lexer);
+        parser->lexer = NULL;
+    }
+    if (parser->interner != NULL) {
+        intern_free(parser->interner); // 符号名一次性释放
+        free(parser->interner);
+        parser->interner = NULL;
     }
     if (parser->g_symbols != NULL) {
         free(parser->g_symbols);
@@ -113,6 +351,44 @@ void parser_free(Parser *parser) {
         free(parser->l_symbols);
         parser->l_symbols = NULL;
     }
+    symtab_free(&parser->g_table);
+    symtab_free(&parser->l_table);
+    if (parser->scopes != NULL) {
+        free(parser->scopes);
+        parser->scopes = NULL;
+    }
+    if (parser->strings != NULL) {
+        free(parser->strings);
+        parser->strings = NULL;
+    }
+    if (parser->s_refs != NULL) {
+        free(parser->s_refs);
+        parser->s_refs = NULL;
+    }
+    if (parser->listing != NULL) {
+        free(parser->listing);
+        parser->listing = NULL;
+    }
+    intern_free(&parser->s_interner);
+    if (parser->functions != NULL) {
+        free(parser->functions);
+        parser->functions = NULL;
+    }
+    if (parser->fixups != NULL) {
+        free(parser->fixups);
+        parser->fixups = NULL;
+    }
+}
+
+void parser_free_tables(Parser *parser) {
+    if (parser->relocs != NULL) {
+        free(parser->relocs);
+        parser->relocs = NULL;
+    }
+    if (parser->lines != NULL) {
+        free(parser->lines);
+        parser->lines = NULL;
+    }
 }
 
 
@@ -121,37 +397,34 @@ void parser_free(Parser *parser) {
  * @param parser 语法分析器
  */
 void parser_parse(Parser *parser) {
-    while (parser->t_index < parser->t_size) {
-        const Token *token = peek(parser, parser->t_index);
-        if (token->kind == TK_ENUM) {
+    while (has_token(parser, parser->t_index)) {
+        if (peek(parser, parser->t_index) == TK_ENUM) {
             parse_enum(parser); // 解析枚举常量
             continue;
         }
-        const int basetype = get_basetype(token); // 获取数据类型
+        const int is_extern = peek(parser, parser->t_index) == TK_EXTERN;
+        if (is_extern) {
+            advance(parser); // extern 声明与函数原型相同
+        }
+        const size_t t_start = parser->t_index;
+        const int basetype = get_basetype(parser); // 获取数据类型
         const int datatype = get_datatype(parser, basetype); // 叠加指针类型
-        const Token *p1 = peek(parser, parser->t_index); // identifier
-        assert(TK_ID, p1);
-        const Token *p2 = peek(parser, parser->t_index + 1);
-        if (p2->kind == TK_LEFT_PAREN) {
-            parse_function(parser, datatype); // 解析函数
+        assert(parser, TK_ID); // identifier
+        if (is_extern && (peek(parser, parser->t_index + 1) != TK_LEFT_PAREN || !is_prototype(parser))) {
+            fail("line:%ld, extern is only supported for function declarations\n", line_at(parser, parser->t_index));
+        }
+        if (peek(parser, parser->t_index + 1) == TK_LEFT_PAREN) {
+            parse_function(parser, t_start, datatype); // 解析函数
         } else {
             parse_global_variables(parser, basetype, datatype); // 解析全局变量
         }
     }
     print_src(parser); // 打印最后一行生成的指令
-}
-
-/**
- * @brief 计算字符串的哈希值
- * @param chars 字符串
- * @return hashcode
- */
-int hash_string(const char *chars) {
-    int hash = (unsigned char) *chars;
-    while (*chars != '\0') {
-        hash = hash * 147 + *chars++;
+    layout_strings(parser);
+    if (parser->src) {
+        printf("strings: %ld literals, %ld pooled, %ld bytes saved\n",
+               parser->s_count, parser->s_size, parser->s_saved);
     }
-    return hash;
 }
 
 /**
@@ -161,19 +434,19 @@ int hash_string(const char *chars) {
  * @param value 函数值
  */
 void add_sys_calls(Parser *parser, const char *name, const int value) {
-    const int hash = hash_string(name);
-    parser->g_symbols[parser->g_size++] = (Symbol){hash, name, INT, SYS, value};
+    name = intern(parser->interner, name, strlen(name), hash_string(name)); // 与词素驻留于同一驻留表
+    add_symbol_g(parser, name, INT, SYS, value);
 }
 
 /**
- * @brief 词法单元类型断言
+ * @brief 当前词法单元类型断言
+ * @param parser 语法分析器
  * @param expected 期望类型
- * @param token 实际类型
  */
-void assert(const TokenKind expected, const Token *token) {
-    if (expected != token->kind) {
-        printf("line:%ld, expected: %d, but got %d\n", token->line, expected, token->kind);
-        exit(-1);
+void assert(const Parser *parser, const TokenKind expected) {
+    const TokenKind kind = peek(parser, parser->t_index);
+    if (expected != kind) {
+        fail("line:%ld, expected: %d, but got %d\n", line_at(parser, parser->t_index), expected, kind);
     }
 }
 
@@ -182,92 +455,225 @@ void assert(const TokenKind expected, const Token *token) {
  * @param parser 语法分析器
  */
 void print_src(Parser *parser) {
-    if (parser->src) {
-        //命令行指明-s参数,输出源代码和对应字节码
-        printf("%ld:\n", parser->line);
-        while (parser->l_text < parser->text) {
-            printf("%8.4s", &"LEA ,IMM ,JMP ,JSR ,JZ  ,JNZ ,ENT ,ADJ ,LEV ,LI  ,LC  ,SI  ,SC  ,PUSH,"
-                   "OR  ,XOR ,AND ,EQ  ,NE  ,LT  ,GT  ,LE  ,GE  ,SHL ,SHR ,ADD ,SUB ,MUL ,DIV ,MOD ,"
-                   "OPEN,READ,CLOS,PRTF,MALC,MSET,MCMP,EXIT,"[*++parser->l_text * 5]);
-            if (*parser->l_text <= ADJ) {
-                //ADJ之前的指令均有操作数
-                printf(" %ld\n", *++parser->l_text);
-            } else {
-                printf("\n");
-            }
+    if (!parser->src) {
+        return;
+    }
+    if (parser->s_laid) {
+        print_text(parser, parser->line, parser->text);
+        return;
+    }
+    // 字符串常量的地址在布局时才填入：先记录各行的结束位置，布局后统一打印
+    if (parser->li_size == parser->li_capacity) {
+        parser->li_capacity = parser->li_capacity * 2;
+        LineInfo *listing = realloc(parser->listing, sizeof(LineInfo) * parser->li_capacity);
+        if (listing == NULL) {
+            fail("listing: realloc memory failed\n");
+        }
+        parser->listing = listing;
+    }
+    parser->listing[parser->li_size++] = (LineInfo){(uint32_t) (parser->text - parser->o_text), (uint32_t) parser->line};
+}
+
+/**
+ * @brief 打印一行生成的指令
+ * @param parser 语法分析器
+ * @param line 行号
+ * @param end 本行最后一条指令（含操作数）的位置
+ */
+void print_text(Parser *parser, const size_t line, const int64_t *end) {
+    //命令行指明-s参数,输出源代码和对应字节码
+    printf("%ld:\n", line);
+    while (parser->l_text < end) {
+        printf("%8.4s", &OPCODE_NAMES[*++parser->l_text * 5]);
+        if (*parser->l_text <= ADJ) {
+            //ADJ之前的指令均有操作数
+            printf(" %ld\n", *++parser->l_text);
+        } else {
+            printf("\n");
+        }
+    }
+}
+
+/**
+ * @brief 记录重定位：代码段中保存绝对地址的位置（跳转目标、函数入口、全局变量及字符串地址）
+ * @param parser 语法分析器
+ * @param slot 保存绝对地址的位置
+ * @param kind 地址类型：RELOC_TEXT 代码段地址；RELOC_DATA 数据段地址
+ */
+void add_reloc(Parser *parser, const int64_t *slot, const int kind) {
+    if (parser->r_size == parser->r_capacity) {
+        parser->r_capacity = parser->r_capacity * 2;
+        Reloc *relocs = realloc(parser->relocs, sizeof(Reloc) * parser->r_capacity);
+        if (relocs == NULL) {
+            fail("relocs: realloc memory failed\n");
+        }
+        parser->relocs = relocs;
+    }
+    parser->relocs[parser->r_size++] = (Reloc){(uint32_t) (slot - parser->o_text), (uint32_t) kind};
+}
+
+/**
+ * @brief 记录行号：后续生成的指令对应的源代码行号
+ * @param parser 语法分析器
+ */
+void add_line(Parser *parser) {
+    const uint32_t offset = parser->text + 1 - parser->o_text;
+    if (parser->ln_size > 0 && parser->lines[parser->ln_size - 1].offset == offset) {
+        // 上一行未生成指令，直接覆盖
+        parser->lines[parser->ln_size - 1].line = parser->line;
+        return;
+    }
+    if (parser->ln_size == parser->ln_capacity) {
+        parser->ln_capacity = parser->ln_capacity * 2;
+        LineInfo *lines = realloc(parser->lines, sizeof(LineInfo) * parser->ln_capacity);
+        if (lines == NULL) {
+            fail("lines: realloc memory failed\n");
         }
+        parser->lines = lines;
     }
+    parser->lines[parser->ln_size++] = (LineInfo){offset, (uint32_t) parser->line};
 }
 
 /**
- * @brief 获取指定索引的词法单元
+ * @brief 判断指定索引的词法单元是否存在（流式词法分析时按需扫描至该词法单元）
  * @param parser 语法分析器
  * @param index 词法单元所在索引
- * @return 词法单元
+ * @return 1:存在 0:已超出源码末尾
  */
-Token *peek(const Parser *parser, const size_t index) {
-    return parser->tokens + index;
+int has_token(const Parser *parser, const size_t index) {
+    Lexer *lexer = parser->lexer;
+    if (lexer->t_mask == (size_t) -1) {
+        return index < lexer->t_size;
+    }
+    while (lexer->t_size <= index) {
+        if (!lexer_next(lexer)) {
+            return 0;
+        }
+    }
+    return 1;
 }
 
 /**
- * @brief 获取下一词法单元
+ * @brief 获取指定索引的词法单元在各数组中的位置（流式词法分析时检查是否仍在环形缓冲区中）
  * @param parser 语法分析器
- * @return 下一词法单元
+ * @param index 词法单元所在索引（已确认存在）
+ * @return 数组下标
  */
-Token *advance(Parser *parser) {
-    Token *token = peek(parser, ++parser->t_index);
-    if (token->line > parser->line) {
-        print_src(parser);
-        parser->line = token->line;
+size_t token_slot(const Parser *parser, const size_t index) {
+    const Lexer *lexer = parser->lexer;
+    if (index + lexer->t_capacity < lexer->t_size && lexer->t_mask != (size_t) -1) {
+        fail("line:%ld, token %ld is out of the lookahead window\n", parser->line, index);
     }
-    return token;
+    return index & lexer->t_mask;
 }
 
 /**
- * @brief 断言当前词法单元类型是否为期望值，并获取下一词法单元
+ * @brief 获取指定索引的词法单元的类型
  * @param parser 语法分析器
- * @param expected 期望词法单元类型
- * @return 下一词法单元
+ * @param index 词法单元所在索引
+ * @return 词法单元类型；超出源码末尾时为 0
  */
-Token *consume(Parser *parser, const TokenKind expected) {
-    const Token *tk = peek(parser, parser->t_index);
-    assert(expected, tk);
-    return advance(parser);
+TokenKind peek(const Parser *parser, const size_t index) {
+    if (!has_token(parser, index)) {
+        return 0; // 源码末尾之后
+    }
+    return parser->lexer->kinds[token_slot(parser, index)];
+}
+
+/**
+ * @brief 获取指定索引的词法单元所在行号
+ * @param parser 语法分析器
+ * @param index 词法单元所在索引
+ * @return 行号；超出源码末尾时同最后一个词法单元
+ */
+size_t line_at(const Parser *parser, const size_t index) {
+    return lexer_line(parser->lexer, index);
+}
+
+/**
+ * @brief 获取指定索引的词法单元的词素
+ * @param parser 语法分析器
+ * @param index 词法单元所在索引
+ * @param length 词素长度
+ * @return 词素在源码中的起始地址（不以 0 结尾）；超出源码末尾时为空字符串
+ */
+const char *lexeme_at(const Parser *parser, const size_t index, size_t *length) {
+    if (!has_token(parser, index)) {
+        *length = 0;
+        return "";
+    }
+    const size_t slot = token_slot(parser, index);
+    *length = parser->lexer->lengths[slot];
+    return parser->lexer->source + parser->lexer->offsets[slot];
 }
 
 /**
- * @brief Convert lexeme to integer
- * @param lexeme 词素
- * @return 词素对应的整数
+ * @brief 获取指定索引的标识符的名称：词法分析时已驻留，相同的名称指针相同
+ * @param parser 语法分析器
+ * @param index 词法单元所在索引（标识符）
+ * @return 名称（驻留的字符串）
+ */
+const char *name_at(const Parser *parser, const size_t index) {
+    return parser->interner->names[parser->lexer->ids[token_slot(parser, index)]];
+}
+
+/**
+ * @brief 获取指定索引的整数字面量的值（词法分析时已解析）
+ * @param parser 语法分析器
+ * @param index 词法单元所在索引
+ * @return 整数值
+ */
+int64_t value_at(const Parser *parser, const size_t index) {
+    return parser->lexer->values[token_slot(parser, index)];
+}
+
+/**
+ * @brief 获取下一词法单元
+ * @param parser 语法分析器
+ * @return 下一词法单元的类型
  */
-int64_t to_integer(const char *lexeme) {
-    char *end;
-    const int64_t num = strtoll(lexeme, &end, 0);
-    if (*end != '\0') {
-        printf("bad number %s\n", lexeme);
-        exit(-1);
+TokenKind advance(Parser *parser) {
+    const TokenKind kind = peek(parser, ++parser->t_index);
+    const size_t line = line_at(parser, parser->t_index);
+    if (line > parser->line) {
+        print_src(parser);
+        parser->line = line;
+        add_line(parser);
     }
-    return num;
+    return kind;
 }
 
 /**
- * @brief 根据词法符号获取基本数据类型
- * @param token 词法单元
+ * @brief 断言当前词法单元类型是否为期望值，并获取下一词法单元
+ * @param parser 语法分析器
+ * @param expected 期望词法单元类型
+ * @return 下一词法单元的类型
+ */
+TokenKind consume(Parser *parser, const TokenKind expected) {
+    assert(parser, expected);
+    return advance(parser);
+}
+
+/**
+ * @brief 根据当前词法单元获取基本数据类型
+ * @param parser 语法分析器
  * @return 基本数据类型
  */
-int get_basetype(const Token *token) {
-    if (token->kind == TK_INT) {
+int get_basetype(const Parser *parser) {
+    const TokenKind kind = peek(parser, parser->t_index);
+    if (kind == TK_INT) {
         return INT;
     }
-    if (token->kind == TK_CHAR) {
+    if (kind == TK_CHAR) {
         return CHAR;
     }
-    if (token->kind == TK_VOID) {
+    if (kind == TK_VOID) {
         // void 当作 char 处理
         return CHAR;
     }
-    printf("line:%ld, unsupported datatype %s\n", token->line, token->lexeme);
-    exit(-1);
+    size_t length;
+    const char *lexeme = lexeme_at(parser, parser->t_index, &length);
+    fail("line:%ld, unsupported datatype %.*s\n", line_at(parser, parser->t_index), (int) length, lexeme);
 }
 
 /**
@@ -278,59 +684,156 @@ int get_basetype(const Token *token) {
  */
 int get_datatype(Parser *parser, const int basetype) {
     int datatype = basetype;
-    while (advance(parser)->kind == TK_STAR) {
+    while (advance(parser) == TK_STAR) {
         datatype += PTR;
     }
     return datatype;
 }
 
 /**
- * @brief 从指定符号表查找符号
- * @param symbols 符号表
- * @param size 符号表大小
- * @param token 词法符号
- * @param hash 符号的哈希值
- * @return 符号
+ * @brief 查找全局符号（此前定义的符号，与立即编译时可见的范围一致）
+ * @param parser 语法分析器
+ * @param name 名称（驻留的字符串）
+ * @return 符号；不存在时返回 NULL
  */
-Symbol *find_symbol(Symbol *symbols, const size_t size, const Token *token, const int hash) {
-    for (size_t i = 0; i < size; ++i) {
-        Symbol *symbol = symbols + i;
-        if (symbol->hash == hash && strcmp(symbol->name, token->lexeme) == 0) {
+Symbol *find_symbol_g(const Parser *parser, const char *name) {
+    const int64_t i = symtab_find(&parser->g_table, name, intern_hash(name));
+    return i != SYMTAB_NONE && (size_t) i < parser->g_size ? parser->g_symbols + i : NULL;
+}
+
+/**
+ * @brief 查找局部符号：索引指向最内层的同名符号，其作用域已退出时沿遮蔽链查找外层的同名符号
+ * @param parser 语法分析器
+ * @param name 名称（驻留的字符串）
+ * @return 符号；不存在时返回 NULL
+ */
+Symbol *find_symbol_l(const Parser *parser, const char *name) {
+    int64_t i = symtab_find(&parser->l_table, name, intern_hash(name));
+    while (i != SYMTAB_NONE) {
+        Symbol *symbol = parser->l_symbols + i;
+        if (symbol->depth <= (int) parser->sc_depth && parser->scopes[symbol->depth] == symbol->scope) {
             return symbol;
         }
+        i = (int64_t) symbol->shadow - 1;
     }
     return NULL;
 }
 
-
 /**
  * @brief 查找符号：先从局部符号表中查找，找不到则从全局符号表中查找
  * @param parser 语法分析器
- * @param token 词法单元
- * @param hash 符号的哈希值
+ * @param name 名称（驻留的字符串）
  * @return 符号
  */
-Symbol *find_symbol_g_l(const Parser *parser, const Token *token, const int hash) {
-    Symbol *symbol = find_symbol(parser->l_symbols, parser->l_size, token, hash);
+Symbol *find_symbol_g_l(const Parser *parser, const char *name) {
+    Symbol *symbol = find_symbol_l(parser, name);
     if (symbol != NULL) {
         return symbol;
     }
-    return find_symbol(parser->g_symbols, parser->g_size, token, hash);
+    return find_symbol_g(parser, name);
+}
+
+
+/**
+ * @brief 检查当前词法单元声明的符号是否重复
+ * @param parser 语法分析器
+ * @param symbol 已有的同名符号（NULL 表示没有）
+ * @param name 名称（驻留的字符串）
+ */
+void check_symbol(const Parser *parser, const Symbol *symbol, const char *name) {
+    if (symbol != NULL) {
+        fail("line:%ld, duplicate definition of %s\n", line_at(parser, parser->t_index), name);
+    }
+}
+
+/**
+ * @brief 添加全局符号
+ * @param parser 语法分析器
+ * @param name 名称（驻留的字符串）
+ * @param datatype 数据类型
+ * @param class 符号类别
+ * @param value 值
+ * @return 符号
+ */
+Symbol *add_symbol_g(Parser *parser, const char *name, const int datatype, const int class, const int64_t value) {
+    if (parser->g_size == parser->g_capacity) {
+        parser->g_symbols = resize_symbols(parser->g_symbols, &parser->g_capacity);
+    }
+    Symbol *symbol = parser->g_symbols + parser->g_size;
+    *symbol = (Symbol){name, value, (int16_t) datatype, (int16_t) class, 0, 0, 0}; // 全局符号不属于任何作用域
+    symtab_put(&parser->g_table, name, intern_hash(name), (uint32_t) parser->g_size++);
+    return symbol;
 }
 
+/**
+ * @brief 添加局部符号：同一作用域内不允许重复声明，内层作用域的声明遮蔽外层的同名符号
+ * @param parser 语法分析器
+ * @param name 名称（驻留的字符串）
+ * @param datatype 数据类型
+ * @param value 变量在栈帧中的位置
+ */
+void add_symbol_l(Parser *parser, const char *name, const int datatype, const int64_t value) {
+    const Symbol *outer = find_symbol_l(parser, name);
+    check_symbol(parser, outer != NULL && outer->depth == (int) parser->sc_depth ? outer : NULL, name);
+    const uint32_t shadow = outer != NULL ? (uint32_t) (outer - parser->l_symbols) + 1 : 0;
+    if (parser->l_size == parser->l_capacity) {
+        parser->l_symbols = resize_symbols(parser->l_symbols, &parser->l_capacity); // outer 随之失效，此后不再使用
+    }
+    parser->l_symbols[parser->l_size] = (Symbol){
+        name, value, (int16_t) datatype, LOCAL, (int) parser->sc_depth, parser->scopes[parser->sc_depth], shadow
+    };
+    symtab_put(&parser->l_table, name, intern_hash(name), (uint32_t) parser->l_size++);
+}
 
 /**
- * @brief 检查符号是否重复
+ * @brief 进入语句块的作用域
+ * @param parser 语法分析器
+ */
+void scope_enter(Parser *parser) {
+    if (parser->sc_depth + 1 == parser->sc_capacity) {
+        parser->sc_capacity = parser->sc_capacity * 2;
+        int *scopes = realloc(parser->scopes, sizeof(int) * parser->sc_capacity);
+        if (scopes == NULL) {
+            fail("scopes: realloc memory failed\n");
+        }
+        parser->scopes = scopes;
+    }
+    parser->scopes[++parser->sc_depth] = ++parser->sc_serial;
+}
+
+/**
+ * @brief 退出语句块的作用域：O(1)，其中声明的符号因作用域编号不再位于栈中而不可见，无需逐个删除
+ * @param parser 语法分析器
+ */
+void scope_exit(Parser *parser) {
+    --parser->sc_depth;
+}
+
+/**
+ * @brief 重置局部符号表（函数开始或结束时）：O(1)，清空索引只需递增其版本号
+ * @param parser 语法分析器
+ */
+void scope_reset(Parser *parser) {
+    parser->l_size = 0;
+    symtab_clear(&parser->l_table);
+    parser->sc_depth = 0;
+    parser->sc_serial = 0;
+    parser->scopes[0] = 0;
+}
+
+/**
+ * @brief 符号表扩容：容量翻倍（符号表按需增长，初始化时无需按最大规模分配并清零）
  * @param symbols 符号表
- * @param size 符号表大小
- * @param token 词法符号
- * @param hash 符号的哈希值
+ * @param capacity 容量（扩容后更新）
+ * @return 扩容后的符号表
  */
-void check_symbol(Symbol *symbols, const size_t size, const Token *token, const int hash) {
-    if (find_symbol(symbols, size, token, hash)) {
-        printf("line:%ld, duplicate definition of %s\n", token->line, token->lexeme);
-        exit(-1);
+Symbol *resize_symbols(Symbol *symbols, size_t *capacity) {
+    *capacity = *capacity * 2;
+    symbols = realloc(symbols, sizeof(Symbol) * *capacity);
+    if (symbols == NULL) {
+        fail("symbols: realloc memory failed\n");
     }
+    return symbols;
 }
 
 
@@ -340,31 +843,29 @@ void check_symbol(Symbol *symbols, const size_t size, const Token *token, const
  */
 void parse_enum(Parser *parser) {
     // enum [id]{ A, B = 8, C }
-    const Token *token = advance(parser);
-    if (token->kind == TK_ID) {
+    TokenKind kind = advance(parser);
+    if (kind == TK_ID) {
         advance(parser); // 跳过枚举名称
     }
 
     int64_t i = 0;
-    token = consume(parser, TK_LEFT_BRACE);
-    while (token->kind != TK_RIGHT_BRACE) {
-        assert(TK_ID, token);
-        const char *name = token->lexeme;
-        const int hash = hash_string(name);
-        check_symbol(parser->g_symbols, parser->g_size, token, hash); // 检查是否有重复
-        if (token->kind == TK_ASSIGN) {
-            token = advance(parser);
-            if (token->kind != TK_NUMBER) {
-                printf("bad enum initializer:%d\n", token->kind);
-                exit(-1);
+    kind = consume(parser, TK_LEFT_BRACE);
+    while (kind != TK_RIGHT_BRACE) {
+        assert(parser, TK_ID);
+        const char *name = name_at(parser, parser->t_index);
+        check_symbol(parser, find_symbol_g(parser, name), name); // 检查是否有重复
+        if (kind == TK_ASSIGN) {
+            kind = advance(parser);
+            if (kind != TK_NUMBER) {
+                fail("bad enum initializer:%d\n", kind);
             }
-            i = to_integer(token->lexeme);
-            token = advance(parser);
+            i = value_at(parser, parser->t_index);
+            kind = advance(parser);
         }
-        parser->g_symbols[parser->g_size++] = (Symbol){hash, name, INT, ENUM, i};
+        add_symbol_g(parser, name, INT, ENUM, i);
         i++;
-        if (token->kind == TK_COMMA) {
-            token = advance(parser);
+        if (kind == TK_COMMA) {
+            kind = advance(parser);
         }
     }
     consume(parser, TK_RIGHT_BRACE);
@@ -379,23 +880,21 @@ void parse_enum(Parser *parser) {
  */
 void parse_global_variables(Parser *parser, const int base_type, int data_type) {
     while (1) {
-        const Token *token = peek(parser, parser->t_index);
-        assert(TK_ID, token);
-        const char *name = token->lexeme;
-        const int hash = hash_string(name);
+        assert(parser, TK_ID);
+        const char *name = name_at(parser, parser->t_index);
+        reserve_data(parser, sizeof(int64_t));
         const int64_t data_index = (int64_t) parser->data; // 全局变量静态存储位置
-        check_symbol(parser->g_symbols, parser->g_size, token, hash);
-        parser->g_symbols[parser->g_size++] = (Symbol){hash, name, data_type, GLOBAL, data_index};
+        check_symbol(parser, find_symbol_g(parser, name), name);
+        add_symbol_g(parser, name, data_type, GLOBAL, data_index);
         parser->data += sizeof(int64_t);
-        token = advance(parser);
-        if (token->kind == TK_COMMA) {
+        const TokenKind kind = advance(parser);
+        if (kind == TK_COMMA) {
             data_type = get_datatype(parser, base_type);
-        } else if (token->kind == TK_SEMICOLON) {
+        } else if (kind == TK_SEMICOLON) {
             advance(parser);
             break;
         } else {
-            printf("bad variable declaration:%d\n", token->kind);
-            exit(-1);
+            fail("bad variable declaration:%d\n", kind);
         }
     }
 }
@@ -403,27 +902,238 @@ void parse_global_variables(Parser *parser, const int base_type, int data_type)
 /**
  * @brief 解析函数
  * @param parser 语法分析器
+ * @param t_start 函数定义首个词法单元的索引
  * @param datatype 函数返回类型
  */
-void parse_function(Parser *parser, const int datatype) {
-    const Token *token = peek(parser, parser->t_index);
-    const char *name = token->lexeme;
-    const int hash = hash_string(name);
+void parse_function(Parser *parser, const size_t t_start, const int datatype) {
+    const char *name = name_at(parser, parser->t_index);
+    // 已声明（原型）的函数：定义时填入入口地址；函数入口为 0 表示仅有声明，绑定到原生函数的声明为 NATIVE
+    Symbol *symbol = find_symbol_g(parser, name);
+    if (symbol != NULL && symbol->class != NATIVE &&
+        (symbol->class != FUNC || (symbol->value != 0 && !is_prototype(parser)))) {
+        fail("line:%ld, duplicate definition of %s\n", line_at(parser, parser->t_index), name);
+    }
+    if (symbol == NULL) {
+        symbol = add_symbol_g(parser, name, datatype, FUNC, 0);
+    }
+    if (is_prototype(parser)) {
+        // 函数声明：int f(int a);
+        advance(parser);
+        const int params = count_params(parser);
+        skip_balanced(parser, TK_LEFT_PAREN, TK_RIGHT_PAREN);
+        consume(parser, TK_SEMICOLON);
+        if (symbol->class == FUNC && symbol->value == 0) {
+            add_native(parser, symbol, params);
+        }
+        return;
+    }
+    symbol->class = FUNC; // 原生函数的同名定义：此前的调用点均为待链接的调用，链接时填入定义的入口
+    reserve_text(parser);
     int64_t *entry = parser->text + 1; // 函数入口地址
-    if (strcmp("main", name) == 0) {
+    const int is_main = strcmp("main", name) == 0;
+    if (is_main) {
         parser->main_entry = entry; // 记录 main 函数入口，vm 初始运行时 pc 将指向此地址
     }
-    check_symbol(parser->g_symbols, parser->g_size, token, hash);
-    parser->g_symbols[parser->g_size++] = (Symbol){hash, name, datatype, FUNC, (int64_t) entry};
+    symbol->datatype = datatype;
+    symbol->value = (int64_t) entry;
     advance(parser);
+    Function *fn = add_function(parser, t_start, symbol - parser->g_symbols, entry);
+    if (parser->lazy && !is_main) {
+        // 延迟编译：生成桩指令，跳过参数列表和函数体
+        *++parser->text = LZY;
+        *++parser->text = (int64_t) (parser->f_size - 1);
+        skip_balanced(parser, TK_LEFT_PAREN, TK_RIGHT_PAREN);
+        assert(parser, TK_LEFT_BRACE);
+        skip_balanced(parser, TK_LEFT_BRACE, TK_RIGHT_BRACE);
+        fn->t_end = parser->t_index;
+        return;
+    }
+    if (parser->watch) {
+        // 热重载：函数入口为跳转桩，重新编译后修改跳转目标，已生成的调用点无需修改
+        *++parser->text = JMP;
+        ++parser->text;
+        *parser->text = (int64_t) (parser->text + 1);
+        add_reloc(parser, parser->text, RELOC_TEXT);
+    }
+    fn->entry = parser->text + 1;
     // 解析参数，返回 bp 在栈中的相对位置
     const int bp_index = parse_function_params(parser);
+    fn->params = bp_index - 1;
     // 解析函数体
     parse_function_body(parser, bp_index);
     // 函数解析完毕后，重置局部符号表
-    parser->l_size = 0;
+    scope_reset(parser);
+    fn->t_end = parser->t_index;
+}
+
+/**
+ * @brief 添加函数到函数表
+ * @param parser 语法分析器（当前词法单元为参数列表的 '('）
+ * @param t_start 函数定义首个词法单元的索引
+ * @param symbol 函数符号在全局符号表中的索引
+ * @param stub 函数符号指向的地址
+ * @return 函数表条目
+ */
+Function *add_function(Parser *parser, const size_t t_start, const size_t symbol, int64_t *stub) {
+    if (parser->f_size == parser->f_capacity) {
+        parser->f_capacity = parser->f_capacity * 2;
+        Function *functions = realloc(parser->functions, sizeof(Function) * parser->f_capacity);
+        if (functions == NULL) {
+            fail("functions: realloc memory failed\n");
+        }
+        parser->functions = functions;
+    }
+    Function *fn = parser->functions + parser->f_size++;
+    *fn = (Function){t_start, parser->t_index, parser->t_index, parser->g_size, symbol, stub, NULL, -1};
+    return fn;
+}
+
+/**
+ * @brief 判断函数定义是否为声明（原型）
+ * @param parser 语法分析器（当前词法单元为函数名）
+ * @return 1:声明 0:定义
+ */
+int is_prototype(const Parser *parser) {
+    int depth = 0;
+    size_t i = parser->t_index + 1;
+    do {
+        if (!has_token(parser, i)) {
+            return 0;
+        }
+        const TokenKind kind = peek(parser, i++);
+        depth += kind == TK_LEFT_PAREN ? 1 : kind == TK_RIGHT_PAREN ? -1 : 0;
+    } while (depth > 0);
+    return has_token(parser, i) && peek(parser, i) == TK_SEMICOLON;
+}
+
+/**
+ * @brief 记录待链接的调用
+ * @param parser 语法分析器
+ * @param slot JSR 操作数的位置
+ * @param name 函数名
+ */
+void add_fixup(Parser *parser, const int64_t *slot, const char *name) {
+    if (parser->fx_size == parser->fx_capacity) {
+        parser->fx_capacity = parser->fx_capacity * 2;
+        Fixup *fixups = realloc(parser->fixups, sizeof(Fixup) * parser->fx_capacity);
+        if (fixups == NULL) {
+            fail("fixups: realloc memory failed\n");
+        }
+        parser->fixups = fixups;
+    }
+    parser->fixups[parser->fx_size++] = (Fixup){(uint32_t) (slot - parser->o_text), name};
+}
+
+/**
+ * @brief 统计函数声明的参数个数：() 及 (void) 为 0 个
+ * @param parser 语法分析器（当前词法单元为参数列表的 '('）
+ * @return 参数个数
+ */
+int count_params(const Parser *parser) {
+    size_t i = parser->t_index + 1;
+    TokenKind kind = peek(parser, i);
+    if (kind == TK_RIGHT_PAREN || (kind == TK_VOID && peek(parser, i + 1) == TK_RIGHT_PAREN)) {
+        return 0;
+    }
+    int params = 1, depth = 1;
+    while (has_token(parser, i) && depth > 0) {
+        kind = peek(parser, i++);
+        depth += kind == TK_LEFT_PAREN ? 1 : kind == TK_RIGHT_PAREN ? -1 : 0;
+        params += depth == 1 && kind == TK_COMMA;
+    }
+    return params;
+}
+
+/**
+ * @brief 将仅有声明的函数绑定到同名的原生函数（编译时由 dlsym 解析）
+ * @details 数据段中保存 Native（函数地址、返回值宽度、参数个数及函数名），代码段中生成函数桩 IMM native; NATV，
+ *          函数符号指向函数桩；调用点仍记录为待链接的调用，程序中有同名定义时链接到定义
+ * @param parser 语法分析器
+ * @param symbol 仅有声明的函数符号
+ * @param params 声明的参数个数
+ */
+void add_native(Parser *parser, Symbol *symbol, const int params) {
+    void *fn = native_lookup(symbol->name);
+    if (fn == NULL) {
+        return; // 不是已加载的函数：由其它编译单元定义，或在链接时报告未定义
+    }
+    const size_t length = strlen(symbol->name);
+    const size_t size = (sizeof(Native) + length + 1 + 7) & ~(size_t) 7; // 此后的全局变量仍按 8 字节对齐
+    parser->data = (char *) (((int64_t) parser->data + 7) & ~(int64_t) 7); // 函数地址需原子地读写
+    reserve_data(parser, size);
+    Native *native = (Native *) parser->data;
+    native->fn = (int64_t) fn;
+    native->epoch = native_epoch();
+    native->width = symbol->datatype >= PTR ? sizeof(int64_t) : symbol->datatype == INT ? sizeof(int) : sizeof(char);
+    native->params = params;
+    memcpy(native->name, symbol->name, length + 1);
+    parser->data += size;
+    reserve_text(parser);
+    symbol->class = NATIVE;
+    symbol->value = (int64_t) (parser->text + 1);
+    *++parser->text = IMM;
+    *++parser->text = (int64_t) native;
+    add_reloc(parser, parser->text, RELOC_DATA);
+    *++parser->text = NATV;
+}
+
+/**
+ * @brief 按函数当前的词法单元范围编译函数体
+ * @param parser 语法分析器
+ * @param index 函数索引
+ * @return 函数体入口
+ */
+int64_t *parser_compile_function(Parser *parser, const size_t index) {
+    Function *fn = parser->functions + index;
+    const size_t t_index = parser->t_index, line = parser->line, g_size = parser->g_size;
+    parser->t_index = fn->t_index;
+    parser->line = line_at(parser, fn->t_index);
+    parser->g_size = fn->g_size;
+    fn->entry = parser->text + 1;
+    add_line(parser);
+    const int bp_index = parse_function_params(parser);
+    fn->params = bp_index - 1;
+    parse_function_body(parser, bp_index);
+    scope_reset(parser);
+    parser->t_index = t_index;
+    parser->line = line;
+    parser->g_size = g_size;
+    return fn->entry;
 }
 
+/**
+ * @brief 编译延迟编译的函数
+ * @param parser 语法分析器
+ * @param index 延迟编译的函数索引
+ * @return 函数入口
+ */
+int64_t *parser_compile_lazy(Parser *parser, const int64_t index) {
+    const Function *fn = parser->functions + index;
+    if (fn->entry != NULL) {
+        return fn->entry;
+    }
+    // 函数符号改为指向函数体，此后编译的调用点（含递归调用）直接调用
+    parser->g_symbols[fn->symbol].value = (int64_t) (parser->text + 1);
+    return parser_compile_function(parser, index);
+}
+
+/**
+ * @brief 跳过括号（含嵌套）
+ * @param parser 语法分析器
+ * @param left 左括号
+ * @param right 右括号
+ */
+void skip_balanced(Parser *parser, const TokenKind left, const TokenKind right) {
+    int depth = 0;
+    do {
+        if (!has_token(parser, parser->t_index)) {
+            fail("line:%ld, unbalanced brackets\n", parser->line);
+        }
+        const TokenKind kind = peek(parser, parser->t_index);
+        depth += kind == left ? 1 : kind == right ? -1 : 0;
+        advance(parser);
+    } while (depth > 0);
+}
 
 /**
  * @brief 解析函数参数
@@ -431,24 +1141,20 @@ void parse_function(Parser *parser, const int datatype) {
  */
 int parse_function_params(Parser *parser) {
     int i = 0; // 参数个数
-    const Token *token = consume(parser, TK_LEFT_PAREN);
-    while (token->kind != TK_RIGHT_PAREN) {
-        const int base_type = get_basetype(token); // 参数类型
+    TokenKind kind = consume(parser, TK_LEFT_PAREN);
+    while (kind != TK_RIGHT_PAREN) {
+        const int base_type = get_basetype(parser); // 参数类型
         const int data_type = get_datatype(parser, base_type);
-        token = peek(parser, parser->t_index); // 参数名
-        assert(TK_ID, token);
-        const char *name = token->lexeme;
-        const int hash = hash_string(name);
-        check_symbol(parser->l_symbols, parser->l_size, token, hash);
-        parser->l_symbols[parser->l_size++] = (Symbol){hash, name, data_type, LOCAL, i};
+        assert(parser, TK_ID); // 参数名
+        const char *name = name_at(parser, parser->t_index);
+        add_symbol_l(parser, name, data_type, i);
         ++i;
 
-        token = advance(parser);
-        if (token->kind == TK_COMMA) {
-            token = advance(parser);
-            if (token->kind == TK_RIGHT_PAREN) {
-                printf("line:%ld bad symbol %s\n", token->line, token->lexeme);
-                exit(-1); // 语法异常：逗号之后无参数
+        kind = advance(parser);
+        if (kind == TK_COMMA) {
+            kind = advance(parser);
+            if (kind == TK_RIGHT_PAREN) {
+                fail("line:%ld bad symbol )\n", line_at(parser, parser->t_index)); // 语法异常：逗号之后无参数
             }
         }
     }
@@ -462,38 +1168,48 @@ int parse_function_params(Parser *parser) {
  * @param bp_index bp 相对索引位置
  */
 void parse_function_body(Parser *parser, const int bp_index) {
-    int i = bp_index; // 本地变量声明序号，用以计算栈帧大小
-    const Token *token = consume(parser, TK_LEFT_BRACE);
+    parser->l_index = bp_index;
+    consume(parser, TK_LEFT_BRACE);
     // 1. 解析本地变量
-    while (token->kind == TK_INT || token->kind == TK_CHAR) {
-        const int base_type = get_basetype(token);
-        while (token->kind != TK_SEMICOLON) {
-            const int data_type = get_datatype(parser, base_type);
-            token = peek(parser, parser->t_index);
-            assert(TK_ID, token);
-            const char *name = token->lexeme;
-            const int hash = hash_string(name);
-            check_symbol(parser->l_symbols, parser->l_size, token, hash);
-            parser->l_symbols[parser->l_size++] = (Symbol){hash, name, data_type, LOCAL, ++i};
-            token = advance(parser);
-            if (token->kind != TK_COMMA && token->kind != TK_SEMICOLON) {
-                printf("line:%ld, bad variable declaration:%d\n", token->line, token->kind);
-                exit(-1);
-            }
-        }
-        token = consume(parser, TK_SEMICOLON);
-    }
+    parse_local_variables(parser);
+    reserve_text(parser);
     *++parser->text = ENT;
-    *++parser->text = i - bp_index; // 计算得到本地变量个数，用以计算栈帧大小
+    int64_t *frame = ++parser->text;
+    *frame = parser->l_index - bp_index; // 本地变量个数，用以计算栈帧大小
     // 2. 解析语句
-    while (token->kind != TK_RIGHT_BRACE) {
+    TokenKind kind = peek(parser, parser->t_index);
+    while (kind != TK_RIGHT_BRACE) {
         parse_stmt(parser, bp_index);
-        token = peek(parser, parser->t_index);
+        kind = peek(parser, parser->t_index);
     }
     consume(parser, TK_RIGHT_BRACE);
+    *frame = parser->l_index - bp_index; // 加上语句块中声明的变量
+    reserve_text(parser);
     *++parser->text = LEV;
 }
 
+/**
+ * @brief 解析函数体或语句块开头的本地变量声明，变量依次分配栈帧中的槽位
+ * @param parser 语法分析器
+ */
+void parse_local_variables(Parser *parser) {
+    TokenKind kind = peek(parser, parser->t_index);
+    while (kind == TK_INT || kind == TK_CHAR) {
+        const int base_type = get_basetype(parser);
+        while (kind != TK_SEMICOLON) {
+            const int data_type = get_datatype(parser, base_type);
+            assert(parser, TK_ID);
+            const char *name = name_at(parser, parser->t_index);
+            add_symbol_l(parser, name, data_type, ++parser->l_index);
+            kind = advance(parser);
+            if (kind != TK_COMMA && kind != TK_SEMICOLON) {
+                fail("line:%ld, bad variable declaration:%d\n", line_at(parser, parser->t_index), kind);
+            }
+        }
+        kind = consume(parser, TK_SEMICOLON);
+    }
+}
+
 
 /**
  * @brief 语句解析
@@ -501,23 +1217,27 @@ void parse_function_body(Parser *parser, const int bp_index) {
  * @param bp_index bp 相对索引位置
  */
 void parse_stmt(Parser *parser, const int bp_index) {
-    const Token *tk = peek(parser, parser->t_index);
+    reserve_text(parser);
+    TokenKind kind = peek(parser, parser->t_index);
     // if 语句
-    if (tk->kind == TK_IF) {
+    if (kind == TK_IF) {
         advance(parser);
         consume(parser, TK_LEFT_PAREN);
-        parse_expr(parser, TK_ASSIGN, bp_index); // parse condition
+        parse_expr(parser, PREC_ASSIGN, bp_index); // parse condition
         consume(parser, TK_RIGHT_PAREN);
         *++parser->text = JZ; // 如果条件为零，跳转到下一语句，否则跳转到指定分支
         int64_t *branch = ++parser->text; // 保存跳转位置
+        add_reloc(parser, branch, RELOC_TEXT);
 
         parse_stmt(parser, bp_index);
-        tk = peek(parser, parser->t_index);
-        if (tk->kind == TK_ELSE) {
+        kind = peek(parser, parser->t_index);
+        if (kind == TK_ELSE) {
             advance(parser);
+            reserve_text(parser); // 嵌套的语句返回后仍会生成指令，需再次检查
             *branch = (int64_t) (parser->text + 3);
             *++parser->text = JMP;
             branch = ++parser->text;
+            add_reloc(parser, branch, RELOC_TEXT);
             parse_stmt(parser, bp_index);
         }
 
@@ -525,127 +1245,119 @@ void parse_stmt(Parser *parser, const int bp_index) {
         return;
     }
     // while 语句
-    if (tk->kind == TK_WHILE) {
+    if (kind == TK_WHILE) {
         advance(parser);
 
         int64_t *a = parser->text + 1; // 条件判断语句所在地址
 
         consume(parser, TK_LEFT_PAREN);
-        parse_expr(parser, TK_ASSIGN, bp_index);
+        parse_expr(parser, PREC_ASSIGN, bp_index);
         consume(parser, TK_RIGHT_PAREN);
 
         *++parser->text = JZ;
         int64_t *branch = ++parser->text;
+        add_reloc(parser, branch, RELOC_TEXT);
 
         parse_stmt(parser, bp_index);
 
+        reserve_text(parser);
         *++parser->text = JMP;
         *++parser->text = (int64_t) a;
+        add_reloc(parser, parser->text, RELOC_TEXT);
         *branch = (int64_t) (parser->text + 1);
         return;
     }
     // return 语句
-    if (tk->kind == TK_RETURN) {
-        tk = advance(parser);
-        if (tk->kind != TK_SEMICOLON) {
-            parse_expr(parser, TK_ASSIGN, bp_index);
+    if (kind == TK_RETURN) {
+        kind = advance(parser);
+        if (kind != TK_SEMICOLON) {
+            parse_expr(parser, PREC_ASSIGN, bp_index);
         }
         consume(parser, TK_SEMICOLON);
         *++parser->text = LEV;
         return;
     }
-    // 语句块  { ... }
-    if (tk->kind == TK_LEFT_BRACE) {
-        tk = advance(parser);
-        while (tk->kind != TK_RIGHT_BRACE) {
+    // 语句块  { ... }：开头可以声明本地变量，作用域为该语句块
+    if (kind == TK_LEFT_BRACE) {
+        advance(parser);
+        scope_enter(parser);
+        parse_local_variables(parser);
+        kind = peek(parser, parser->t_index);
+        while (kind != TK_RIGHT_BRACE) {
             parse_stmt(parser, bp_index);
-            tk = peek(parser, parser->t_index);
+            kind = peek(parser, parser->t_index);
         }
         consume(parser, TK_RIGHT_BRACE);
+        scope_exit(parser);
         return;
     }
     // 空语句  ;
-    if (tk->kind == TK_SEMICOLON) {
+    if (kind == TK_SEMICOLON) {
         advance(parser);
         return;
     }
     // 表达式  a=b
-    parse_expr(parser, TK_ASSIGN, bp_index);
+    parse_expr(parser, PREC_ASSIGN, bp_index);
     consume(parser, TK_SEMICOLON);
 }
 
 
 /**
  * @brief 表达式解析
- * @details 爬山法（Precedence Climbing）
+ * @details Pratt 解析：先解析一元表达式，再按运算符表逐个处理优先级不低于 level 的二元运算符
  * @param parser 语法分析器
- * @param level 运算符优先级
+ * @param level 运算符优先级（PREC_*）
  * @param bp_index bp相对索引
  */
 void parse_expr(Parser *parser, const int level, const int bp_index) {
-    const Token *token = peek(parser, parser->t_index);
+    reserve_text(parser);
+    TokenKind kind = peek(parser, parser->t_index);
 
     // 一元表达式
-    if (token->kind == TK_NUMBER) {
-        const int64_t tk_val = to_integer(token->lexeme);
+    if (kind == TK_NUMBER) {
+        const int64_t tk_val = value_at(parser, parser->t_index);
         advance(parser);
         *++parser->text = IMM;
         *++parser->text = tk_val;
         parser->expr_type = INT;
-    } else if (token->kind == TK_STRING) {
-        const int64_t index = (int64_t) parser->data; // 获取字符串存储的起始指针
-        const char *lexeme = token->lexeme;
+    } else if (kind == TK_STRING) {
+        size_t length;
+        const char *lexeme = lexeme_at(parser, parser->t_index, &length);
         advance(parser);
-        // 复制字符串到 data
-        while (*lexeme != 0) {
-            if (*lexeme == '\\') {
-                if (*++lexeme == 'n') {
-                    // 仅处理换行符\n，忽略其他转义符，以便 printf 输出时可以实现换行
-                    *parser->data++ = '\n';
-                    *lexeme++;
-                } else {
-                    *parser->data++ = '\\';
-                    *parser->data++ = *lexeme++;
-                }
-            } else {
-                *parser->data++ = *lexeme++;
-            }
-        }
         *++parser->text = IMM;
-        *++parser->text = index; // 保存字符串的指针地址
-        // 字节对齐到 int64，最大间距为 8 byte（两个字符串之间为初始值 0，所以可以自动分割）
-        parser->data = (char *) ((int64_t) parser->data + sizeof(int64_t) & -sizeof(int64_t));
+        *++parser->text = 0;
+        ref_string(parser, parser->text, intern_string(parser, lexeme, length)); // 字符串的地址（布局时填入）
+        add_reloc(parser, parser->text, RELOC_DATA);
         parser->expr_type = PTR;
-    } else if (token->kind == TK_SIZEOF) {
+    } else if (kind == TK_SIZEOF) {
         advance(parser);
-        token = consume(parser, TK_LEFT_PAREN);
-        const int basetype = get_basetype(token);
+        consume(parser, TK_LEFT_PAREN);
+        const int basetype = get_basetype(parser);
         parser->expr_type = get_datatype(parser, basetype);
         consume(parser, TK_RIGHT_PAREN);
         *++parser->text = IMM;
         *++parser->text = parser->expr_type == CHAR ? sizeof(char) : sizeof(int64_t);
         parser->expr_type = INT;
-    } else if (token->kind == TK_ID) {
-        const Token *id = token;
-        const int hash = hash_string(id->lexeme);
-        token = advance(parser);
-        if (token->kind == TK_LEFT_PAREN) {
+    } else if (kind == TK_ID) {
+        const size_t id = parser->t_index;
+        const char *name = name_at(parser, id);
+        kind = advance(parser);
+        if (kind == TK_LEFT_PAREN) {
             // 函数：仅查找全局符号表
-            const Symbol *symbol = find_symbol(parser->g_symbols, parser->g_size, id, hash);
+            const Symbol *symbol = find_symbol_g(parser, name);
             if (symbol == NULL) {
-                printf("line:%ld, undefined function %s\n", id->line, id->lexeme);
-                exit(-1);
+                fail("line:%ld, undefined function %s\n", line_at(parser, id), name);
             }
-            token = advance(parser);
+            kind = advance(parser);
             // 函数：参数处理
             int64_t args_num = 0; // 参数个数
-            while (token->kind != TK_RIGHT_PAREN) {
-                parse_expr(parser, TK_ASSIGN, bp_index);
+            while (kind != TK_RIGHT_PAREN) {
+                parse_expr(parser, PREC_ASSIGN, bp_index);
                 *++parser->text = PUSH; // 参数入栈
                 args_num++;
-                token = peek(parser, parser->t_index);
-                if (token->kind == TK_COMMA) {
-                    token = advance(parser);
+                kind = peek(parser, parser->t_index);
+                if (kind == TK_COMMA) {
+                    kind = advance(parser);
                 }
             }
             consume(parser, TK_RIGHT_PAREN);
@@ -658,6 +1370,10 @@ void parse_expr(Parser *parser, const int level, const int bp_index) {
                 // function call
                 *++parser->text = JSR;
                 *++parser->text = symbol->value;
+                add_reloc(parser, parser->text, RELOC_TEXT);
+                if (symbol->value == 0 || symbol->class == NATIVE) {
+                    add_fixup(parser, parser->text, symbol->name); // 仅有声明：链接时填入函数入口
+                }
             }
             // 参数出栈
             if (args_num > 0) {
@@ -667,16 +1383,24 @@ void parse_expr(Parser *parser, const int level, const int bp_index) {
             parser->expr_type = symbol->datatype;
         } else {
             // 先查找本地符号表，后查找全局符号表
-            const Symbol *symbol = find_symbol_g_l(parser, id, hash);
+            const Symbol *symbol = find_symbol_g_l(parser, name);
             if (symbol == NULL) {
-                printf("line:%ld, undefined variable %s\n", id->line, id->lexeme);
-                exit(-1);
+                fail("line:%ld, undefined variable %s\n", line_at(parser, id), name);
             }
             if (symbol->class == ENUM) {
                 // 枚举常量，直接取数值
                 *++parser->text = IMM;
                 *++parser->text = symbol->value;
                 parser->expr_type = INT;
+            } else if (symbol->class == FUNC || symbol->class == NATIVE) {
+                // 函数名（其后无括号）：取函数入口地址，如作为 thread_create 的参数
+                *++parser->text = IMM;
+                *++parser->text = symbol->value;
+                add_reloc(parser, parser->text, RELOC_TEXT);
+                if (symbol->value == 0 || symbol->class == NATIVE) {
+                    add_fixup(parser, parser->text, symbol->name); // 仅有声明：链接时填入函数入口
+                }
+                parser->expr_type = INT;
             } else {
                 // 变量，先将指针存入 rax，然后根据类型取值并存入 rax
                 if (symbol->class == LOCAL) {
@@ -685,94 +1409,92 @@ void parse_expr(Parser *parser, const int level, const int bp_index) {
                 } else if (symbol->class == GLOBAL) {
                     *++parser->text = IMM;
                     *++parser->text = symbol->value;
+                    add_reloc(parser, parser->text, RELOC_DATA);
                 } else {
-                    printf("%ld: undefined variable\n", token->line);
-                    exit(-1);
+                    fail("%ld: undefined variable\n", line_at(parser, parser->t_index));
                 }
                 parser->expr_type = symbol->datatype;
                 *++parser->text = parser->expr_type == CHAR ? LC : LI;
             }
         }
-    } else if (token->kind == TK_LEFT_PAREN) {
-        token = advance(parser);
-        if (token->kind == TK_INT || token->kind == TK_CHAR) {
+    } else if (kind == TK_LEFT_PAREN) {
+        kind = advance(parser);
+        if (kind == TK_INT || kind == TK_CHAR) {
             // 类型转换
-            const int basetype = get_basetype(token);
+            const int basetype = get_basetype(parser);
             const int datatype = get_datatype(parser, basetype);
             consume(parser, TK_RIGHT_PAREN);
-            parse_expr(parser, TK_INC, bp_index);
+            parse_expr(parser, PREC_POSTFIX, bp_index);
             parser->expr_type = datatype;
         } else {
             // 正常表达式
-            parse_expr(parser, TK_ASSIGN, bp_index);
+            parse_expr(parser, PREC_ASSIGN, bp_index);
             consume(parser, TK_RIGHT_PAREN);
         }
-    } else if (token->kind == TK_STAR) {
+    } else if (kind == TK_STAR) {
         // 解引用 *addr
         advance(parser);
-        parse_expr(parser, TK_INC, bp_index);
+        parse_expr(parser, PREC_POSTFIX, bp_index);
         if (parser->expr_type >= PTR) {
             parser->expr_type -= PTR;
         } else {
-            token = peek(parser, parser->t_index);
-            printf("%ld: bad dereference\n", token->line);
-            exit(-1);
+            kind = peek(parser, parser->t_index);
+            fail("%ld: bad dereference\n", line_at(parser, parser->t_index));
         }
         *++parser->text = parser->expr_type == CHAR ? LC : LI;
-    } else if (token->kind == TK_AND) {
+    } else if (kind == TK_AND) {
         // 取址 &var
-        token = advance(parser);
-        parse_expr(parser, TK_INC, bp_index);
+        kind = advance(parser);
+        parse_expr(parser, PREC_POSTFIX, bp_index);
         if (*parser->text == LC || *parser->text == LI) {
             parser->text--;
         } else {
-            printf("%ld: bad address of\n", token->line);
-            exit(-1);
+            fail("%ld: bad address of\n", line_at(parser, parser->t_index));
         }
         parser->expr_type += PTR;
-    } else if (token->kind == TK_NOT) {
+    } else if (kind == TK_NOT) {
         // 逻辑非 !var
         advance(parser);
-        parse_expr(parser, TK_INC, bp_index);
+        parse_expr(parser, PREC_POSTFIX, bp_index);
         *++parser->text = PUSH;
         *++parser->text = IMM;
         *++parser->text = 0;
         *++parser->text = EQ;
         parser->expr_type = INT;
-    } else if (token->kind == TK_TILDE) {
+    } else if (kind == TK_TILDE) {
         // 位非 ~var
         advance(parser);
-        parse_expr(parser, TK_INC, bp_index);
+        parse_expr(parser, PREC_POSTFIX, bp_index);
         *++parser->text = PUSH;
         *++parser->text = IMM;
         *++parser->text = -1;
         *++parser->text = XOR;
         parser->expr_type = INT;
-    } else if (token->kind == TK_PLUS) {
+    } else if (kind == TK_PLUS) {
         // 正号 +var
         advance(parser);
-        parse_expr(parser, TK_INC, bp_index);
+        parse_expr(parser, PREC_POSTFIX, bp_index);
         parser->expr_type = INT;
-    } else if (token->kind == TK_MINUS) {
+    } else if (kind == TK_MINUS) {
         // 负号 -var
-        token = advance(parser);
-        if (token->kind == TK_NUMBER) {
+        kind = advance(parser);
+        if (kind == TK_NUMBER) {
             *++parser->text = IMM;
-            *++parser->text = -to_integer(token->lexeme);
+            *++parser->text = -value_at(parser, parser->t_index);
             advance(parser);
         } else {
             *++parser->text = IMM;
             *++parser->text = -1;
             *++parser->text = PUSH;
-            parse_expr(parser, TK_INC, bp_index);
+            parse_expr(parser, PREC_POSTFIX, bp_index);
             *++parser->text = MUL;
         }
         parser->expr_type = INT;
-    } else if (token->kind == TK_INC || token->kind == TK_DEC) {
+    } else if (kind == TK_INC || kind == TK_DEC) {
         // 递增递减（前缀形式） ++var 或 --var
-        const int kind = token->kind;
-        token = advance(parser);
-        parse_expr(parser, TK_INC, bp_index);
+        const TokenKind op = kind;
+        advance(parser);
+        parse_expr(parser, PREC_POSTFIX, bp_index);
         // 1.先将 rax 中的地址入栈
         // 2.从地址中取值存入 rax
         if (*parser->text == LC) {
@@ -782,259 +1504,426 @@ void parse_expr(Parser *parser, const int level, const int bp_index) {
             *parser->text = PUSH;
             *++parser->text = LI;
         } else {
-            printf("%ld: bad lvalue of pre-increment\n", token->line);
-            exit(-1);
+            fail("%ld: bad lvalue of pre-increment\n", line_at(parser, parser->t_index));
         }
         *++parser->text = PUSH; // 3.将 rax 中的值入栈
         *++parser->text = IMM; // 4.根据数据类型计算需要增加的数值，sizeof(int64_t) 或 sizeof(char) 存入 rax
         *++parser->text = parser->expr_type > PTR ? sizeof(int64_t) : sizeof(char);
-        *++parser->text = kind == TK_INC ? ADD : SUB; // 5.执行加法或减法运算，并将结果存入 rax
+        *++parser->text = op == TK_INC ? ADD : SUB; // 5.执行加法或减法运算，并将结果存入 rax
         *++parser->text = parser->expr_type == CHAR ? SC : SI; // 6.将 rax 中的计算结果存入流程1中入栈的内存地址
     } else {
-        printf("line:%ld: bad expression\n", token->line);
-        exit(-1);
+        fail("line:%ld: bad expression\n", line_at(parser, parser->t_index));
     }
 
-    const int tmp = parser->expr_type;
-    // 二元表达式
+    // 二元表达式（含后缀运算符）：查表取得运算符的优先级，优先级不低于 level 时继续解析
     while (1) {
-        token = peek(parser, parser->t_index);
-        if (token->kind < level) {
-            return;
+        reserve_text(parser); // 一元表达式及上一运算符的指令已生成
+        const Operator *op = OPERATORS + peek(parser, parser->t_index);
+        if (op->precedence < level) {
+            return; // 不是运算符（优先级为 0）或优先级较低，由外层解析
         }
-        // 根据运算符的优先级，进行递归解析
-        if (token->kind == TK_ASSIGN) {
-            // 赋值表达式 var = expr;
-            token = advance(parser);
-            if (*parser->text == LC || *parser->text == LI) {
-                *parser->text = PUSH; // save the lvalue's pointer
-            } else {
-                printf("%ld: bad lvalue in assignment\n", token->line);
-                exit(-1);
-            }
-            parse_expr(parser, TK_ASSIGN, bp_index);
+        op->emit(parser, op, parser->expr_type, bp_index);
+    }
+}
 
-            parser->expr_type = tmp;
-            *++parser->text = parser->expr_type == CHAR ? SC : SI;
-        } else if (token->kind == TK_CONDITION) {
-            // 条件表达式 expr ? a : b;
-            advance(parser);
-            *++parser->text = JZ;
-            int64_t *addr = ++parser->text;
-            parse_expr(parser, TK_ASSIGN, bp_index);
-            token = peek(parser, parser->t_index);
-            if (token->kind == TK_COLON) {
-                advance(parser);
-            } else {
-                printf("%ld: missing colon in conditional\n", token->line);
-                exit(-1);
-            }
-            *addr = (int64_t) (parser->text + 3);
-            *++parser->text = JMP;
-            addr = ++parser->text;
-            parse_expr(parser, TK_CONDITION, bp_index);
-            *addr = (int64_t) (parser->text + 1);
-        } else if (token->kind == TK_LOR) {
-            // 逻辑或
-            advance(parser);
-            *++parser->text = JNZ;
-            int64_t *addr = ++parser->text;
-            parse_expr(parser, TK_LAND, bp_index);
-            *addr = (int64_t) (parser->text + 1);
-            parser->expr_type = INT;
-        } else if (token->kind == TK_LAND) {
-            // 逻辑与
-            advance(parser);
-            *++parser->text = JZ;
-            int64_t *addr = ++parser->text;
-            parse_expr(parser, TK_OR, bp_index);
-            *addr = (int64_t) (parser->text + 1);
-            parser->expr_type = INT;
-        } else if (token->kind == TK_OR) {
-            // 位或
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_XOR, bp_index);
-            *++parser->text = OR;
-            parser->expr_type = INT;
-        } else if (token->kind == TK_XOR) {
-            // 位异或
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_AND, bp_index);
-            *++parser->text = XOR;
-            parser->expr_type = INT;
-        } else if (token->kind == TK_AND) {
-            // 位与
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_EQUAL, bp_index);
-            *++parser->text = AND;
-            parser->expr_type = INT;
-        } else if (token->kind == TK_EQUAL) {
-            // 等于
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_NE, bp_index);
-            *++parser->text = EQ;
-            parser->expr_type = INT;
-        } else if (token->kind == TK_NE) {
-            // 不等于
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_LT, bp_index);
-            *++parser->text = NE;
-            parser->expr_type = INT;
-        } else if (token->kind == TK_LT) {
-            // 小于
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_SHL, bp_index);
-            *++parser->text = LT;
-            parser->expr_type = INT;
-        } else if (token->kind == TK_GT) {
-            // 大于
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_SHL, bp_index);
-            *++parser->text = GT;
-            parser->expr_type = INT;
-        } else if (token->kind == TK_LE) {
-            // 小于等于
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_SHL, bp_index);
-            *++parser->text = LE;
-            parser->expr_type = INT;
-        } else if (token->kind == TK_GE) {
-            // 大于等于
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_SHL, bp_index);
-            *++parser->text = GE;
-            parser->expr_type = INT;
-        } else if (token->kind == TK_SHL) {
-            // 左位移 var<<x
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_PLUS, bp_index);
-            *++parser->text = SHL;
-            parser->expr_type = INT;
-        } else if (token->kind == TK_SHR) {
-            // 右位移 var>>x
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_PLUS, bp_index);
-            *++parser->text = SHR;
-            parser->expr_type = INT;
-        } else if (token->kind == TK_PLUS) {
-            // 加法
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_STAR, bp_index);
+/**
+ * @brief 右操作数的优先级：左结合时比运算符高一级，右结合时与运算符相同
+ * @param op 运算符
+ * @return 优先级
+ */
+int operand_level(const Operator *op) {
+    return op->right ? op->precedence : op->precedence + 1;
+}
 
-            parser->expr_type = tmp;
-            if (parser->expr_type > PTR) {
-                // 指针移动
-                *++parser->text = PUSH;
-                *++parser->text = IMM;
-                *++parser->text = sizeof(int64_t);
-                *++parser->text = MUL;
-            }
-            *++parser->text = ADD;
-        } else if (token->kind == TK_MINUS) {
-            // 减法
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_STAR, bp_index);
-            if (tmp > PTR && tmp == parser->expr_type) {
-                // 指针相减
-                *++parser->text = SUB;
-                *++parser->text = PUSH;
-                *++parser->text = IMM;
-                *++parser->text = sizeof(int64_t);
-                *++parser->text = DIV;
-                parser->expr_type = INT;
-            } else if (tmp > PTR) {
-                // 指针移动
-                *++parser->text = PUSH;
-                *++parser->text = IMM;
-                *++parser->text = sizeof(int64_t);
-                *++parser->text = MUL;
-                *++parser->text = SUB;
-                parser->expr_type = tmp;
-            } else {
-                // 数值相减
-                *++parser->text = SUB;
-                parser->expr_type = tmp;
-            }
-        } else if (token->kind == TK_STAR) {
-            // 乘法
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_INC, bp_index);
-            *++parser->text = MUL;
-            parser->expr_type = tmp;
-        } else if (token->kind == TK_SLASH) {
-            // 除法
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_INC, bp_index);
-            *++parser->text = DIV;
-            parser->expr_type = tmp;
-        } else if (token->kind == TK_MOD) {
-            // 求余
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_INC, bp_index);
-            *++parser->text = MOD;
-            parser->expr_type = tmp;
-        } else if (token->kind == TK_INC || token->kind == TK_DEC) {
-            // 递增递减（后缀形式） var++ 或 var--
-            if (*parser->text == LI) {
-                *parser->text = PUSH;
-                *++parser->text = LI;
-            } else if (*parser->text == LC) {
-                *parser->text = PUSH;
-                *++parser->text = LC;
+/**
+ * @brief 赋值 var = expr：左值的地址入栈，按左值类型存储
+ * @param parser 语法分析器
+ * @param op 运算符
+ * @param type 左操作数类型
+ * @param bp_index bp相对索引
+ */
+void emit_assign(Parser *parser, const Operator *op, const int type, const int bp_index) {
+    advance(parser);
+    if (*parser->text == LC || *parser->text == LI) {
+        *parser->text = PUSH; // save the lvalue's pointer
+    } else {
+        fail("%ld: bad lvalue in assignment\n", line_at(parser, parser->t_index));
+    }
+    parse_expr(parser, operand_level(op), bp_index);
+    parser->expr_type = type;
+    *++parser->text = parser->expr_type == CHAR ? SC : SI;
+}
+
+/**
+ * @brief 条件表达式 expr ? a : b
+ * @param parser 语法分析器
+ * @param op 运算符
+ * @param type 左操作数类型
+ * @param bp_index bp相对索引
+ */
+void emit_condition(Parser *parser, const Operator *op, const int type, const int bp_index) {
+    (void) type;
+    advance(parser);
+    *++parser->text = JZ;
+    int64_t *addr = ++parser->text;
+    add_reloc(parser, addr, RELOC_TEXT);
+    parse_expr(parser, PREC_ASSIGN, bp_index);
+    if (peek(parser, parser->t_index) == TK_COLON) {
+        advance(parser);
+    } else {
+        fail("%ld: missing colon in conditional\n", line_at(parser, parser->t_index));
+    }
+    *addr = (int64_t) (parser->text + 3);
+    *++parser->text = JMP;
+    addr = ++parser->text;
+    add_reloc(parser, addr, RELOC_TEXT);
+    parse_expr(parser, operand_level(op), bp_index);
+    *addr = (int64_t) (parser->text + 1);
+}
+
+/**
+ * @brief 逻辑或、逻辑与（短路求值）：左操作数已能决定结果时跳过右操作数
+ * @param parser 语法分析器
+ * @param op 运算符（opcode 为短路跳转指令：|| 为 JNZ，&& 为 JZ）
+ * @param type 左操作数类型
+ * @param bp_index bp相对索引
+ */
+void emit_logical(Parser *parser, const Operator *op, const int type, const int bp_index) {
+    (void) type;
+    advance(parser);
+    *++parser->text = op->opcode;
+    int64_t *addr = ++parser->text;
+    add_reloc(parser, addr, RELOC_TEXT);
+    parse_expr(parser, operand_level(op), bp_index);
+    *addr = (int64_t) (parser->text + 1);
+    parser->expr_type = INT;
+}
+
+/**
+ * @brief 位运算、比较、位移：左操作数入栈，解析右操作数后执行运算，结果为 int
+ * @param parser 语法分析器
+ * @param op 运算符（opcode 为运算指令）
+ * @param type 左操作数类型
+ * @param bp_index bp相对索引
+ */
+void emit_binary(Parser *parser, const Operator *op, const int type, const int bp_index) {
+    (void) type;
+    advance(parser);
+    *++parser->text = PUSH;
+    parse_expr(parser, operand_level(op), bp_index);
+    *++parser->text = op->opcode;
+    parser->expr_type = INT;
+}
+
+/**
+ * @brief 乘法、除法、求余：结果类型与左操作数相同
+ * @param parser 语法分析器
+ * @param op 运算符（opcode 为运算指令）
+ * @param type 左操作数类型
+ * @param bp_index bp相对索引
+ */
+void emit_multiply(Parser *parser, const Operator *op, const int type, const int bp_index) {
+    advance(parser);
+    *++parser->text = PUSH;
+    parse_expr(parser, operand_level(op), bp_index);
+    *++parser->text = op->opcode;
+    parser->expr_type = type;
+}
+
+/**
+ * @brief 加法：左操作数为指针（非 char *）时右操作数乘以 8
+ * @param parser 语法分析器
+ * @param op 运算符
+ * @param type 左操作数类型
+ * @param bp_index bp相对索引
+ */
+void emit_add(Parser *parser, const Operator *op, const int type, const int bp_index) {
+    advance(parser);
+    *++parser->text = PUSH;
+    parse_expr(parser, operand_level(op), bp_index);
+    parser->expr_type = type;
+    if (parser->expr_type > PTR) {
+        // 指针移动
+        *++parser->text = PUSH;
+        *++parser->text = IMM;
+        *++parser->text = sizeof(int64_t);
+        *++parser->text = MUL;
+    }
+    *++parser->text = ADD;
+}
+
+/**
+ * @brief 减法：指针相减得到元素个数，指针减整数为指针移动，否则为数值相减
+ * @param parser 语法分析器
+ * @param op 运算符
+ * @param type 左操作数类型
+ * @param bp_index bp相对索引
+ */
+void emit_sub(Parser *parser, const Operator *op, const int type, const int bp_index) {
+    advance(parser);
+    *++parser->text = PUSH;
+    parse_expr(parser, operand_level(op), bp_index);
+    if (type > PTR && type == parser->expr_type) {
+        // 指针相减
+        *++parser->text = SUB;
+        *++parser->text = PUSH;
+        *++parser->text = IMM;
+        *++parser->text = sizeof(int64_t);
+        *++parser->text = DIV;
+        parser->expr_type = INT;
+    } else if (type > PTR) {
+        // 指针移动
+        *++parser->text = PUSH;
+        *++parser->text = IMM;
+        *++parser->text = sizeof(int64_t);
+        *++parser->text = MUL;
+        *++parser->text = SUB;
+        parser->expr_type = type;
+    } else {
+        // 数值相减
+        *++parser->text = SUB;
+        parser->expr_type = type;
+    }
+}
+
+/**
+ * @brief 递增递减（后缀形式） var++ 或 var--：先存储计算结果，再恢复原值作为表达式的值
+ * @param parser 语法分析器
+ * @param op 运算符（opcode 为 ADD 或 SUB）
+ * @param type 左操作数类型
+ * @param bp_index bp相对索引
+ */
+void emit_postfix(Parser *parser, const Operator *op, const int type, const int bp_index) {
+    (void) bp_index;
+    if (*parser->text == LI) {
+        *parser->text = PUSH;
+        *++parser->text = LI;
+    } else if (*parser->text == LC) {
+        *parser->text = PUSH;
+        *++parser->text = LC;
+    } else {
+        fail("%ld: bad value in increment\n", line_at(parser, parser->t_index));
+    }
+    *++parser->text = PUSH;
+    *++parser->text = IMM;
+    *++parser->text = type > PTR ? sizeof(int64_t) : sizeof(char);
+    *++parser->text = op->opcode;
+    *++parser->text = type == CHAR ? SC : SI;
+    *++parser->text = PUSH;
+    *++parser->text = IMM;
+    *++parser->text = type > PTR ? sizeof(int64_t) : sizeof(char);
+    *++parser->text = op->opcode == ADD ? SUB : ADD;
+    advance(parser);
+}
+
+/**
+ * @brief 数组下标 a[i]：地址为 a + i * 元素大小，按元素类型取值
+ * @param parser 语法分析器
+ * @param op 运算符
+ * @param type 左操作数类型
+ * @param bp_index bp相对索引
+ */
+void emit_index(Parser *parser, const Operator *op, const int type, const int bp_index) {
+    (void) op;
+    advance(parser);
+    *++parser->text = PUSH;
+    parse_expr(parser, PREC_ASSIGN, bp_index);
+    consume(parser, TK_RIGHT_BRACKET);
+    if (type > PTR) {
+        // pointer, `not char *`
+        *++parser->text = PUSH;
+        *++parser->text = IMM;
+        *++parser->text = sizeof(int64_t);
+        *++parser->text = MUL;
+    } else if (type < PTR) {
+        fail("%ld: pointer type expected\n", line_at(parser, parser->t_index));
+    }
+    parser->expr_type = type - PTR;
+    *++parser->text = ADD;
+    *++parser->text = parser->expr_type == CHAR ? LC : LI;
+}
+
+/**
+ * @brief 字符串常量池扩容
+ * @param parser 语法分析器
+ */
+void resize_strings(Parser *parser) {
+    parser->s_capacity = parser->s_capacity * 2;
+    StringEntry *strings = realloc(parser->strings, sizeof(StringEntry) * parser->s_capacity);
+    if (strings == NULL) {
+        fail("strings: realloc memory failed\n");
+    }
+    parser->strings = strings;
+}
+
+/**
+ * @brief 字符串常量入池：按完整字符串的哈希值在常量池驻留表中查找，相同的字符串只保留一个条目
+ * @details 转义符在数据段的空闲位置处理（转义后不会变长），驻留后清零，此后数据段仍从原位置开始使用
+ * @param parser 语法分析器
+ * @param lexeme 字符串词素（位于源码中）
+ * @param count 词素长度
+ * @return 字符串常量池条目的索引
+ */
+uint32_t intern_string(Parser *parser, const char *lexeme, const size_t count) {
+    reserve_data(parser, count);
+    char *start = parser->data;
+    char *chars = start;
+    const char *end = lexeme + count;
+    while (lexeme < end) {
+        if (*lexeme == '\\') {
+            if (*++lexeme == 'n') {
+                // 仅处理换行符\n，忽略其他转义符，以便 printf 输出时可以实现换行
+                *chars++ = '\n';
+                lexeme++;
             } else {
-                printf("%ld: bad value in increment\n", token->line);
-                exit(-1);
+                *chars++ = '\\';
+                *chars++ = *lexeme++;
             }
+        } else {
+            *chars++ = *lexeme++;
+        }
+    }
+    const size_t length = chars - start;
+    ++parser->s_count;
+    const uint32_t index = intern_id(&parser->s_interner, start, length, hash_chars(start, length));
+    memset(start, 0, length); // 数据段初始值为 0
+    if (index < parser->s_size) {
+        parser->s_saved += (length + sizeof(int64_t)) & -(int64_t) sizeof(int64_t); // 与已有的字符串相同
+        return index;
+    }
+    if (parser->s_size == parser->s_capacity) {
+        resize_strings(parser);
+    }
+    parser->strings[parser->s_size++] = (StringEntry){parser->s_interner.names[index], length, NULL};
+    return index;
+}
 
-            *++parser->text = PUSH;
-            *++parser->text = IMM;
-            *++parser->text = parser->expr_type > PTR ? sizeof(int64_t) : sizeof(char);
-            *++parser->text = token->kind == TK_INC ? ADD : SUB;
-            *++parser->text = parser->expr_type == CHAR ? SC : SI;
-            *++parser->text = PUSH;
-            *++parser->text = IMM;
-            *++parser->text = parser->expr_type > PTR ? sizeof(int64_t) : sizeof(char);
-            *++parser->text = token->kind == TK_INC ? SUB : ADD;
-            advance(parser);
-        } else if (token->kind == TK_LEFT_BRACKET) {
-            // 数组
-            advance(parser);
-            *++parser->text = PUSH;
-            parse_expr(parser, TK_ASSIGN, bp_index);
-            token = consume(parser, TK_RIGHT_BRACKET);
+/**
+ * @brief 引用字符串常量：常量池已布局时写入地址（尚未写入数据段的新字符串随即写入），否则记录引用
+ * @param parser 语法分析器
+ * @param slot IMM 指令的操作数
+ * @param index 字符串常量池条目的索引
+ */
+void ref_string(Parser *parser, int64_t *slot, const uint32_t index) {
+    StringEntry *entry = parser->strings + index;
+    if (parser->s_laid) {
+        if (entry->addr == NULL) {
+            entry->addr = place_string(parser, entry->chars, entry->length); // 延迟编译或热重载的函数体中的新字符串
+        }
+        *slot = (int64_t) entry->addr;
+        return;
+    }
+    if (parser->sr_size == parser->sr_capacity) {
+        parser->sr_capacity = parser->sr_capacity * 2;
+        StringRef *refs = realloc(parser->s_refs, sizeof(StringRef) * parser->sr_capacity);
+        if (refs == NULL) {
+            fail("strings: realloc memory failed\n");
+        }
+        parser->s_refs = refs;
+    }
+    parser->s_refs[parser->sr_size++] = (StringRef){(uint32_t) (slot - parser->o_text), index};
+}
 
-            if (tmp > PTR) {
-                // pointer, `not char *`
-                *++parser->text = PUSH;
-                *++parser->text = IMM;
-                *++parser->text = sizeof(int64_t);
-                *++parser->text = MUL;
-            } else if (tmp < PTR) {
-                printf("%ld: pointer type expected\n", token->line);
-                exit(-1);
-            }
-            parser->expr_type = tmp - PTR;
-            *++parser->text = ADD;
-            *++parser->text = parser->expr_type == CHAR ? LC : LI;
+/**
+ * @brief 布局字符串常量池（语法分析结束时一次完成）
+ * @details 按逆序的字节排序后，以某字符串的逆序为前缀的字符串排在其后且彼此相邻，
+ * 因此它是其它字符串的后缀当且仅当它是其后继的后缀；从后向前处理，是后继的后缀时共享后继的末尾，
+ * 否则写入数据段，最后填入布局前记录的各引用，并打印布局前生成的指令
+ * @param parser 语法分析器
+ */
+void layout_strings(Parser *parser) {
+    if (parser->s_laid) {
+        return;
+    }
+    parser->s_laid = 1;
+    const size_t size = parser->s_size;
+    StringEntry **sorted = malloc(sizeof(StringEntry *) * (size > 0 ? size : 1));
+    if (sorted == NULL) {
+        fail("strings: malloc memory failed\n");
+    }
+    for (size_t i = 0; i < size; ++i) {
+        sorted[i] = parser->strings + i;
+    }
+    qsort(sorted, size, sizeof(StringEntry *), compare_reversed);
+    for (size_t i = size; i-- > 0;) {
+        StringEntry *entry = sorted[i];
+        const StringEntry *next = i + 1 < size ? sorted[i + 1] : NULL;
+        if (next != NULL && next->length > entry->length &&
+            memcmp(next->chars + next->length - entry->length, entry->chars, entry->length) == 0) {
+            entry->addr = next->addr + next->length - entry->length;
+            parser->s_saved += (entry->length + sizeof(int64_t)) & -(int64_t) sizeof(int64_t);
         } else {
-            printf("%ld: compiler error, token = %d\n", token->line, token->kind);
-            exit(-1);
+            entry->addr = place_string(parser, entry->chars, entry->length);
+        }
+    }
+    free(sorted);
+    for (size_t i = 0; i < parser->sr_size; ++i) {
+        const StringRef *ref = parser->s_refs + i;
+        parser->o_text[ref->offset] = (int64_t) parser->strings[ref->string].addr;
+    }
+    parser->sr_size = 0;
+    for (size_t i = 0; i < parser->li_size; ++i) {
+        print_text(parser, parser->listing[i].line, parser->o_text + parser->listing[i].offset);
+    }
+    parser->li_size = 0;
+}
+
+/**
+ * @brief 将字符串写入数据段
+ * @param parser 语法分析器
+ * @param chars 字符串
+ * @param length 字符串长度
+ * @return 字符串在数据段中的地址
+ */
+const char *place_string(Parser *parser, const char *chars, const size_t length) {
+    reserve_data(parser, length + sizeof(int64_t));
+    char *start = parser->data;
+    memcpy(start, chars, length);
+    // 结尾的 0 占 1 字节后再对齐到 int64（长度为 8 的倍数时也需另加 8 字节），数据段初始值为 0，字符串之间自动分割
+    parser->data = (char *) (((int64_t) start + length + 1 + sizeof(int64_t) - 1) & -(int64_t) sizeof(int64_t));
+    return start;
+}
+
+/**
+ * @brief 按逆序的字节比较两个字符串常量池条目（qsort 的比较函数）：从末尾开始逐字节比较，相同时较短者在前
+ * @param a 条目指针的地址
+ * @param b 条目指针的地址
+ * @return 负数、0、正数
+ */
+int compare_reversed(const void *a, const void *b) {
+    const StringEntry *x = *(StringEntry *const *) a;
+    const StringEntry *y = *(StringEntry *const *) b;
+    const size_t length = x->length < y->length ? x->length : y->length;
+    for (size_t i = 1; i <= length; ++i) {
+        const unsigned char cx = (unsigned char) x->chars[x->length - i];
+        const unsigned char cy = (unsigned char) y->chars[y->length - i];
+        if (cx != cy) {
+            return cx < cy ? -1 : 1;
         }
     }
+    return x->length < y->length ? -1 : x->length > y->length;
+}
+
+/**
+ * @brief 确保代码段在当前位置之后至少还有 TEXT_MARGIN 个空位，不足时提交新的内存块
+ * @details 在语句、表达式及运算符的开头检查，两次检查之间生成的指令数量有上限，无需在每条指令前检查
+ * @param parser 语法分析器
+ */
+void reserve_text(Parser *parser) {
+    const size_t size = (char *) (parser->text + 1 + TEXT_MARGIN) - parser->t_arena.base;
+    if (size > parser->t_arena.size && arena_commit(&parser->t_arena, size) != 0) {
+        fail("line:%ld, code segment overflow (%ld bytes)\n", parser->line, parser->t_arena.capacity);
+    }
+}
+
+/**
+ * @brief 确保数据段在当前位置之后至少还有 size 个空闲字节，不足时提交新的内存块
+ * @param parser 语法分析器
+ * @param size 需要的字节数
+ */
+void reserve_data(Parser *parser, const size_t size) {
+    const size_t end = parser->data + size - parser->d_arena.base;
+    if (end > parser->d_arena.size && arena_commit(&parser->d_arena, end) != 0) {
+        fail("line:%ld, data segment overflow (%ld bytes)\n", parser->line, parser->d_arena.capacity);
+    }
 }
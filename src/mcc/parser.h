@@ -7,7 +7,13 @@
 
 #include <stdint.h>
 
+#include "arena.h"
+#include "intern.h"
 #include "lexer.h"
+#include "symtab.h"
+
+#define MCC_VERSION "1.5.0" // 编译器版本（代码生成有变化时需更新，编译缓存以此区分）
+#define SEGMENT_CAPACITY ((size_t) 256 << 20) // 代码段、数据段的最大容量（保留的地址空间，按需提交）
 
 // 标识符类别
 enum {
@@ -15,7 +21,8 @@ enum {
     LOCAL, // 局部变量
     SYS, // 系统函数
     FUNC, // 用户函数
-    ENUM // 枚举
+    ENUM, // 枚举
+    NATIVE // 原生函数：仅有声明、可由 dlsym 解析的函数，值为函数桩的地址（本程序中有同名定义时调用定义）
 };
 
 // 数据类型
@@ -25,28 +32,117 @@ enum {
 
 // 符号表
 typedef struct {
-    int hash; // 名称的哈希值
-    const char *name; // 名称
-    int datatype; // 数据类型：CHAR, INT, PTR
-    int class; // 类型：全局变量 GLOBAL，枚举常量 ENUM，局部变量 LOCAL，函数 FUNC，系统函数 SYS
+    const char *name; // 名称（驻留的字符串，哈希值由 intern_hash 取得）
     int64_t value; // 值
+    int16_t datatype; // 数据类型：CHAR, INT, PTR
+    int16_t class; // 类型：全局变量 GLOBAL，枚举常量 ENUM，局部变量 LOCAL，函数 FUNC，系统函数 SYS，原生函数 NATIVE
+    int depth; // 局部符号：声明所在作用域的深度（函数参数及函数体开头声明的变量为 0）
+    int scope; // 局部符号：声明所在作用域的编号（同一函数内唯一）
+    uint32_t shadow; // 局部符号：被遮蔽的外层同名局部符号的索引 + 1（0 表示没有）
 } Symbol;
 
+// 重定位类型
+enum {
+    RELOC_TEXT, // 代码段地址：跳转目标、函数入口
+    RELOC_DATA // 数据段地址：全局变量、字符串
+};
+
+// 重定位条目：代码段中保存绝对地址的位置
+typedef struct {
+    uint32_t offset; // 在代码段中的偏移（以 int64_t 为单位）
+    uint32_t kind; // 重定位类型：RELOC_TEXT, RELOC_DATA
+} Reloc;
+
+// 行号表条目：从 offset 开始的指令对应源代码的 line 行
+typedef struct {
+    uint32_t offset; // 在代码段中的偏移（以 int64_t 为单位）
+    uint32_t line; // 源代码行号
+} LineInfo;
+
+// 字符串常量池条目（索引即字符串在常量池驻留表中的编号）
+typedef struct {
+    const char *chars; // 处理转义符后的字符串（位于常量池驻留表中）
+    size_t length; // 字符串长度（不含结尾的 0）
+    const char *addr; // 字符串在数据段中的地址（NULL 表示尚未布局）
+} StringEntry;
+
+// 字符串常量的引用：常量池布局后填入地址的 IMM 操作数
+typedef struct {
+    uint32_t offset; // IMM 操作数在代码段中的偏移（以 int64_t 为单位）
+    uint32_t string; // 字符串常量池条目的索引
+} StringRef;
+
+// 待链接的调用：被调用函数仅有声明（原型），链接时填入函数入口
+typedef struct {
+    uint32_t offset; // JSR 操作数在代码段中的偏移（以 int64_t 为单位）
+    const char *name; // 函数名
+} Fixup;
+
+// 函数表条目：记录函数定义的词法单元范围，用于延迟编译及热重载
+typedef struct {
+    size_t t_start; // 函数定义首个词法单元（返回类型）的索引
+    size_t t_index; // 参数列表 '(' 的索引
+    size_t t_end; // 函数定义之后的词法单元索引
+    size_t g_size; // 定义函数时全局符号表的符号数量（编译时仅可见此前定义的符号，与立即编译一致）
+    size_t symbol; // 函数符号在全局符号表中的索引
+    int64_t *stub; // 函数符号指向的地址（延迟编译：LZY 桩指令；热重载：JMP 桩指令；否则同 entry）
+    int64_t *entry; // 函数体入口（NULL 表示尚未编译）
+    int params; // 参数个数（-1 表示尚未编译）
+} Function;
+
 // 语法分析器
 typedef struct {
-    Token *tokens; // 词法分析结果：Token 序列
-    size_t t_size; // 词法分析结果：Token 数量
+    Lexer *lexer; // 词法分析器：词法单元序列及源文件文本（流式词法分析时按需生成词法单元，由语法分析器释放）
+    Interner *interner; // 字符串驻留表：符号名（接管自词法分析器，由语法分析器释放）
     size_t t_index; // 当前读取的 Token 的索引
     int64_t *l_text; // 代码段最后打印位置
-    int64_t *o_text; // 代码段的原始指针（用以最后释放内存，请勿直接操作此指针）
+    Arena t_arena; // 代码段的内存区（按需提交，生成指令前检查剩余空间）
+    Arena d_arena; // 数据段的内存区（按需提交，写入全局变量及字符串前检查剩余空间）
+    int64_t *o_text; // 代码段的原始指针（即 t_arena.base，请勿直接操作此指针）
     int64_t *text; // 代码段：存储生成的指令
-    char *o_data; // 数据段的原始指针（用以最后释放内存，请勿直接操作此指针）
+    char *o_data; // 数据段的原始指针（即 d_arena.base，请勿直接操作此指针）
     char *data; // 数据段：存储全局变量及字符串
     int64_t *main_entry; // main 函数入口，位于数据段
     Symbol *g_symbols; // 全局符号表
     size_t g_size; // 全局符号表：符号数量
-    Symbol *l_symbols; // 局部符号表
+    size_t g_capacity; // 全局符号表：容量
+    SymbolTable g_table; // 全局符号表的索引：名称 -> 符号（索引不小于 g_size 的符号不可见）
+    Symbol *l_symbols; // 局部符号表（当前函数的全部局部符号，退出语句块时不删除）
     size_t l_size; // 局部符号表：符号数量
+    size_t l_capacity; // 局部符号表：容量
+    SymbolTable l_table; // 局部符号表的索引：名称 -> 最内层的同名符号（函数结束时清空）
+    int *scopes; // 作用域栈：各深度当前作用域的编号
+    size_t sc_depth; // 作用域栈：当前深度
+    size_t sc_capacity; // 作用域栈：容量
+    int sc_serial; // 已分配的作用域编号
+    int l_index; // 已分配的局部变量槽位（函数参数之后，含语句块中声明的变量，用以计算栈帧大小）
+    StringEntry *strings; // 字符串常量池（相同字符串共享同一条目，布局时后缀相同的字符串共享同一地址）
+    size_t s_size; // 字符串常量池：条目数量
+    size_t s_capacity; // 字符串常量池：条目容量
+    Interner s_interner; // 字符串常量池：驻留表（按完整字符串的哈希值查找，编号即条目索引）
+    StringRef *s_refs; // 字符串常量池：布局前生成的引用
+    size_t sr_size; // 字符串常量池：引用数量
+    size_t sr_capacity; // 字符串常量池：引用容量
+    int s_laid; // 字符串常量池是否已布局（语法分析结束时布局，此后新的字符串立即写入数据段）
+    LineInfo *listing; // 打印指令：常量池布局前各行的结束位置及行号（布局后统一打印）
+    size_t li_size; // 打印指令：记录的行数
+    size_t li_capacity; // 打印指令：容量
+    size_t s_count; // 字符串字面量总数
+    size_t s_saved; // 字符串去重节省的数据段字节数
+    Reloc *relocs; // 重定位表
+    size_t r_size; // 重定位表：条目数量
+    size_t r_capacity; // 重定位表：条目容量
+    LineInfo *lines; // 行号表
+    size_t ln_size; // 行号表：条目数量
+    size_t ln_capacity; // 行号表：条目容量
+    Fixup *fixups; // 待链接的调用
+    size_t fx_size; // 待链接的调用：数量
+    size_t fx_capacity; // 待链接的调用：容量
+    Function *functions; // 函数表
+    size_t f_size; // 函数表：函数数量
+    size_t f_capacity; // 函数表：容量
+    int lazy; // 是否延迟编译函数体（main 函数除外）
+    int watch; // 是否经跳转桩调用函数（热重载时修改跳转目标）
     int expr_type; // 表达式类型（仅用于解析表达式）
     size_t line; // 当前行号（记录生成的指令对应的源代码行数，用以打印输出）
     int src; // 是否打印指令
@@ -55,20 +151,34 @@ typedef struct {
 /**
  * 初始化语法分析器
  * @param parser 语法分析器
- * @param tokens 词法分析得到的词法单元序列
- * @param t_size 词法单元数量
- * @param pool_size 内存池大小
+ * @param lexer 已完成词法分析的词法分析器（malloc 分配，连同源文件文本由语法分析器释放）
  * @param src 是否打印源代码
  */
-void parser_init(Parser *parser, Token *tokens, size_t t_size, size_t pool_size, int src);
+void parser_init(Parser *parser, Lexer *lexer, int src);
+
+/**
+ * 初始化语法分析器：词法分析与语法分析交替进行，语法分析需要下一词法单元时才扫描源码
+ * @details 仅保留最近的若干词法单元（环形缓冲区），不支持延迟编译及热重载
+ * @param parser 语法分析器
+ * @param source 源文件文本（由 source_load 加载，由语法分析器释放）
+ * @param src 是否打印源码及对应的汇编指令
+ */
+void parser_init_stream(Parser *parser, char *source, int src);
 
 /**
  * @brief 释放 parser 持有的内存资源
- * @details 释放：词法单元序列，全局符号表，局部符号表；不释放：代码段，数据段（虚拟机运行时必需）
+ * @details 释放：词法分析器（含词法单元序列及源文件文本），全局符号表，局部符号表，字符串常量池索引；不释放：代码段，数据段（虚拟机运行时必需，由 vm_free 或 arena_free 释放）
  * @param parser 语法分析器
  */
 void parser_free(Parser *parser);
 
+/**
+ * @brief 释放 parser 持有的重定位表和行号表
+ * @details 重定位表和行号表在语法分析结束后仍可用于输出程序映像，因此单独释放
+ * @param parser 语法分析器
+ */
+void parser_free_tables(Parser *parser);
+
 /**
  * @brief 解析 token 序列，并生成字节码
  * @details 语法分析 & 语义分析 & 代码生成
@@ -76,5 +186,23 @@ void parser_free(Parser *parser);
  */
 void parser_parse(Parser *parser);
 
+/**
+ * @brief 按函数当前的词法单元范围编译函数体，追加到代码段末尾
+ * @details 需在 parser_free 之前调用（依赖词法单元序列和符号表）
+ * @param parser 语法分析器
+ * @param index 函数索引
+ * @return 函数体入口
+ */
+int64_t *parser_compile_function(Parser *parser, size_t index);
+
+/**
+ * @brief 编译延迟编译的函数，函数体追加到代码段末尾
+ * @details 需在 parser_free 之前调用（依赖词法单元序列和符号表）；已编译的函数直接返回入口
+ * @param parser 语法分析器
+ * @param index 延迟编译的函数索引（LZY 指令的操作数）
+ * @return 函数入口
+ */
+int64_t *parser_compile_lazy(Parser *parser, int64_t index);
+
 
 #endif //MCC_PARSER_H
@@ -0,0 +1,138 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "pool.h"
+#include "fail.h"
+
+#define TASK_CAPACITY 16 // 任务队列初始容量
+
+// 工作线程：循环取出任务并执行
+void *pool_worker(void *arg);
+
+/**
+ * @brief 初始化线程池
+ * @param pool 线程池
+ * @param size 工作线程数量（0 表示按 CPU 核数）
+ */
+void pool_init(ThreadPool *pool, size_t size) {
+    if (size == 0) {
+        const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        size = cpus > 0 ? (size_t) cpus : 1;
+    }
+    pool->size = size;
+    pool->capacity = TASK_CAPACITY;
+    pool->head = 0;
+    pool->count = 0;
+    pool->running = 0;
+    pool->stop = 0;
+    pool->threads = malloc(sizeof(pthread_t) * size);
+    pool->tasks = malloc(sizeof(Task) * pool->capacity);
+    if (pool->threads == NULL || pool->tasks == NULL) {
+        fail("pool: malloc memory failed\n");
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->ready, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+    for (size_t i = 0; i < size; ++i) {
+        if (pthread_create(pool->threads + i, NULL, pool_worker, pool) != 0) {
+            fail("pool: could not create thread\n");
+        }
+    }
+}
+
+/**
+ * @brief 提交任务
+ * @param pool 线程池
+ * @param run 任务函数
+ * @param arg 任务参数
+ */
+void pool_submit(ThreadPool *pool, void (*run)(void *arg), void *arg) {
+    pthread_mutex_lock(&pool->lock);
+    if (pool->count == pool->capacity) {
+        // 扩容：按队列顺序搬移到新缓冲区开头
+        Task *tasks = malloc(sizeof(Task) * pool->capacity * 2);
+        if (tasks == NULL) {
+            fail("pool: malloc memory failed\n");
+        }
+        for (size_t i = 0; i < pool->count; ++i) {
+            tasks[i] = pool->tasks[(pool->head + i) % pool->capacity];
+        }
+        free(pool->tasks);
+        pool->tasks = tasks;
+        pool->head = 0;
+        pool->capacity = pool->capacity * 2;
+    }
+    pool->tasks[(pool->head + pool->count++) % pool->capacity] = (Task){run, arg};
+    pthread_cond_signal(&pool->ready);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * @brief 等待所有已提交的任务执行完毕
+ * @param pool 线程池
+ */
+void pool_wait(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->count > 0 || pool->running > 0) {
+        pthread_cond_wait(&pool->idle, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * @brief 停止工作线程并释放线程池
+ * @param pool 线程池
+ */
+void pool_free(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->ready);
+    pthread_mutex_unlock(&pool->lock);
+    for (size_t i = 0; i < pool->size; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->ready);
+    pthread_cond_destroy(&pool->idle);
+    free(pool->threads);
+    free(pool->tasks);
+    pool->threads = NULL;
+    pool->tasks = NULL;
+}
+
+/**
+ * @brief 工作线程：循环取出任务并执行，队列为空时等待
+ * @param arg 线程池
+ * @return NULL
+ */
+void *pool_worker(void *arg) {
+    ThreadPool *pool = arg;
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (pool->count == 0 && !pool->stop) {
+            pthread_cond_wait(&pool->ready, &pool->lock);
+        }
+        if (pool->count == 0) {
+            break; // 已停止且队列为空
+        }
+        const Task task = pool->tasks[pool->head];
+        pool->head = (pool->head + 1) % pool->capacity;
+        --pool->count;
+        ++pool->running;
+        pthread_mutex_unlock(&pool->lock);
+
+        task.run(task.arg);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->running == 0 && pool->count == 0) {
+            pthread_cond_broadcast(&pool->idle);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
@@ -0,0 +1,59 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_POOL_H
+#define MCC_POOL_H
+
+#include <stddef.h>
+#include <pthread.h>
+
+// 任务
+typedef struct {
+    void (*run)(void *arg); // 任务函数
+    void *arg; // 任务参数
+} Task;
+
+// 线程池：固定数量的工作线程，按提交顺序从任务队列中取出任务执行
+typedef struct {
+    pthread_t *threads; // 工作线程
+    size_t size; // 工作线程数量
+    Task *tasks; // 任务队列（环形缓冲区）
+    size_t capacity; // 任务队列容量
+    size_t head; // 队首索引
+    size_t count; // 队列中的任务数量
+    size_t running; // 正在执行的任务数量
+    int stop; // 是否停止工作线程
+    pthread_mutex_t lock; // 保护以上状态
+    pthread_cond_t ready; // 有新任务或需要停止
+    pthread_cond_t idle; // 队列为空且无正在执行的任务
+} ThreadPool;
+
+/**
+ * @brief 初始化线程池
+ * @param pool 线程池
+ * @param size 工作线程数量（0 表示按 CPU 核数）
+ */
+void pool_init(ThreadPool *pool, size_t size);
+
+/**
+ * @brief 提交任务
+ * @param pool 线程池
+ * @param run 任务函数
+ * @param arg 任务参数
+ */
+void pool_submit(ThreadPool *pool, void (*run)(void *arg), void *arg);
+
+/**
+ * @brief 等待所有已提交的任务执行完毕
+ * @param pool 线程池
+ */
+void pool_wait(ThreadPool *pool);
+
+/**
+ * @brief 停止工作线程并释放线程池
+ * @param pool 线程池
+ */
+void pool_free(ThreadPool *pool);
+
+#endif //MCC_POOL_H
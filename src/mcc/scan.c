@@ -0,0 +1,219 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "scan.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SCAN_SIMD 1
+#include <immintrin.h>
+#endif
+
+// 是否为空白字符（换行符除外）
+int scan_is_blank(char c);
+
+// 是否为标识符字符
+int scan_is_ident(char c);
+
+/**
+ * @brief 是否为空白字符（换行符需计数，不在此列）
+ * @param c 字符
+ * @return 1:是 0:不是
+ */
+int scan_is_blank(const char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/**
+ * @brief 是否为标识符字符（字母、数字、_）
+ * @param c 字符
+ * @return 1:是 0:不是
+ */
+int scan_is_ident(const char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// 逐字节扫描：不支持 SIMD 时使用，也用于处理 SIMD 扫描剩余的不足一个块的字节
+size_t scalar_blank(const char *source, size_t index, const size_t length) {
+    while (index < length && scan_is_blank(source[index])) {
+        ++index;
+    }
+    return index;
+}
+
+size_t scalar_ident(const char *source, size_t index, const size_t length) {
+    while (index < length && scan_is_ident(source[index])) {
+        ++index;
+    }
+    return index;
+}
+
+size_t scalar_line(const char *source, size_t index, const size_t length) {
+    while (index < length && source[index] != '\n') {
+        ++index;
+    }
+    return index;
+}
+
+size_t scalar_quote(const char *source, size_t index, const size_t length) {
+    while (index < length && source[index] != '"' && source[index] != '\'') {
+        ++index;
+    }
+    return index;
+}
+
+#ifdef SCAN_SIMD
+
+// SIMD 扫描：每次比较一个块，比较结果转为位掩码后用 ctz 定位首个满足条件的字节；
+// 只读取完整的块（不越过源码末尾），剩余字节交由下一级实现处理
+
+// SSE2：16 字节的比较结果（每字节 0xFF 表示满足条件）
+__attribute__((target("sse2"))) __m128i sse2_ident_mask(const __m128i x) {
+    const __m128i lower = _mm_or_si128(x, _mm_set1_epi8(0x20)); // 大写字母转为小写
+    const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                        _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmplt_epi8(x, _mm_set1_epi8('9' + 1)));
+    return _mm_or_si128(_mm_or_si128(alpha, digit), _mm_cmpeq_epi8(x, _mm_set1_epi8('_')));
+}
+
+__attribute__((target("sse2"))) size_t sse2_blank(const char *source, size_t index, const size_t length) {
+    for (; index + 16 <= length; index += 16) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) (source + index));
+        const __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')),
+                                                      _mm_cmpeq_epi8(x, _mm_set1_epi8('\t'))),
+                                         _mm_cmpeq_epi8(x, _mm_set1_epi8('\r')));
+        const unsigned mask = ~(unsigned) _mm_movemask_epi8(hit) & 0xFFFF;
+        if (mask != 0) {
+            return index + __builtin_ctz(mask);
+        }
+    }
+    return scalar_blank(source, index, length);
+}
+
+__attribute__((target("sse2"))) size_t sse2_ident(const char *source, size_t index, const size_t length) {
+    for (; index + 16 <= length; index += 16) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) (source + index));
+        const unsigned mask = ~(unsigned) _mm_movemask_epi8(sse2_ident_mask(x)) & 0xFFFF;
+        if (mask != 0) {
+            return index + __builtin_ctz(mask);
+        }
+    }
+    return scalar_ident(source, index, length);
+}
+
+__attribute__((target("sse2"))) size_t sse2_line(const char *source, size_t index, const size_t length) {
+    for (; index + 16 <= length; index += 16) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) (source + index));
+        const unsigned mask = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n')));
+        if (mask != 0) {
+            return index + __builtin_ctz(mask);
+        }
+    }
+    return scalar_line(source, index, length);
+}
+
+__attribute__((target("sse2"))) size_t sse2_quote(const char *source, size_t index, const size_t length) {
+    for (; index + 16 <= length; index += 16) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) (source + index));
+        const __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('"')),
+                                         _mm_cmpeq_epi8(x, _mm_set1_epi8('\'')));
+        const unsigned mask = (unsigned) _mm_movemask_epi8(hit);
+        if (mask != 0) {
+            return index + __builtin_ctz(mask);
+        }
+    }
+    return scalar_quote(source, index, length);
+}
+
+// AVX2：32 字节的比较结果（每字节 0xFF 表示满足条件）
+__attribute__((target("avx2"))) __m256i avx2_ident_mask(const __m256i x) {
+    const __m256i lower = _mm256_or_si256(x, _mm256_set1_epi8(0x20)); // 大写字母转为小写
+    const __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+    const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8('0' - 1)),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), x));
+    return _mm256_or_si256(_mm256_or_si256(alpha, digit), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_')));
+}
+
+__attribute__((target("avx2"))) size_t avx2_blank(const char *source, size_t index, const size_t length) {
+    for (; index + 32 <= length; index += 32) {
+        const __m256i x = _mm256_loadu_si256((const __m256i *) (source + index));
+        const __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')),
+                                                            _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\t'))),
+                                            _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\r')));
+        const unsigned mask = ~(unsigned) _mm256_movemask_epi8(hit);
+        if (mask != 0) {
+            return index + __builtin_ctz(mask);
+        }
+    }
+    return sse2_blank(source, index, length);
+}
+
+__attribute__((target("avx2"))) size_t avx2_ident(const char *source, size_t index, const size_t length) {
+    for (; index + 32 <= length; index += 32) {
+        const __m256i x = _mm256_loadu_si256((const __m256i *) (source + index));
+        const unsigned mask = ~(unsigned) _mm256_movemask_epi8(avx2_ident_mask(x));
+        if (mask != 0) {
+            return index + __builtin_ctz(mask);
+        }
+    }
+    return sse2_ident(source, index, length);
+}
+
+__attribute__((target("avx2"))) size_t avx2_line(const char *source, size_t index, const size_t length) {
+    for (; index + 32 <= length; index += 32) {
+        const __m256i x = _mm256_loadu_si256((const __m256i *) (source + index));
+        const unsigned mask = (unsigned) _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\n')));
+        if (mask != 0) {
+            return index + __builtin_ctz(mask);
+        }
+    }
+    return sse2_line(source, index, length);
+}
+
+__attribute__((target("avx2"))) size_t avx2_quote(const char *source, size_t index, const size_t length) {
+    for (; index + 32 <= length; index += 32) {
+        const __m256i x = _mm256_loadu_si256((const __m256i *) (source + index));
+        const __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('"')),
+                                            _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\'')));
+        const unsigned mask = (unsigned) _mm256_movemask_epi8(hit);
+        if (mask != 0) {
+            return index + __builtin_ctz(mask);
+        }
+    }
+    return sse2_quote(source, index, length);
+}
+
+#endif
+
+// 扫描实现：逐字节、SSE2、AVX2
+const Scanner SCANNERS[] = {
+    {"scalar", scalar_blank, scalar_ident, scalar_line, scalar_quote},
+#ifdef SCAN_SIMD
+    {"sse2", sse2_blank, sse2_ident, sse2_line, sse2_quote},
+    {"avx2", avx2_blank, avx2_ident, avx2_line, avx2_quote},
+#endif
+};
+
+const Scanner *scan_select(void) {
+    size_t best = 0; // CPU 支持的最快实现
+#ifdef SCAN_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        best = 2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        best = 1;
+    }
+#endif
+    const char *name = getenv(SCAN_ENV);
+    for (size_t i = 0; name != NULL && i < best; ++i) {
+        if (strcmp(SCANNERS[i].name, name) == 0) {
+            return SCANNERS + i; // 指定较慢的实现（用于对比测试）
+        }
+    }
+    return SCANNERS + best;
+}
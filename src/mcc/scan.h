@@ -0,0 +1,28 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_SCAN_H
+#define MCC_SCAN_H
+
+#include <stddef.h>
+
+#define SCAN_ENV "MCC_SIMD" // 指定扫描实现的环境变量：scalar, sse2, avx2（默认按 CPU 支持的指令集选择）
+
+// 字符扫描：从 index 开始查找，返回首个满足条件的位置，不存在时返回 length
+typedef struct {
+    const char *name; // 实现名称
+    size_t (*blank)(const char *source, size_t index, size_t length); // 首个非空白（空格、\t、\r）字符
+    size_t (*ident)(const char *source, size_t index, size_t length); // 首个非标识符（字母、数字、_）字符
+    size_t (*line)(const char *source, size_t index, size_t length); // 首个换行符
+    size_t (*quote)(const char *source, size_t index, size_t length); // 首个引号（单双引号均可）
+} Scanner;
+
+/**
+ * @brief 选择扫描实现：AVX2 每次比较 32 字节，SSE2 每次比较 16 字节，均不支持时逐字节比较
+ * @details 运行时检测 CPU 支持的指令集，可由环境变量 MCC_SIMD 指定
+ * @return 扫描实现
+ */
+const Scanner *scan_select(void);
+
+#endif //MCC_SCAN_H
@@ -0,0 +1,402 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <poll.h>
+
+#include "scheduler.h"
+#include "fail.h"
+
+#define RUN_QUEUE_CAPACITY 16 // 运行队列初始容量
+
+// 工作线程：循环取出虚拟机运行一个时间片
+void sched_worker(void *arg);
+
+// 运行一个时间片，按让出的原因放回运行队列、放入等待 I/O 的链表或结束
+void sched_run(RunQueue *queue, Green *green);
+
+// 虚拟机运行结束：调用回调并释放
+void sched_finish(Scheduler *sched, Green *green, int64_t result, const char *error);
+
+// 放入运行队列的队尾
+void sched_push(RunQueue *queue, Green *green);
+
+// 从运行队列的队首取出
+Green *sched_pop(RunQueue *queue);
+
+// 从其它运行队列的队尾窃取一半
+Green *sched_steal(RunQueue *queue);
+
+// 检查等待 I/O 的虚拟机，可读的放入运行队列
+void sched_poll(Scheduler *sched, RunQueue *queue);
+
+// 唤醒一个空闲的工作线程
+void sched_wake(Scheduler *sched);
+
+/**
+ * @brief 初始化调度器，启动工作线程
+ * @param sched 调度器
+ * @param size 工作线程数量（0 表示按 CPU 核数）
+ * @param budget 时间片：每次运行的指令数（0 表示 SCHED_BUDGET）
+ */
+void sched_init(Scheduler *sched, const size_t size, const int64_t budget) {
+    sched->budget = budget > 0 ? budget : SCHED_BUDGET;
+    sched->waiting = NULL;
+    sched->live = 0;
+    sched->next = 0;
+    sched->sleeping = 0;
+    sched->epoch = 0;
+    sched->stop = 0;
+    sched->fds = NULL;
+    sched->f_capacity = 0;
+    pthread_mutex_init(&sched->lock, NULL);
+    pthread_cond_init(&sched->ready, NULL);
+    pthread_cond_init(&sched->idle, NULL);
+    pool_init(&sched->pool, size);
+    sched->size = sched->pool.size;
+    sched->queues = calloc(sched->size, sizeof(RunQueue));
+    if (sched->queues == NULL) {
+        fail("sched: malloc memory failed\n");
+    }
+    for (size_t i = 0; i < sched->size; ++i) {
+        RunQueue *queue = sched->queues + i;
+        queue->capacity = RUN_QUEUE_CAPACITY;
+        queue->greens = malloc(sizeof(Green *) * queue->capacity);
+        if (queue->greens == NULL) {
+            fail("sched: malloc memory failed\n");
+        }
+        pthread_mutex_init(&queue->lock, NULL);
+        queue->index = i;
+        queue->sched = sched;
+    }
+    // 线程池的每个工作线程执行一个常驻任务：调度循环
+    for (size_t i = 0; i < sched->size; ++i) {
+        pool_submit(&sched->pool, sched_worker, sched->queues + i);
+    }
+}
+
+/**
+ * @brief 提交虚拟机：轮流放入各运行队列，唤醒一个空闲的工作线程
+ * @param sched 调度器
+ * @param vm 虚拟机（已由 vm_enter 设置入口）
+ * @param done 运行结束时的回调
+ * @param ctx 回调的上下文
+ */
+void sched_spawn(Scheduler *sched, VM *vm, const SchedDone done, void *ctx) {
+    Green *green = malloc(sizeof(Green));
+    if (green == NULL) {
+        fail("sched: malloc memory failed\n");
+    }
+    green->vm = vm;
+    green->done = done;
+    green->ctx = ctx;
+    green->next = NULL;
+    vm->nonblock = 1;
+    pthread_mutex_lock(&sched->lock);
+    ++sched->live;
+    const size_t index = sched->next++ % sched->size;
+    pthread_mutex_unlock(&sched->lock);
+    sched_push(sched->queues + index, green);
+    sched_wake(sched);
+}
+
+/**
+ * @brief 等待所有已提交的虚拟机运行结束
+ * @param sched 调度器
+ */
+void sched_wait(Scheduler *sched) {
+    pthread_mutex_lock(&sched->lock);
+    while (sched->live > 0) {
+        pthread_cond_wait(&sched->idle, &sched->lock);
+    }
+    pthread_mutex_unlock(&sched->lock);
+}
+
+/**
+ * @brief 停止工作线程并释放调度器
+ * @param sched 调度器
+ */
+void sched_free(Scheduler *sched) {
+    pthread_mutex_lock(&sched->lock);
+    __atomic_store_n(&sched->stop, 1, __ATOMIC_RELEASE); // 正在运行的工作线程在时间片结束后停止
+    pthread_cond_broadcast(&sched->ready);
+    pthread_mutex_unlock(&sched->lock);
+    pool_free(&sched->pool); // 等待调度循环结束
+    for (size_t i = 0; i < sched->size; ++i) {
+        RunQueue *queue = sched->queues + i;
+        for (size_t k = 0; k < queue->count; ++k) {
+            free(queue->greens[(queue->head + k) % queue->capacity]);
+        }
+        free(queue->greens);
+        pthread_mutex_destroy(&queue->lock);
+    }
+    while (sched->waiting != NULL) {
+        Green *green = sched->waiting;
+        sched->waiting = green->next;
+        free(green);
+    }
+    free(sched->queues);
+    free(sched->fds);
+    pthread_mutex_destroy(&sched->lock);
+    pthread_cond_destroy(&sched->ready);
+    pthread_cond_destroy(&sched->idle);
+}
+
+/**
+ * @brief 工作线程：依次从自己的队列、其它队列（窃取）、等待 I/O 的链表中取出虚拟机运行一个时间片；
+ *        都没有时等待新的虚拟机（有等待 I/O 的虚拟机时每隔 SCHED_POLL_MS 毫秒醒来检查）
+ * @details 检查队列之前记下 epoch：提交虚拟机时先放入队列再增加 epoch，等待之前 epoch 有变化则重新检查，不会错过唤醒
+ * @param arg 运行队列
+ */
+void sched_worker(void *arg) {
+    RunQueue *queue = arg;
+    Scheduler *sched = queue->sched;
+    while (!__atomic_load_n(&sched->stop, __ATOMIC_ACQUIRE)) {
+        const uint64_t epoch = __atomic_load_n(&sched->epoch, __ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&sched->waiting, __ATOMIC_ACQUIRE) != NULL) {
+            sched_poll(sched, queue); // 繁忙时也检查，避免等待 I/O 的虚拟机饥饿
+        }
+        Green *green = sched_pop(queue);
+        if (green == NULL) {
+            green = sched_steal(queue);
+        }
+        if (green != NULL) {
+            sched_run(queue, green);
+            continue;
+        }
+        pthread_mutex_lock(&sched->lock);
+        if (sched->stop) {
+            pthread_mutex_unlock(&sched->lock);
+            break;
+        }
+        if (epoch == sched->epoch) {
+            __atomic_add_fetch(&sched->sleeping, 1, __ATOMIC_RELAXED);
+            if (sched->waiting != NULL) {
+                struct timespec deadline;
+                clock_gettime(CLOCK_REALTIME, &deadline);
+                deadline.tv_nsec += SCHED_POLL_MS * 1000000L;
+                if (deadline.tv_nsec >= 1000000000L) {
+                    deadline.tv_sec += 1;
+                    deadline.tv_nsec -= 1000000000L;
+                }
+                pthread_cond_timedwait(&sched->ready, &sched->lock, &deadline);
+            } else {
+                pthread_cond_wait(&sched->ready, &sched->lock);
+            }
+            __atomic_sub_fetch(&sched->sleeping, 1, __ATOMIC_RELAXED);
+        }
+        pthread_mutex_unlock(&sched->lock);
+    }
+}
+
+/**
+ * @brief 运行一个时间片（budget 条指令后在跳转或函数调用时让出）
+ * @details 抢占的虚拟机放回自己队列的队尾（同一队列内轮转），队列中还有其它虚拟机且有空闲的工作线程时唤醒其窃取；
+ *          READ 无数据的虚拟机放入等待 I/O 的链表；运行错误与正常结束一样调用回调
+ * @param queue 当前工作线程的运行队列
+ * @param green 虚拟机
+ */
+void sched_run(RunQueue *queue, Green *green) {
+    Scheduler *sched = queue->sched;
+    VM *vm = green->vm;
+    vm->limit = vm->cycle + sched->budget;
+    FailPoint point;
+    FailPoint *outer = fail_catch(&point);
+    if (setjmp(point.jump) != 0) {
+        fail_restore(outer);
+        sched_finish(sched, green, -1, point.message);
+        return;
+    }
+    const int64_t result = vm_run(vm);
+    fail_restore(outer);
+    if (vm->state == VM_PREEMPTED) {
+        sched_push(queue, green);
+        if (__atomic_load_n(&sched->sleeping, __ATOMIC_RELAXED) > 0 &&
+            __atomic_load_n(&queue->count, __ATOMIC_RELAXED) > 1) {
+            sched_wake(sched);
+        }
+    } else if (vm->state == VM_BLOCKED) {
+        pthread_mutex_lock(&sched->lock);
+        green->next = sched->waiting;
+        __atomic_store_n(&sched->waiting, green, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&sched->lock);
+    } else {
+        sched_finish(sched, green, result, NULL);
+    }
+}
+
+/**
+ * @brief 虚拟机运行结束：恢复为不限指令数、READ 阻塞，调用回调，释放绿色线程
+ * @param sched 调度器
+ * @param green 虚拟机
+ * @param result 函数的返回值
+ * @param error 错误信息（NULL 表示正常结束）
+ */
+void sched_finish(Scheduler *sched, Green *green, const int64_t result, const char *error) {
+    VM *vm = green->vm;
+    vm->limit = INT64_MAX;
+    vm->nonblock = 0;
+    green->done(green->ctx, vm, result, error);
+    free(green);
+    pthread_mutex_lock(&sched->lock);
+    if (--sched->live == 0) {
+        pthread_cond_broadcast(&sched->idle);
+    }
+    pthread_mutex_unlock(&sched->lock);
+}
+
+/**
+ * @brief 放入运行队列的队尾，队列已满时扩容
+ * @param queue 运行队列
+ * @param green 虚拟机
+ */
+void sched_push(RunQueue *queue, Green *green) {
+    pthread_mutex_lock(&queue->lock);
+    if (queue->count == queue->capacity) {
+        // 扩容：按队列顺序搬移到新缓冲区开头
+        Green **greens = malloc(sizeof(Green *) * queue->capacity * 2);
+        if (greens == NULL) {
+            pthread_mutex_unlock(&queue->lock);
+            fail("sched: malloc memory failed\n");
+        }
+        for (size_t i = 0; i < queue->count; ++i) {
+            greens[i] = queue->greens[(queue->head + i) % queue->capacity];
+        }
+        free(queue->greens);
+        queue->greens = greens;
+        queue->head = 0;
+        queue->capacity = queue->capacity * 2;
+    }
+    queue->greens[(queue->head + queue->count) % queue->capacity] = green;
+    __atomic_store_n(&queue->count, queue->count + 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/**
+ * @brief 从运行队列的队首取出
+ * @param queue 运行队列
+ * @return 虚拟机；队列为空时返回 NULL
+ */
+Green *sched_pop(RunQueue *queue) {
+    pthread_mutex_lock(&queue->lock);
+    if (queue->count == 0) {
+        pthread_mutex_unlock(&queue->lock);
+        return NULL;
+    }
+    Green *green = queue->greens[queue->head];
+    queue->head = (queue->head + 1) % queue->capacity;
+    __atomic_store_n(&queue->count, queue->count - 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&queue->lock);
+    return green;
+}
+
+/**
+ * @brief 从其它运行队列的队尾窃取一半（向上取整）：返回其中一个，其余放入自己的队列
+ * @details 从下一个编号开始依次尝试，使各窃取者分散到不同的队列
+ * @param queue 窃取者的运行队列（此时为空）
+ * @return 虚拟机；其它队列均为空时返回 NULL
+ */
+Green *sched_steal(RunQueue *queue) {
+    const Scheduler *sched = queue->sched;
+    for (size_t k = 1; k < sched->size; ++k) {
+        RunQueue *victim = sched->queues + (queue->index + k) % sched->size;
+        if (__atomic_load_n(&victim->count, __ATOMIC_RELAXED) == 0) {
+            continue; // 先不加锁检查，减少空闲时的锁竞争
+        }
+        pthread_mutex_lock(&victim->lock);
+        const size_t count = (victim->count + 1) / 2;
+        if (count == 0) {
+            pthread_mutex_unlock(&victim->lock);
+            continue;
+        }
+        Green *stolen = victim->greens[(victim->head + victim->count - 1) % victim->capacity];
+        Green *rest = NULL; // 其余窃取的虚拟机暂存为链表，释放受害者的锁后再放入自己的队列
+        for (size_t i = 1; i < count; ++i) {
+            Green *green = victim->greens[(victim->head + victim->count - 1 - i) % victim->capacity];
+            green->next = rest;
+            rest = green;
+        }
+        __atomic_store_n(&victim->count, victim->count - count, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&victim->lock);
+        while (rest != NULL) {
+            Green *green = rest;
+            rest = green->next;
+            green->next = NULL;
+            sched_push(queue, green);
+        }
+        return stolen;
+    }
+    return NULL;
+}
+
+/**
+ * @brief 检查等待 I/O 的虚拟机（一次 poll），文件描述符可读的放入运行队列
+ * @param sched 调度器
+ * @param queue 当前工作线程的运行队列
+ */
+void sched_poll(Scheduler *sched, RunQueue *queue) {
+    pthread_mutex_lock(&sched->lock);
+    size_t count = 0;
+    for (const Green *green = sched->waiting; green != NULL; green = green->next) {
+        ++count;
+    }
+    if (count == 0) {
+        pthread_mutex_unlock(&sched->lock);
+        return;
+    }
+    if (count > sched->f_capacity) {
+        struct pollfd *fds = realloc(sched->fds, sizeof(struct pollfd) * count * 2);
+        if (fds == NULL) {
+            pthread_mutex_unlock(&sched->lock);
+            fail("sched: malloc memory failed\n");
+        }
+        sched->fds = fds;
+        sched->f_capacity = count * 2;
+    }
+    size_t i = 0;
+    for (const Green *green = sched->waiting; green != NULL; green = green->next) {
+        sched->fds[i++] = (struct pollfd){green->vm->b_fd, POLLIN, 0};
+    }
+    if (poll(sched->fds, count, 0) <= 0) {
+        pthread_mutex_unlock(&sched->lock);
+        return;
+    }
+    // 按与 fds 相同的顺序遍历链表，可读的虚拟机摘下，其余保持原顺序
+    Green *ready = NULL;
+    Green *rest = NULL;
+    Green **tail = &rest;
+    i = 0;
+    for (Green *green = sched->waiting, *next; green != NULL; green = next, ++i) {
+        next = green->next;
+        if (sched->fds[i].revents != 0) {
+            green->next = ready;
+            ready = green;
+        } else {
+            *tail = green;
+            tail = &green->next;
+        }
+    }
+    *tail = NULL;
+    __atomic_store_n(&sched->waiting, rest, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&sched->lock);
+    while (ready != NULL) {
+        Green *green = ready;
+        ready = green->next;
+        green->next = NULL;
+        sched_push(queue, green);
+    }
+}
+
+/**
+ * @brief 唤醒一个空闲的工作线程（增加 epoch，使正准备等待的工作线程重新检查队列）
+ * @param sched 调度器
+ */
+void sched_wake(Scheduler *sched) {
+    pthread_mutex_lock(&sched->lock);
+    __atomic_store_n(&sched->epoch, sched->epoch + 1, __ATOMIC_RELEASE);
+    pthread_cond_signal(&sched->ready);
+    pthread_mutex_unlock(&sched->lock);
+}
@@ -0,0 +1,97 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_SCHEDULER_H
+#define MCC_SCHEDULER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <poll.h>
+
+#include "vm.h"
+#include "pool.h"
+
+#define SCHED_BUDGET 10000 // 默认时间片：每次运行的指令数
+#define SCHED_POLL_MS 1 // 有等待 I/O 的虚拟机时，空闲工作线程检查文件描述符的间隔（毫秒）
+
+/**
+ * 虚拟机运行结束时的回调（在工作线程中调用）
+ * @param ctx 提交时传入的上下文
+ * @param vm 虚拟机
+ * @param result 函数的返回值（出错时为 -1）
+ * @param error 错误信息（NULL 表示正常结束）
+ */
+typedef void (*SchedDone)(void *ctx, VM *vm, int64_t result, const char *error);
+
+// 绿色线程：调度器中的一个虚拟机
+typedef struct Green {
+    VM *vm; // 虚拟机（已由 vm_enter 设置入口）
+    SchedDone done; // 运行结束时的回调
+    void *ctx; // 回调的上下文
+    struct Green *next; // 等待 I/O 的链表
+} Green;
+
+typedef struct Scheduler Scheduler;
+
+// 运行队列：一个工作线程的可运行虚拟机（双端队列，环形缓冲区）
+typedef struct {
+    Green **greens; // 虚拟机
+    size_t capacity; // 容量
+    size_t head; // 队首索引：所有者从队首取出、向队尾放回，窃取者从队尾取走一半
+    size_t count; // 数量
+    pthread_mutex_t lock; // 保护以上状态
+    size_t index; // 工作线程编号
+    Scheduler *sched; // 所属的调度器
+} RunQueue;
+
+// 调度器：将大量虚拟机复用到少量工作线程上，按指令数抢占，READ 无数据时让出，空闲的工作线程窃取其它队列中的虚拟机
+struct Scheduler {
+    ThreadPool pool; // 工作线程
+    RunQueue *queues; // 运行队列（与工作线程一一对应）
+    size_t size; // 工作线程数量
+    int64_t budget; // 时间片：每次运行的指令数
+    Green *waiting; // 等待 I/O 的虚拟机
+    size_t live; // 尚未结束的虚拟机数量
+    size_t next; // 下一个提交的虚拟机放入的队列（轮流放入）
+    size_t sleeping; // 正在等待的空闲工作线程数量
+    uint64_t epoch; // 唤醒的次数（工作线程等待前据此判断是否错过唤醒）
+    int stop; // 是否停止工作线程
+    struct pollfd *fds; // 检查等待 I/O 的虚拟机时使用的缓冲区
+    size_t f_capacity; // fds 的容量
+    pthread_mutex_t lock; // 保护 waiting、live、next、sleeping、epoch、stop、fds
+    pthread_cond_t ready; // 有新的虚拟机或需要停止
+    pthread_cond_t idle; // 所有虚拟机已结束
+};
+
+/**
+ * @brief 初始化调度器，启动工作线程
+ * @param sched 调度器
+ * @param size 工作线程数量（0 表示按 CPU 核数）
+ * @param budget 时间片：每次运行的指令数（0 表示 SCHED_BUDGET）
+ */
+void sched_init(Scheduler *sched, size_t size, int64_t budget);
+
+/**
+ * @brief 提交虚拟机：从 vm_enter 设置的入口开始运行，结束前不可再由其它线程使用
+ * @param sched 调度器
+ * @param vm 虚拟机
+ * @param done 运行结束时的回调
+ * @param ctx 回调的上下文
+ */
+void sched_spawn(Scheduler *sched, VM *vm, SchedDone done, void *ctx);
+
+/**
+ * @brief 等待所有已提交的虚拟机运行结束
+ * @param sched 调度器
+ */
+void sched_wait(Scheduler *sched);
+
+/**
+ * @brief 停止工作线程并释放调度器（尚未结束的虚拟机不再运行，也不调用回调）
+ * @param sched 调度器
+ */
+void sched_free(Scheduler *sched);
+
+#endif //MCC_SCHEDULER_H
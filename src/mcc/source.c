@@ -0,0 +1,172 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "source.h"
+
+#define READ_CAPACITY (64 * 1024) // 流式读取的初始缓冲区大小
+
+// 内存布局：[头部页][源码 ... 0 填充至页边界]，头部页末尾记录整个映射的大小，用于释放
+
+// 页面大小
+size_t source_page(void);
+
+// 将 size 向上对齐到页边界
+size_t source_align(size_t size);
+
+// 映射普通文件
+char *source_map(int fd, size_t size);
+
+/**
+ * @brief 加载源文件：普通文件直接映射，其它文件流式读取
+ * @param path 文件路径（"-" 表示标准输入）
+ * @param length 源码长度
+ * @param copy 是否复制到私有内存（不映射文件）
+ * @return 源码（以 0 结尾）；无法打开或读取时返回 NULL
+ */
+char *source_load(const char *path, size_t *length, const int copy) {
+    const int is_stdin = strcmp(path, SOURCE_STDIN) == 0;
+    const int fd = is_stdin ? STDIN_FILENO : open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        if (fd >= 0 && !is_stdin) {
+            close(fd);
+        }
+        return NULL;
+    }
+    char *source;
+    if (!copy && S_ISREG(st.st_mode) && st.st_size > 0) {
+        // 普通文件：大小已知，直接映射（/proc 等大小为 0 的文件仍需读取）
+        source = source_map(fd, st.st_size);
+        *length = source != NULL ? (size_t) st.st_size : 0;
+    } else {
+        source = source_read(fd, length);
+    }
+    if (!is_stdin) {
+        close(fd); // 映射不依赖文件描述符
+    }
+    return source;
+}
+
+/**
+ * @brief 流式读取：缓冲区满时按倍数扩容（mremap 移动页面，不复制内容），直至读到文件末尾
+ * @param fd 文件描述符
+ * @param length 源码长度
+ * @return 源码（以 0 结尾）；读取失败时返回 NULL
+ */
+char *source_read(const int fd, size_t *length) {
+    const size_t page = source_page();
+    size_t capacity = READ_CAPACITY, size = 0;
+    char *base = mmap(NULL, page + capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+    while (1) {
+        if (size + 1 == capacity) {
+            // 保留至少一个 0 字节作为结尾标记
+            char *grown = mremap(base, page + capacity, page + capacity * 2, MREMAP_MAYMOVE);
+            if (grown == MAP_FAILED) {
+                munmap(base, page + capacity);
+                return NULL;
+            }
+            base = grown;
+            capacity = capacity * 2;
+        }
+        const ssize_t n = read(fd, base + page + size, capacity - 1 - size);
+        if (n == 0) {
+            break;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            munmap(base, page + capacity);
+            return NULL;
+        }
+        size += n;
+    }
+    *(size_t *) (base + page - sizeof(size_t)) = page + capacity;
+    *length = size;
+    return base + page; // 匿名页面初始为 0，无需写入结尾标记
+}
+
+/**
+ * @brief 复制内存中的源码：布局与 source_read 相同，可由 source_free 释放
+ * @param text 源码
+ * @param length 源码长度
+ * @return 源码副本（以 0 结尾）；分配失败时返回 NULL
+ */
+char *source_copy(const char *text, const size_t length) {
+    const size_t page = source_page();
+    const size_t total = page + source_align(length + 1);
+    char *base = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+    memcpy(base + page, text, length); // 匿名页面初始为 0，无需写入结尾标记
+    *(size_t *) (base + page - sizeof(size_t)) = total;
+    return base + page;
+}
+
+/**
+ * @brief 释放源码：解除整个映射
+ * @param source 源码
+ */
+void source_free(char *source) {
+    if (source == NULL) {
+        return;
+    }
+    const size_t page = source_page();
+    munmap(source - page, *(size_t *) (source - sizeof(size_t)));
+}
+
+/**
+ * @brief 页面大小
+ * @return 页面大小
+ */
+size_t source_page(void) {
+    const long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? (size_t) page : 4096;
+}
+
+/**
+ * @brief 将 size 向上对齐到页边界
+ * @param size 大小
+ * @return 对齐后的大小
+ */
+size_t source_align(const size_t size) {
+    const size_t page = source_page();
+    return (size + page - 1) / page * page;
+}
+
+/**
+ * @brief 映射普通文件：先保留 [头部页][size + 1 字节对齐到页边界] 的匿名映射，再将文件覆盖映射到头部页之后
+ * @details 文件最后一页超出文件末尾的部分由内核填 0；文件大小恰为页面整数倍时，其后的匿名页面提供结尾标记
+ * @param fd 文件描述符
+ * @param size 文件大小
+ * @return 源码（以 0 结尾）；映射失败时返回 NULL
+ */
+char *source_map(const int fd, const size_t size) {
+    const size_t page = source_page();
+    const size_t total = page + source_align(size + 1);
+    char *base = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+    if (mmap(base + page, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(base, total);
+        return NULL;
+    }
+    *(size_t *) (base + page - sizeof(size_t)) = total;
+    return base + page;
+}
@@ -0,0 +1,45 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_SOURCE_H
+#define MCC_SOURCE_H
+
+#include <stddef.h>
+
+#define SOURCE_STDIN "-" // 表示从标准输入读取源码的文件名
+
+/**
+ * @brief 加载源文件：普通文件直接映射（不复制），标准输入、管道等无法映射的文件流式读取
+ * @details 源码之后至少有一个 0 字节作为结尾标记，词法分析器可直接在映射的页面上扫描；
+ *          映射的页面随文件内容变化，需要稳定快照（如热重载比较新旧文本）时应指定 copy
+ * @param path 文件路径（"-" 表示标准输入）
+ * @param length 源码长度
+ * @param copy 是否复制到私有内存（不映射文件）
+ * @return 源码（以 0 结尾）；无法打开或读取时返回 NULL
+ */
+char *source_load(const char *path, size_t *length, int copy);
+
+/**
+ * @brief 从文件描述符流式读取全部内容（不限大小）
+ * @param fd 文件描述符
+ * @param length 源码长度
+ * @return 源码（以 0 结尾）；读取失败时返回 NULL
+ */
+char *source_read(int fd, size_t *length);
+
+/**
+ * @brief 复制内存中的源码（嵌入使用：源码由调用方提供，不来自文件）
+ * @param text 源码
+ * @param length 源码长度
+ * @return 源码副本（以 0 结尾）；分配失败时返回 NULL
+ */
+char *source_copy(const char *text, size_t length);
+
+/**
+ * @brief 释放 source_load、source_read 或 source_copy 返回的源码
+ * @param source 源码
+ */
+void source_free(char *source);
+
+#endif //MCC_SOURCE_H
@@ -0,0 +1,101 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "symtab.h"
+#include "fail.h"
+
+// 查找名称所在的条目；不存在时返回探测序列中的首个空位
+SymbolSlot *symtab_slot(const SymbolTable *table, const char *name, int hash);
+
+// 哈希表扩容
+void symtab_resize(SymbolTable *table);
+
+void symtab_init(SymbolTable *table, const size_t capacity) {
+    table->slots = calloc(capacity, sizeof(SymbolSlot));
+    if (table->slots == NULL) {
+        fail("symtab: malloc memory failed\n");
+    }
+    table->size = 0;
+    table->mask = capacity - 1;
+    table->stamp = 1; // 版本号 0 表示从未写入的空位
+}
+
+void symtab_free(SymbolTable *table) {
+    free(table->slots);
+    table->slots = NULL;
+    table->size = 0;
+}
+
+void symtab_clear(SymbolTable *table) {
+    table->size = 0;
+    if (++table->stamp == 0) {
+        // 版本号回绕：旧条目可能与新版本号相同，只能逐个清除
+        memset(table->slots, 0, sizeof(SymbolSlot) * (table->mask + 1));
+        table->stamp = 1;
+    }
+}
+
+int64_t symtab_find(const SymbolTable *table, const char *name, const int hash) {
+    const SymbolSlot *slot = symtab_slot(table, name, hash);
+    return slot->stamp == table->stamp ? (int64_t) slot->index : SYMTAB_NONE;
+}
+
+void symtab_put(SymbolTable *table, const char *name, const int hash, const uint32_t index) {
+    SymbolSlot *slot = symtab_slot(table, name, hash);
+    if (slot->stamp != table->stamp) {
+        ++table->size;
+    }
+    *slot = (SymbolSlot){name, hash, index, table->stamp};
+    if (table->size * 2 > table->mask) {
+        symtab_resize(table); // 装载因子超过 1/2
+    }
+}
+
+/**
+ * @brief 查找名称所在的条目：线性探测，遇到空位（或旧版本的条目）时停止
+ * @param table 符号索引
+ * @param name 名称
+ * @param hash 名称的哈希值
+ * @return 名称所在的条目；不存在时返回探测序列中的首个空位
+ */
+SymbolSlot *symtab_slot(const SymbolTable *table, const char *name, const int hash) {
+    size_t i = (size_t) (unsigned) hash & table->mask;
+    while (1) {
+        SymbolSlot *slot = table->slots + i;
+        if (slot->stamp != table->stamp ||
+            slot->name == name || (slot->hash == hash && strcmp(slot->name, name) == 0)) {
+            return slot;
+        }
+        i = (i + 1) & table->mask;
+    }
+}
+
+/**
+ * @brief 哈希表扩容（容量翻倍，重新插入当前版本的条目）
+ * @param table 符号索引
+ */
+void symtab_resize(SymbolTable *table) {
+    const size_t capacity = (table->mask + 1) * 2;
+    SymbolSlot *slots = calloc(capacity, sizeof(SymbolSlot));
+    if (slots == NULL) {
+        fail("symtab: malloc memory failed\n");
+    }
+    for (size_t i = 0; i <= table->mask; ++i) {
+        const SymbolSlot *slot = table->slots + i;
+        if (slot->stamp == table->stamp) {
+            size_t j = (size_t) (unsigned) slot->hash & (capacity - 1);
+            while (slots[j].stamp != 0) {
+                j = (j + 1) & (capacity - 1);
+            }
+            slots[j] = *slot;
+        }
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->mask = capacity - 1;
+}
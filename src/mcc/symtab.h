@@ -0,0 +1,68 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_SYMTAB_H
+#define MCC_SYMTAB_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SYMTAB_NONE (-1) // 查找失败
+
+// 符号索引条目
+typedef struct {
+    const char *name; // 名称（NULL 表示空位）
+    int hash; // 名称的哈希值
+    uint32_t index; // 符号在符号表数组中的索引
+    uint32_t stamp; // 写入时哈希表的版本号（与当前版本号不同的条目视为空位）
+} SymbolSlot;
+
+// 符号索引：名称 -> 符号表数组中的索引（开放寻址，线性探测）；
+// 清空时只需递增版本号，旧条目自动失效，无需逐个删除
+typedef struct {
+    SymbolSlot *slots; // 哈希表
+    size_t size; // 当前版本的条目数量
+    size_t mask; // 哈希表容量 - 1
+    uint32_t stamp; // 当前版本号
+} SymbolTable;
+
+/**
+ * @brief 初始化符号索引
+ * @param table 符号索引
+ * @param capacity 初始容量（2 的幂）
+ */
+void symtab_init(SymbolTable *table, size_t capacity);
+
+/**
+ * @brief 释放符号索引
+ * @param table 符号索引
+ */
+void symtab_free(SymbolTable *table);
+
+/**
+ * @brief 清空符号索引：O(1)，递增版本号即可
+ * @param table 符号索引
+ */
+void symtab_clear(SymbolTable *table);
+
+/**
+ * @brief 查找名称对应的索引
+ * @details 名称先比较指针（驻留的字符串），指针不同时再比较哈希值和内容（来自不同驻留表的字符串）
+ * @param table 符号索引
+ * @param name 名称
+ * @param hash 名称的哈希值（hash_chars 计算所得）
+ * @return 符号在符号表数组中的索引；不存在时返回 SYMTAB_NONE
+ */
+int64_t symtab_find(const SymbolTable *table, const char *name, int hash);
+
+/**
+ * @brief 设置名称对应的索引：已存在时覆盖，否则插入（装载因子超过 1/2 时扩容）
+ * @param table 符号索引
+ * @param name 名称
+ * @param hash 名称的哈希值
+ * @param index 符号在符号表数组中的索引
+ */
+void symtab_put(SymbolTable *table, const char *name, int hash, uint32_t index);
+
+#endif //MCC_SYMTAB_H
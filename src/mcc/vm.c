@@ -2,81 +2,365 @@
 // Created by Patrick.Lau on 2025/5/31.
 //
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 #include "vm.h"
+#include "parallel.h"
+#include "native.h"
+#include "fail.h"
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0 // 旧内核：仅作为地址提示，映射后检查实际地址
+#endif
+
+// 快照文件头
+typedef struct {
+    uint32_t magic; // 魔数：SNAPSHOT_MAGIC
+    uint32_t compact; // 是否运行紧凑字节码
+    int64_t pc; // 寄存器
+    int64_t rsp;
+    int64_t rbp;
+    int64_t rax;
+} SnapshotHeader;
+
+// 快照内存区域：映射 [addr, addr + size)，其中 [addr + start, addr + start + length) 的内容保存在快照中
+typedef struct {
+    uint64_t addr; // 起始地址
+    uint64_t size; // 映射大小
+    uint64_t start; // 已保存内容的起始偏移
+    uint64_t length; // 已保存内容的长度
+} SnapshotRegion;
+
+// 快照依次保存的内存区域
+enum {
+    REGION_TEXT, REGION_DATA, REGION_STACK, REGION_HEAP, REGION_COUNT
+};
+
+// 线程：与创建它的虚拟机共享代码段、数据段和堆，拥有独立的栈和寄存器
+typedef struct {
+    VM vm; // 线程的虚拟机
+    pthread_t thread; // 系统线程
+    int64_t result; // 线程函数的返回值
+    int failed; // 是否发生运行错误（join 时在调用线程中报告）
+    FailPoint point; // 线程的错误恢复点
+} Thread;
+
+// 协程状态
+enum {
+    CORO_CREATED, // 已创建，尚未开始运行
+    CORO_SUSPENDED, // 已交出，等待恢复
+    CORO_RUNNING, // 正在运行（含恢复了其它协程、等待其交出）
+    CORO_DEAD // 协程函数已返回
+};
+
+// 协程：与恢复者共用虚拟机，只有独立的栈；切换时交换 pc、rsp、rbp。协程及其栈从堆中分配，随堆保存到快照
+typedef struct Coroutine {
+    int64_t *pc; // 保存的寄存器：协程挂起时为协程的，运行时为恢复者的
+    int64_t *rsp;
+    int64_t *rbp;
+    struct Coroutine *prev; // 恢复者所在的协程（NULL 表示恢复者不在协程中）
+    int64_t *arg; // 协程函数的参数在栈中的位置（首次恢复时写入）
+    int64_t *tail; // 栈底结束指令之后的位置：在此交出表示协程函数已返回
+    int64_t status; // 协程状态
+} Coroutine;
+
+// 回调：原生函数（qsort、bsearch）经 vm_call 调用的源程序的函数
+typedef struct {
+    VM *vm; // 调用原生函数的虚拟机
+    int64_t *fn; // 源程序的函数入口
+} Callback;
+
+// bsearch 的比较函数没有上下文参数：经线程局部变量取得当前的回调（嵌套调用时保存并恢复外层的回调）
+__thread Callback *search_callback;
+
+// 延迟编译的互斥锁：多个线程可能同时首次调用函数，而编译会修改语法分析器和代码段
+pthread_mutex_t lazy_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// 延迟编译函数并修补调用点（持有延迟编译的互斥锁）
+int64_t *lazy_compile(VM *vm, int64_t *stub, int64_t *site);
+
+// 编译所有尚未编译的延迟编译函数（快照前调用）
+void lazy_compile_all(VM *vm);
+
+// 从根虚拟机的堆中分配内存
+void *heap_alloc(VM *vm, size_t size);
+
+// 创建协程
+int64_t coro_create(VM *vm, int64_t *entry, int64_t size);
+
+// 恢复协程
+int64_t coro_resume(VM *vm, Coroutine *co, int64_t value);
+
+// 协程交出值
+int64_t coro_yield(VM *vm, int64_t value);
+
+// 交换虚拟机与协程保存的寄存器
+void coro_swap(VM *vm, Coroutine *co);
+
+// 排序：比较函数为源程序的函数
+int64_t vm_qsort(VM *vm, char *base, int64_t count, int64_t size, int64_t *fn);
+
+// 二分查找：比较函数为源程序的函数
+int64_t vm_bsearch(VM *vm, const char *key, const char *base, int64_t count, int64_t size, int64_t *fn);
+
+// qsort 的比较函数：回调源程序的函数
+int sort_compare(const void *a, const void *b, void *ctx);
+
+// bsearch 的比较函数：回调源程序的函数
+int search_compare(const void *key, const void *item);
+
+// 创建线程，运行 entry(arg)
+int64_t thread_create(VM *vm, int64_t *entry, int64_t arg);
+
+// 线程入口：运行线程的虚拟机
+void *thread_main(void *arg);
+
+// 等待线程结束，释放线程
+int64_t thread_join(VM *vm, Thread *thread);
+
+// 互斥锁加锁（futex）
+int64_t mutex_lock(int32_t *word);
+
+// 互斥锁解锁
+int64_t mutex_unlock(int32_t *word);
+
+// 文件描述符是否可读（不等待）
+int fd_readable(int fd);
+
+// 分配匿名内存（按需分配物理页，初始值为 0）
+void *map_anonymous(void *addr, size_t size);
+
+// 保存虚拟机快照
+int64_t snapshot(const VM *vm, const char *path);
 
 
 /**
- * @brief 初始化虚拟机
+ * @brief 初始化虚拟机：分配栈和堆，从 main 函数开始运行
  * @param vm 虚拟机
- * @param o_text 代码段原始指针
- * @param o_data 数据段原始指针
- * @param size 虚拟机栈大小
+ * @param t_arena 代码段的内存区（NULL 表示代码段不由虚拟机释放）
+ * @param d_arena 数据段的内存区（NULL 表示数据段不由虚拟机释放）
  * @param main 主函数入口
  * @param debug 是否打印当前运行的虚拟机指令
  * @param argc 参数个数
  * @param argv 参数列表
  */
-void vm_init(VM *vm, int64_t *o_text, char *o_data,
-             const size_t size, int64_t *main, const int debug, const int argc, char **argv) {
-    vm->o_text = o_text;
-    vm->o_data = o_data;
-    vm->stack = malloc(size);
-    if (vm->stack == NULL) {
-        printf("vm stack malloc error\n");
-        exit(-1);
-    }
-    memset(vm->stack, 0, size);
-    vm->pc = main;
-    if (vm->pc == NULL) {
-        printf("main function is not defined\n");
-        exit(-1);
+void vm_init(VM *vm, Arena *t_arena, Arena *d_arena,
+             int64_t *main, const int debug, const int argc, char **argv) {
+    vm_setup(vm, t_arena, d_arena, debug);
+    if (main == NULL) {
+        fail("main function is not defined\n");
     }
+    const int64_t args[] = {argc, (int64_t) argv};
+    vm_enter(vm, main, args, 2);
+}
 
+/**
+ * @brief 初始化虚拟机的栈和堆，暂不设置入口
+ * @param vm 虚拟机
+ * @param t_arena 代码段的内存区（NULL 表示代码段不由虚拟机释放）
+ * @param d_arena 数据段的内存区（NULL 表示数据段不由虚拟机释放）
+ * @param debug 是否打印当前运行的虚拟机指令
+ */
+void vm_setup(VM *vm, Arena *t_arena, Arena *d_arena, const int debug) {
+    vm->t_arena = t_arena;
+    vm->d_arena = d_arena;
+    vm->text = NULL;
+    vm->t_size = 0;
+    vm->data = NULL;
+    vm->d_size = 0;
+    vm->compact = 0;
+    vm->restored = 0;
+    vm->quiet = 0;
+    vm->compile = NULL;
+    vm->ctx = NULL;
+    vm->watch = NULL;
+    vm->w_ctx = NULL;
+    vm->stack_size = VM_STACK_SIZE;
+    vm->stack = map_anonymous(NULL, vm->stack_size);
+    vm->heap_size = VM_HEAP_SIZE;
+    vm->heap_top = vm->heap = map_anonymous(NULL, vm->heap_size);
+    if (vm->stack == NULL || vm->heap == NULL) {
+        fail("vm stack mmap error\n");
+    }
     vm->debug = debug;
+    vm->cycle = 0;
+    vm->root = vm;
+    vm->threads = 0;
+    vm->parallel = NULL;
+    vm->p_busy = 0;
+    vm->coroutine = NULL;
+    vm->limit = INT64_MAX;
+    vm->state = VM_RUNNING;
+    vm->nonblock = 0;
+    vm->b_fd = -1;
+    vm->callbacks = 0;
+    vm->c_base = NULL;
+    vm->pc = NULL;
     vm->rax = 0;
+    vm->rbp = NULL;
+    vm->rsp = (int64_t *) ((int64_t) vm->stack + vm->stack_size); // 指向栈顶
+}
 
-    vm->rsp = (int64_t *) ((int64_t) vm->stack + size); // 指向栈顶
+/**
+ * @brief 从栈顶开始设置调用 entry 的栈帧：函数返回后执行 EXIT，vm_run 返回函数的返回值
+ * @param vm 虚拟机
+ * @param entry 函数入口
+ * @param args 参数（按声明顺序入栈）
+ * @param count 参数个数
+ */
+void vm_enter(VM *vm, int64_t *entry, const int64_t *args, const int count) {
+    vm->rsp = (int64_t *) ((int64_t) vm->stack + vm->stack_size); // 指向栈顶
+    vm->rbp = NULL;
+    vm->callbacks = 0; // 丢弃的栈中可能有因运行错误未返回的回调
+    vm->c_base = NULL;
     *--vm->rsp = EXIT; // call exit if main returns
     *--vm->rsp = PUSH;
     int64_t *tmp = vm->rsp;
-    *--vm->rsp = argc;
-    *--vm->rsp = (int64_t) argv;
+    for (int i = 0; i < count; ++i) {
+        *--vm->rsp = args[i];
+    }
     *--vm->rsp = (int64_t) tmp;
+    vm->pc = entry;
+}
+
+/**
+ * @brief 在调用者的栈顶之下调用源程序的函数：返回地址指向栈中的 RETN 哨兵，嵌套运行 vm_run 至函数返回
+ * @details 调用期间指令数不限、READ 阻塞（原生函数无法中途让出）；返回后恢复调用者的寄存器及运行状态
+ * @param vm 虚拟机（正在执行系统调用，寄存器为最新状态）
+ * @param entry 函数入口
+ * @param args 参数（按声明顺序入栈）
+ * @param count 参数个数
+ * @return 函数的返回值
+ */
+int64_t vm_call(VM *vm, int64_t *entry, const int64_t *args, const int count) {
+    if (vm->compact) {
+        // 紧凑字节码中函数名的值仍为定长指令的地址，无法回调
+        fail("native callbacks are not supported when running compact bytecode\n");
+    }
+    int64_t *pc = vm->pc, *rsp = vm->rsp, *rbp = vm->rbp;
+    const int64_t rax = vm->rax, limit = vm->limit;
+    const int nonblock = vm->nonblock;
+    struct Coroutine *c_base = vm->c_base;
+    *--vm->rsp = RETN;
+    int64_t *sentinel = vm->rsp;
+    for (int i = 0; i < count; ++i) {
+        *--vm->rsp = args[i];
+    }
+    *--vm->rsp = (int64_t) sentinel;
+    vm->pc = entry;
+    vm->limit = INT64_MAX;
+    vm->nonblock = 0;
+    vm->c_base = vm->coroutine;
+    ++vm->callbacks;
+    const int64_t result = vm_run(vm);
+    const int state = vm->state;
+    --vm->callbacks;
+    vm->c_base = c_base;
+    vm->nonblock = nonblock;
+    vm->limit = limit;
+    vm->pc = pc;
+    vm->rsp = rsp;
+    vm->rbp = rbp;
+    vm->rax = rax;
+    vm->state = VM_RUNNING;
+    if (state != VM_RETURNED) {
+        fail("native callback did not return\n");
+    }
+    return result;
+}
+
+/**
+ * @brief 初始化与 vm 共享代码段、数据段、堆及延迟编译上下文的虚拟机，分配独立的栈
+ * @details 共享的内存区不由新的虚拟机释放；热重载只在根虚拟机的安全点进行，新的虚拟机不调用 watch
+ * @param child 新的虚拟机（入口由 vm_enter 设置）
+ * @param vm 被共享的虚拟机
+ * @return 0:成功 -1:分配栈失败
+ */
+int vm_share(VM *child, const VM *vm) {
+    memset(child, 0, sizeof(VM));
+    vm_segments(child, vm->text, vm->t_size, vm->data, vm->d_size);
+    child->compact = vm->compact;
+    child->compile = vm->compile;
+    child->ctx = vm->ctx;
+    child->debug = vm->debug;
+    child->quiet = 1;
+    child->root = vm->root;
+    child->limit = INT64_MAX;
+    child->b_fd = -1;
+    child->stack_size = VM_STACK_SIZE;
+    child->stack = map_anonymous(NULL, child->stack_size);
+    return child->stack != NULL ? 0 : -1;
+}
+
+/**
+ * @brief 设置代码段和数据段的位置
+ * @param vm 虚拟机
+ * @param text 代码段
+ * @param t_size 代码段大小（字节）
+ * @param data 数据段
+ * @param d_size 数据段大小（字节）
+ */
+void vm_segments(VM *vm, void *text, const size_t t_size, void *data, const size_t d_size) {
+    vm->text = text;
+    vm->t_size = t_size;
+    vm->data = data;
+    vm->d_size = d_size;
 }
 
 void vm_free(VM *vm) {
+    if (__atomic_load_n(&vm->threads, __ATOMIC_ACQUIRE) > 0) {
+        return; // 线程仍在运行，可能访问任一内存区
+    }
+    if (vm->parallel != NULL) {
+        parallel_free(vm->parallel);
+        vm->parallel = NULL;
+    }
     if (vm->stack != NULL) {
-        free(vm->stack);
+        munmap(vm->stack, vm->stack_size);
         vm->stack = NULL;
     }
-    if (vm->o_text != NULL) {
-        free(vm->o_text);
-        vm->o_text = NULL;
+    if (vm->heap != NULL) {
+        munmap(vm->heap, vm->heap_size);
+        vm->heap = NULL;
+    }
+    if (vm->restored) {
+        munmap(vm->text, vm->t_size);
+        munmap(vm->data, vm->d_size);
+        vm->restored = 0;
     }
-    if (vm->o_data != NULL) {
-        free(vm->o_data);
-        vm->o_data = NULL;
+    if (vm->t_arena != NULL) {
+        arena_free(vm->t_arena);
+        vm->t_arena = NULL;
+    }
+    if (vm->d_arena != NULL) {
+        arena_free(vm->d_arena);
+        vm->d_arena = NULL;
     }
 }
 
 int64_t vm_run(VM *vm) {
-    int64_t *tmp, cycle = 0;
+    int64_t cycle = vm->cycle;
+    const int64_t limit = vm->limit;
     const int debug = vm->debug;
+    vm->state = VM_RUNNING;
     while (1) {
         const int64_t op = *vm->pc++; // get operation code
         ++cycle;
         if (debug) {
             // 打印当前执行的指令
             printf("%ld> %.4s", cycle,
-                   &"LEA ,IMM ,JMP ,JSR ,JZ  ,JNZ ,ENT ,ADJ ,LEV ,LI  ,LC  ,SI  ,SC  ,PUSH,"
-                   "OR  ,XOR ,AND ,EQ  ,NE  ,LT  ,GT  ,LE  ,GE  ,SHL ,SHR ,ADD ,SUB ,MUL ,DIV ,MOD ,"
-                   "OPEN,READ,CLOS,PRTF,MALC,MSET,MCMP,EXIT,"[op * 5]);
+                   &OPCODE_NAMES[op * 5]);
             if (op <= ADJ) {
                 printf(" %ld\n", *vm->pc);
             } else {
@@ -104,6 +388,12 @@ int64_t vm_run(VM *vm) {
                 break;
             case JMP:
                 vm->pc = (int64_t *) *vm->pc;
+                if (cycle >= limit) {
+                    // 指令数达到上限：在跳转（循环）处让出，再次调用 vm_run 时从跳转目标继续
+                    vm->cycle = cycle;
+                    vm->state = VM_PREEMPTED;
+                    return 0;
+                }
                 break;
             case JZ:
                 vm->pc = vm->rax ? vm->pc + 1 : (int64_t *) *vm->pc;
@@ -114,6 +404,12 @@ int64_t vm_run(VM *vm) {
             case JSR:
                 *--vm->rsp = (int64_t) (vm->pc + 1);
                 vm->pc = (int64_t *) *vm->pc;
+                if (cycle >= limit) {
+                    // 指令数达到上限：在函数调用（递归）处让出
+                    vm->cycle = cycle;
+                    vm->state = VM_PREEMPTED;
+                    return 0;
+                }
                 break;
             case ENT:
                 *--vm->rsp = (int64_t) vm->rbp;
@@ -123,11 +419,31 @@ int64_t vm_run(VM *vm) {
             case ADJ:
                 vm->rsp = vm->rsp + *vm->pc++;
                 break;
+            case LZY: {
+                if (vm->compile == NULL) {
+                    fail("lazy function %ld is not compiled\n", *vm->pc);
+                }
+                // 首次调用时编译函数体，桩改为跳转到函数体（经函数值调用时不再进入此处）；
+                // 经 JSR 到达此处，返回地址的前一个字即调用点的跳转目标，改为直接指向函数体
+                vm->pc = lazy_compile(vm, vm->pc - 1, (int64_t *) *vm->rsp - 1);
+                break;
+            }
             case LEV:
                 vm->rsp = vm->rbp;
                 vm->rbp = (int64_t *) *vm->rsp++;
                 vm->pc = (int64_t *) *vm->rsp++;
+                if (vm->watch != NULL) {
+                    vm->watch(vm->w_ctx); // 安全点：函数返回后，可替换函数体
+                }
                 break;
+            case NATV: {
+                // 原生函数桩（IMM native; NATV）经 JSR 到达：参数个数取调用点之后 ADJ 的操作数，经函数值调用时取声明的参数个数
+                const int64_t *ret = (int64_t *) *vm->rsp;
+                Native *native = (Native *) vm->rax;
+                vm->rax = native_call(native, vm->rsp + 1, *ret == ADJ ? (int) ret[1] : native->params);
+                vm->pc = (int64_t *) *vm->rsp++;
+                break;
+            }
             case LEA:
                 vm->rax = (int64_t) (vm->rbp + *vm->pc++);
                 break;
@@ -180,33 +496,634 @@ int64_t vm_run(VM *vm) {
                 vm->rax = *vm->rsp++ % vm->rax;
                 break;
             case OPEN:
-                vm->rax = open((char *) vm->rsp[1], (int) vm->rsp[0]);
-                break;
             case READ:
-                vm->rax = read((int) vm->rsp[2], (char *) vm->rsp[1], *vm->rsp);
-                break;
             case CLOS:
-                vm->rax = close((int) *vm->rsp);
-                break;
             case PRTF:
-                tmp = vm->rsp + vm->pc[1];
-                vm->rax = printf((char *) tmp[-1], tmp[-2], tmp[-3], tmp[-4], tmp[-5], tmp[-6]);
-                break;
             case MALC:
-                vm->rax = (int64_t) malloc(*vm->rsp);
-                break;
             case MSET:
-                vm->rax = (int64_t) memset((char *) vm->rsp[2], (int) vm->rsp[1], *vm->rsp);
-                break;
             case MCMP:
-                vm->rax = memcmp((char *) vm->rsp[2], (char *) vm->rsp[1], *vm->rsp);
+            case SNAP:
+            case THRC:
+            case THRJ:
+            case AADD:
+            case ACAS:
+            case LOCK:
+            case UNLK:
+            case PFOR:
+            case CNEW:
+            case CRES:
+            case CYLD:
+            case CDON:
+            case QSRT:
+            case BSCH:
+                // PRTF 的参数个数：紧随其后的 ADJ 指令的操作数；协程的恢复和交出在 vm_syscall 中切换 pc、rsp、rbp
+                // 回调源程序的函数（vm_call）时嵌套运行 vm_run，指令数经 vm->cycle 累计
+                vm->cycle = cycle;
+                vm->rax = vm_syscall(vm, op, op == PRTF ? vm->pc[1] : 0);
+                cycle = vm->cycle;
+                if (vm->state != VM_RUNNING) {
+                    vm->cycle = cycle; // 由调度器运行时 READ 无数据：让出，恢复后重新执行 READ
+                    return 0;
+                }
                 break;
             case EXIT:
-                printf("exit(%ld) cycle = %ld\n", *vm->rsp, cycle);
+                if (vm->callbacks > 0) {
+                    // 原生函数（如 qsort）正在等待回调返回，无法中途结束
+                    fail("exit is not supported in a native callback\n");
+                }
+                vm->cycle = cycle;
+                vm->state = VM_EXITED;
+                if (!vm->quiet) {
+                    printf("exit(%ld) cycle = %ld\n", *vm->rsp, cycle);
+                    if (vm->parallel != NULL) {
+                        parallel_report(vm->parallel);
+                    }
+                }
                 return *vm->rsp;
+            case RETN:
+                vm->cycle = cycle;
+                vm->state = VM_RETURNED;
+                return vm->rax;
             default:
-                printf("unknown instruction:%ld\n", op);
+                fail("unknown instruction:%ld\n", op);
+        }
+    }
+}
+
+/**
+ * @brief 执行系统调用
+ * @param vm 虚拟机（参数按声明顺序自高地址向低地址排列，最后一个参数位于 rsp[0]）
+ * @param op 操作码
+ * @param argc 参数个数（仅 PRTF 使用）
+ * @return 系统调用返回值
+ */
+int64_t vm_syscall(VM *vm, const int64_t op, const int64_t argc) {
+    const int64_t *rsp = vm->rsp;
+    switch (op) {
+        case OPEN:
+            return open((char *) rsp[1], (int) rsp[0]);
+        case READ:
+            if (vm->nonblock && !fd_readable((int) rsp[2])) {
+                // 由调度器运行：不阻塞工作线程，让出直到文件描述符可读，之后重新执行 READ
+                vm->state = VM_BLOCKED;
+                vm->b_fd = (int) rsp[2];
+                --vm->pc;
+                return 0;
+            }
+            return read((int) rsp[2], (char *) rsp[1], *rsp);
+        case CLOS:
+            return close((int) *rsp);
+        case PRTF: {
+            int64_t a[NATIVE_ARGS_MAX];
+            native_marshal(rsp, (int) argc, a);
+            return printf((char *) a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7],
+                          a[8], a[9], a[10], a[11], a[12], a[13], a[14], a[15]);
+        }
+        case MALC:
+            return (int64_t) heap_alloc(vm, *rsp);
+        case MSET:
+            return (int64_t) memset((char *) rsp[2], (int) rsp[1], *rsp);
+        case MCMP:
+            return memcmp((char *) rsp[2], (char *) rsp[1], *rsp);
+        case SNAP:
+            // 快照只保存一个虚拟机的栈和寄存器：仅根虚拟机在没有其它线程、不在协程及回调中时可以保存
+            if (vm != vm->root || __atomic_load_n(&vm->threads, __ATOMIC_ACQUIRE) > 0 || vm->coroutine != NULL ||
+                vm->callbacks > 0) {
                 return -1;
+            }
+            if (vm->compile != NULL) {
+                lazy_compile_all(vm); // 快照不保存语法分析器，恢复后无法再编译
+            }
+            return snapshot(vm, (char *) *rsp);
+        case THRC:
+            return thread_create(vm, (int64_t *) rsp[1], rsp[0]);
+        case THRJ:
+            return thread_join(vm, (Thread *) *rsp);
+        case AADD:
+            return __atomic_fetch_add((int64_t *) rsp[1], rsp[0], __ATOMIC_SEQ_CST);
+        case ACAS: {
+            int64_t expected = rsp[1];
+            return __atomic_compare_exchange_n((int64_t *) rsp[2], &expected, rsp[0], 0,
+                                               __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
         }
+        case LOCK:
+            return mutex_lock((int32_t *) *rsp);
+        case UNLK:
+            return mutex_unlock((int32_t *) *rsp);
+        case PFOR:
+            return parallel_for(vm, rsp[3], rsp[2], (int64_t *) rsp[1], rsp[0]);
+        case CNEW:
+            return coro_create(vm, (int64_t *) rsp[1], rsp[0]);
+        case CRES:
+            return coro_resume(vm, (Coroutine *) rsp[1], rsp[0]);
+        case CYLD:
+            return coro_yield(vm, *rsp);
+        case CDON:
+            return ((Coroutine *) *rsp)->status == CORO_DEAD;
+        case QSRT:
+            return vm_qsort(vm, (char *) rsp[3], rsp[2], rsp[1], (int64_t *) rsp[0]);
+        case BSCH:
+            return vm_bsearch(vm, (char *) rsp[4], (char *) rsp[3], rsp[2], rsp[1], (int64_t *) rsp[0]);
+        default:
+            fail("unknown system call:%ld\n", op);
+    }
+}
+
+/**
+ * @brief 延迟编译：编译桩对应的函数体并将桩改为 JMP 函数体，调用点仍指向桩时改为指向函数体
+ * @details 编译会修改语法分析器和代码段，多个线程可能同时首次调用函数，因此持有互斥锁；
+ *          桩先写入目标再写入操作码，其它线程读到 JMP 时目标已写入，读到 LZY 时在锁内发现桩已改写；
+ *          编译错误时先释放锁，再向外报告同样的错误
+ * @param vm 虚拟机
+ * @param stub 延迟编译桩（LZY 指令的地址，其后为函数的索引）
+ * @param site 调用点的跳转目标
+ * @return 函数入口
+ */
+int64_t *lazy_compile(VM *vm, int64_t *stub, int64_t *site) {
+    pthread_mutex_lock(&lazy_lock);
+    FailPoint point;
+    FailPoint *outer = fail_catch(&point);
+    if (setjmp(point.jump) != 0) {
+        fail_restore(outer);
+        pthread_mutex_unlock(&lazy_lock);
+        fail("%s\n", point.message);
+    }
+    int64_t *entry;
+    if (stub[0] == JMP) {
+        entry = (int64_t *) stub[1]; // 其它线程已编译
+    } else {
+        entry = vm->compile(vm->ctx, stub[1]);
+        __atomic_store_n(stub + 1, (int64_t) entry, __ATOMIC_RELEASE);
+        __atomic_store_n(stub, (int64_t) JMP, __ATOMIC_RELEASE);
     }
+    if (*site == (int64_t) stub) {
+        *site = (int64_t) entry;
+    }
+    fail_restore(outer);
+    pthread_mutex_unlock(&lazy_lock);
+    return entry;
+}
+
+/**
+ * @brief 编译所有尚未编译的延迟编译函数，各桩改为 JMP 函数体
+ * @details 从代码段开头逐条指令扫描（操作码不大于 ADJ 的指令带操作数），扫描到 LZY 时编译；
+ *          编译追加的函数体在扫描范围内，其中只有调用指令，不会出现新的桩；已提交而未使用的部分为 0，按 LEA 0 跳过
+ * @param vm 虚拟机（代码段为语法分析器的内存区）
+ */
+void lazy_compile_all(VM *vm) {
+    int64_t *text = vm->text;
+    int64_t site = 0; // 没有调用点需要修补
+    for (size_t i = 1; i + 1 < vm->t_arena->size / sizeof(int64_t); i += text[i] <= ADJ ? 2 : 1) {
+        if (text[i] == LZY) {
+            lazy_compile(vm, text + i, &site);
+        }
+    }
+}
+
+/**
+ * @brief 从根虚拟机的堆中分配内存（按 16 字节对齐），快照时堆随虚拟机一同保存
+ * @details 各线程共享堆，以 CAS 移动堆顶
+ * @param vm 虚拟机
+ * @param size 大小（字节）
+ * @return 内存地址；堆空间不足时返回 NULL
+ */
+void *heap_alloc(VM *vm, const size_t size) {
+    VM *root = vm->root;
+    const size_t aligned = (size + 15) & ~(size_t) 15;
+    char *addr = __atomic_load_n(&root->heap_top, __ATOMIC_RELAXED);
+    do {
+        if (aligned > (size_t) (root->heap + root->heap_size - addr)) {
+            return NULL;
+        }
+    } while (!__atomic_compare_exchange_n(&root->heap_top, &addr, addr + aligned, 1,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    return addr;
+}
+
+/**
+ * @brief 创建协程：从堆中分配协程及其栈，首次恢复时从 entry 开始运行
+ * @details 栈底放置结束指令（PUSH, CYLD）作为协程函数的返回地址：函数返回后将返回值交给恢复者，协程结束。
+ *          栈无保护页，溢出时覆盖堆中相邻的内存
+ * @param vm 虚拟机
+ * @param entry 协程函数入口（函数有一个参数：首次恢复时传入的值）
+ * @param size 栈大小（字节，至少 CORO_STACK_MIN）
+ * @return 协程句柄；堆空间不足时返回 0
+ */
+int64_t coro_create(VM *vm, int64_t *entry, int64_t size) {
+    if (vm->compact) {
+        // 紧凑字节码中函数名的值仍为定长指令的地址，无法作为协程入口
+        fail("coro_create is not supported when running compact bytecode\n");
+    }
+    size = size < CORO_STACK_MIN ? CORO_STACK_MIN : (size + 15) & ~(int64_t) 15;
+    Coroutine *co = heap_alloc(vm, sizeof(Coroutine) + size);
+    if (co == NULL) {
+        return 0;
+    }
+    int64_t *top = (int64_t *) ((char *) (co + 1) + size);
+    *--top = CYLD;
+    *--top = PUSH;
+    int64_t *code = top;
+    co->tail = code + 2;
+    *--top = 0;
+    co->arg = top;
+    *--top = (int64_t) code;
+    co->pc = entry;
+    co->rsp = top;
+    co->rbp = NULL;
+    co->prev = NULL;
+    co->status = CORO_CREATED;
+    return (int64_t) co;
+}
+
+/**
+ * @brief 恢复协程：保存恢复者的寄存器，切换到协程的栈继续运行
+ * @details 协程下一次交出（或函数返回）时，恢复者从 coro_resume 返回，返回值为交出的值
+ * @param vm 虚拟机
+ * @param co 协程（已创建或已交出）
+ * @param value 传给协程的值：首次恢复时为协程函数的参数，此后为 coro_yield 的返回值
+ * @return value（切换后写入 rax，即协程中 coro_yield 的返回值）
+ */
+int64_t coro_resume(VM *vm, Coroutine *co, const int64_t value) {
+    if (co == NULL || co->status == CORO_RUNNING || co->status == CORO_DEAD) {
+        fail("coro_resume: coroutine is %s\n", co == NULL ? "null" : co->status == CORO_DEAD ? "dead" : "running");
+    }
+    if (co->status == CORO_CREATED) {
+        *co->arg = value;
+    }
+    coro_swap(vm, co);
+    co->prev = vm->coroutine;
+    co->status = CORO_RUNNING;
+    vm->coroutine = co;
+    return value;
+}
+
+/**
+ * @brief 协程交出值：保存协程的寄存器，切换回恢复者
+ * @param vm 虚拟机
+ * @param value 交出的值（恢复者中 coro_resume 的返回值）
+ * @return value（切换后写入 rax，即恢复者中 coro_resume 的返回值）
+ */
+int64_t coro_yield(VM *vm, const int64_t value) {
+    Coroutine *co = vm->coroutine;
+    if (co == NULL) {
+        fail("coro_yield: not in a coroutine\n");
+    }
+    if (vm->callbacks > 0 && co == vm->c_base) {
+        // 恢复者的栈帧在原生函数之外，交出后无法回到原生函数
+        fail("coro_yield: cannot yield across a native callback\n");
+    }
+    coro_swap(vm, co);
+    vm->coroutine = co->prev;
+    co->status = co->pc == co->tail ? CORO_DEAD : CORO_SUSPENDED;
+    return value;
+}
+
+/**
+ * @brief 交换虚拟机与协程保存的寄存器（pc 指向系统调用之后的指令）
+ * @param vm 虚拟机
+ * @param co 协程
+ */
+void coro_swap(VM *vm, Coroutine *co) {
+    int64_t *pc = vm->pc, *rsp = vm->rsp, *rbp = vm->rbp;
+    vm->pc = co->pc;
+    vm->rsp = co->rsp;
+    vm->rbp = co->rbp;
+    co->pc = pc;
+    co->rsp = rsp;
+    co->rbp = rbp;
+}
+
+/**
+ * @brief 排序（libc qsort_r）：比较函数 fn(a, b) 为源程序的函数，a、b 为元素的地址，返回负数、0、正数
+ * @param vm 虚拟机
+ * @param base 数组
+ * @param count 元素个数
+ * @param size 元素大小（字节）
+ * @param fn 比较函数入口
+ * @return 0
+ */
+int64_t vm_qsort(VM *vm, char *base, const int64_t count, const int64_t size, int64_t *fn) {
+    if (count < 0 || size <= 0) {
+        fail("qsort: bad count %ld or size %ld\n", count, size);
+    }
+    Callback callback = {vm, fn};
+    qsort_r(base, (size_t) count, (size_t) size, sort_compare, &callback);
+    return 0;
+}
+
+/**
+ * @brief 二分查找（libc bsearch）：比较函数 fn(key, item) 为源程序的函数，item 为元素的地址
+ * @param vm 虚拟机
+ * @param key 查找的键（原样传给比较函数）
+ * @param base 数组（已按比较函数排序）
+ * @param count 元素个数
+ * @param size 元素大小（字节）
+ * @param fn 比较函数入口
+ * @return 找到的元素的地址；没有找到时返回 0
+ */
+int64_t vm_bsearch(VM *vm, const char *key, const char *base, const int64_t count, const int64_t size, int64_t *fn) {
+    if (count < 0 || size <= 0) {
+        fail("bsearch: bad count %ld or size %ld\n", count, size);
+    }
+    Callback callback = {vm, fn};
+    Callback *outer = search_callback;
+    search_callback = &callback;
+    FailPoint point;
+    FailPoint *f_outer = fail_catch(&point);
+    if (setjmp(point.jump) != 0) {
+        fail_restore(f_outer);
+        search_callback = outer;
+        fail("%s\n", point.message);
+    }
+    const void *item = bsearch(key, base, (size_t) count, (size_t) size, search_compare);
+    fail_restore(f_outer);
+    search_callback = outer;
+    return (int64_t) item;
+}
+
+/**
+ * @brief qsort 的比较函数：回调源程序的函数，返回值按符号转换为 int
+ * @param a 元素的地址
+ * @param b 元素的地址
+ * @param ctx 回调
+ * @return 负数:a 在前 0:相等 正数:b 在前
+ */
+int sort_compare(const void *a, const void *b, void *ctx) {
+    const Callback *callback = ctx;
+    const int64_t args[] = {(int64_t) a, (int64_t) b};
+    const int64_t result = vm_call(callback->vm, callback->fn, args, 2);
+    return result < 0 ? -1 : result > 0;
+}
+
+/**
+ * @brief bsearch 的比较函数：回调当前线程最内层的 bsearch 的源程序的函数
+ * @param key 查找的键
+ * @param item 元素的地址
+ * @return 负数:key 在 item 之前 0:相等 正数:key 在 item 之后
+ */
+int search_compare(const void *key, const void *item) {
+    const int64_t args[] = {(int64_t) key, (int64_t) item};
+    const int64_t result = vm_call(search_callback->vm, search_callback->fn, args, 2);
+    return result < 0 ? -1 : result > 0;
+}
+
+/**
+ * @brief 创建线程：新的虚拟机共享代码段、数据段、堆及延迟编译的上下文，拥有独立的栈和寄存器
+ * @details 线程函数返回（或执行 exit）时线程结束；热重载只在主线程的安全点进行，线程不调用 watch
+ * @param vm 创建线程的虚拟机
+ * @param entry 线程函数入口（guest 中的函数名）
+ * @param arg 线程函数的参数
+ * @return 线程句柄（传给 thread_join）；失败返回 0
+ */
+int64_t thread_create(VM *vm, int64_t *entry, const int64_t arg) {
+    if (vm->compact) {
+        // 紧凑字节码中函数名的值仍为定长指令的地址，无法作为线程入口
+        fail("thread_create is not supported when running compact bytecode\n");
+    }
+    Thread *thread = malloc(sizeof(Thread));
+    if (thread == NULL) {
+        return 0;
+    }
+    if (vm_share(&thread->vm, vm) != 0) {
+        free(thread);
+        return 0;
+    }
+    thread->result = 0;
+    thread->failed = 0;
+    vm_enter(&thread->vm, entry, &arg, 1);
+    __atomic_add_fetch(&vm->root->threads, 1, __ATOMIC_ACQ_REL);
+    if (pthread_create(&thread->thread, NULL, thread_main, thread) != 0) {
+        __atomic_sub_fetch(&vm->root->threads, 1, __ATOMIC_ACQ_REL);
+        vm_free(&thread->vm);
+        free(thread);
+        return 0;
+    }
+    return (int64_t) thread;
+}
+
+/**
+ * @brief 线程入口：运行线程的虚拟机，运行错误保存至线程，由 thread_join 报告
+ * @param arg 线程
+ * @return NULL
+ */
+void *thread_main(void *arg) {
+    Thread *thread = arg;
+    fail_catch(&thread->point);
+    if (setjmp(thread->point.jump) != 0) {
+        fail_restore(NULL);
+        thread->failed = 1;
+        thread->result = -1;
+        return NULL;
+    }
+    thread->result = vm_run(&thread->vm);
+    fail_restore(NULL);
+    return NULL;
+}
+
+/**
+ * @brief 等待线程结束，释放线程的栈
+ * @details 线程发生运行错误时，在调用线程中报告同样的错误
+ * @param vm 调用 join 的虚拟机
+ * @param thread 线程句柄（thread_create 的返回值）
+ * @return 线程函数的返回值
+ */
+int64_t thread_join(VM *vm, Thread *thread) {
+    if (thread == NULL || pthread_join(thread->thread, NULL) != 0) {
+        return -1;
+    }
+    __atomic_sub_fetch(&vm->root->threads, 1, __ATOMIC_ACQ_REL);
+    const int64_t result = thread->result;
+    const int failed = thread->failed;
+    char message[FAIL_SIZE];
+    memcpy(message, thread->point.message, FAIL_SIZE);
+    vm_free(&thread->vm);
+    free(thread);
+    if (failed) {
+        fail("%s\n", message);
+    }
+    return result;
+}
+
+/**
+ * @brief 互斥锁加锁：guest 中的 int 变量作为锁（初始值为 0），使用低 32 位
+ * @details 0：未加锁；1：已加锁且无等待者；2：已加锁且可能有等待者（解锁时需唤醒）
+ * @param word 锁
+ * @return 0
+ */
+int64_t mutex_lock(int32_t *word) {
+    int32_t state = 0;
+    if (__atomic_compare_exchange_n(word, &state, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        return 0;
+    }
+    if (state != 2) {
+        state = __atomic_exchange_n(word, 2, __ATOMIC_ACQUIRE);
+    }
+    while (state != 0) {
+        syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, 2, NULL, NULL, 0);
+        state = __atomic_exchange_n(word, 2, __ATOMIC_ACQUIRE);
+    }
+    return 0;
+}
+
+/**
+ * @brief 互斥锁解锁：有等待者时唤醒其中一个
+ * @param word 锁
+ * @return 0
+ */
+int64_t mutex_unlock(int32_t *word) {
+    if (__atomic_exchange_n(word, 0, __ATOMIC_RELEASE) == 2) {
+        syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+    return 0;
+}
+
+/**
+ * @brief 文件描述符是否可读：有数据、已到文件末尾或出错时 read 均不会阻塞
+ * @param fd 文件描述符
+ * @return 1:可读 0:read 会阻塞
+ */
+int fd_readable(const int fd) {
+    struct pollfd pfd = {fd, POLLIN, 0};
+    return poll(&pfd, 1, 0) != 0;
+}
+
+/**
+ * @brief 分配匿名内存
+ * @param addr 指定地址（NULL 表示由内核选择）
+ * @param size 大小
+ * @return 内存地址；失败返回 NULL
+ */
+void *map_anonymous(void *addr, const size_t size) {
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | (addr != NULL ? MAP_FIXED_NOREPLACE : 0);
+    void *mem = mmap(addr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (mem == MAP_FAILED) {
+        return NULL;
+    }
+    if (addr != NULL && mem != addr) {
+        munmap(mem, size); // 旧内核忽略了 MAP_FIXED_NOREPLACE
+        return NULL;
+    }
+    return mem;
+}
+
+/**
+ * @brief 保存虚拟机快照：寄存器、代码段、数据段、栈（已使用部分）和堆（已分配部分）
+ * @details 恢复后 snapshot() 返回 1，保存成功时返回 0，失败返回 -1；
+ * 快照不包含已打开的文件描述符，恢复后需重新打开
+ * @param vm 虚拟机
+ * @param path 快照文件路径
+ * @return 0:保存成功 -1:保存失败
+ */
+int64_t snapshot(const VM *vm, const char *path) {
+    if (vm->text == NULL || vm->data == NULL) {
+        return -1;
+    }
+    const SnapshotHeader header = {
+        SNAPSHOT_MAGIC, vm->compact, (int64_t) vm->pc, (int64_t) vm->rsp, (int64_t) vm->rbp, 1
+    };
+    const char *stack = (const char *) vm->stack;
+    // 内存区只写入已提交的部分（其后的页面从未写入，恢复时映射为 0 即可；延迟编译时代码段仍在增长）；
+    // 运行紧凑字节码时代码段为字节码，不是内存区
+    const size_t t_length = vm->t_arena != NULL && vm->text == vm->t_arena->base ? vm->t_arena->size : vm->t_size;
+    const size_t d_length = vm->d_arena != NULL && vm->data == vm->d_arena->base ? vm->d_arena->size : vm->d_size;
+    SnapshotRegion regions[REGION_COUNT] = {
+        {(uint64_t) vm->text, vm->t_size, 0, t_length},
+        {(uint64_t) vm->data, vm->d_size, 0, d_length},
+        {(uint64_t) stack, vm->stack_size, (char *) vm->rsp - stack, stack + vm->stack_size - (char *) vm->rsp},
+        {(uint64_t) vm->heap, vm->heap_size, 0, vm->heap_top - vm->heap},
+    };
+    // 代码段和数据段可能由 malloc 分配，映射区域扩展至页边界
+    const uint64_t page = sysconf(_SC_PAGESIZE);
+    for (int i = 0; i < REGION_COUNT; ++i) {
+        const uint64_t base = regions[i].addr & ~(page - 1);
+        const uint64_t end = (regions[i].addr + regions[i].size + page - 1) & ~(page - 1);
+        regions[i].start += regions[i].addr - base;
+        regions[i].addr = base;
+        regions[i].size = end - base;
+    }
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(regions, sizeof(regions), 1, file) == 1;
+    for (int i = 0; ok && i < REGION_COUNT; ++i) {
+        const char *start = (const char *) regions[i].addr + regions[i].start;
+        ok = fwrite(start, 1, regions[i].length, file) == regions[i].length;
+    }
+    if (fclose(file) != 0 || !ok) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 从快照恢复虚拟机
+ * @param vm 虚拟机
+ * @param path 快照文件路径
+ * @param debug 是否打印当前运行的虚拟机指令
+ * @param argc 参数个数（替换 main 函数的参数）
+ * @param argv 参数
+ */
+void vm_restore(VM *vm, const char *path, const int debug, const int argc, char **argv) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        fail("could not open(%s)\n", path);
+    }
+    SnapshotHeader header;
+    SnapshotRegion regions[REGION_COUNT];
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != SNAPSHOT_MAGIC ||
+        fread(regions, sizeof(regions), 1, file) != 1) {
+        fail("bad snapshot %s\n", path);
+    }
+    char *mem[REGION_COUNT];
+    for (int i = 0; i < REGION_COUNT; ++i) {
+        // 快照中保存的是绝对地址，必须映射到原地址
+        mem[i] = map_anonymous((void *) regions[i].addr, regions[i].size);
+        if (mem[i] == NULL) {
+            fail("snapshot: address %#lx is not available\n", regions[i].addr);
+        }
+        if (fread(mem[i] + regions[i].start, 1, regions[i].length, file) != regions[i].length) {
+            fail("bad snapshot %s\n", path);
+        }
+    }
+    fclose(file);
+
+    vm->t_arena = NULL;
+    vm->d_arena = NULL;
+    vm_segments(vm, mem[REGION_TEXT], regions[REGION_TEXT].size, mem[REGION_DATA], regions[REGION_DATA].size);
+    vm->stack = (int64_t *) mem[REGION_STACK];
+    vm->stack_size = regions[REGION_STACK].size;
+    vm->heap = mem[REGION_HEAP];
+    vm->heap_size = regions[REGION_HEAP].size;
+    vm->heap_top = vm->heap + regions[REGION_HEAP].length;
+    vm->pc = (int64_t *) header.pc;
+    vm->rsp = (int64_t *) header.rsp;
+    vm->rbp = (int64_t *) header.rbp;
+    vm->rax = header.rax;
+    vm->compact = (int) header.compact;
+    vm->restored = 1;
+    vm->quiet = 0;
+    vm->compile = NULL; // 快照前已编译所有延迟编译的函数
+    vm->ctx = NULL;
+    vm->watch = NULL;
+    vm->w_ctx = NULL;
+    vm->debug = debug;
+    vm->cycle = 0;
+    vm->root = vm;
+    vm->threads = 0;
+    vm->parallel = NULL;
+    vm->p_busy = 0;
+    vm->coroutine = NULL;
+    vm->limit = INT64_MAX;
+    vm->state = VM_RUNNING;
+    vm->nonblock = 0;
+    vm->b_fd = -1;
+    vm->callbacks = 0;
+    vm->c_base = NULL;
+
+    // 替换 main 函数的参数（栈底依次为：EXIT, PUSH, argc, argv）
+    int64_t *bottom = (int64_t *) ((char *) vm->stack + vm->stack_size);
+    bottom[-3] = argc;
+    bottom[-4] = (int64_t) argv;
 }
@@ -8,6 +8,13 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "arena.h"
+
+#define VM_HEAP_SIZE ((size_t) 1 << 30) // 堆预留大小
+#define VM_STACK_SIZE (256 * 1024) // 栈大小
+#define CORO_STACK_MIN (4 * 1024) // 协程栈的最小大小
+#define SNAPSHOT_MAGIC 0x0453434d // "MCS\4"
+
 // opcodes
 enum {
     LEA, // 加载参数地址
@@ -17,6 +24,7 @@ enum {
     JZ, // 跳转：rax 值为零
     JNZ, // 跳转：rax 值为非零
     ENT, // 进入函数，并根据本地变量数和参数数量计算栈帧大小
+    LZY, // 延迟编译桩：首次调用时编译函数体，并修补调用点
     ADJ, // 清理函数调用时压入栈的参数(地址回退)
     LEV, // 退出函数
     LI, // 加载数值
@@ -50,45 +58,171 @@ enum {
     //FREE,   // 释放内存
     MSET, // 填充内存
     MCMP, // 比较内存
-    EXIT // 退出
+    SNAP, // 保存虚拟机快照
+    EXIT, // 退出
+    THRC, // 创建线程：在新的虚拟机栈上运行函数，共享代码段、数据段和堆
+    THRJ, // 等待线程结束，返回线程函数的返回值
+    AADD, // 原子加，返回原值
+    ACAS, // 原子比较并交换，成功返回 1
+    LOCK, // 互斥锁加锁
+    UNLK, // 互斥锁解锁
+    PFOR, // 并行循环：工作者虚拟机以工作窃取执行 fn(i, ctx)
+    CNEW, // 创建协程：协程栈从堆中分配
+    CRES, // 恢复协程，返回协程交出的值
+    CYLD, // 协程交出值，返回下一次恢复时传入的值
+    CDON, // 协程是否已结束
+    NATV, // 原生函数桩：调用 rax 指向的原生函数（Native）并返回调用者
+    RETN, // vm_call 的返回哨兵：被调用的函数已返回，vm_run 返回 rax
+    QSRT, // 排序：比较函数为源程序的函数（经 vm_call 回调）
+    BSCH // 二分查找：比较函数为源程序的函数（经 vm_call 回调）
+};
+
+// 虚拟机运行状态：vm_run 返回的原因
+enum {
+    VM_RUNNING, // 正在运行
+    VM_EXITED, // 已执行 EXIT，vm_run 返回函数的返回值
+    VM_PREEMPTED, // 指令数达到上限，已让出（再次调用 vm_run 继续运行）
+    VM_BLOCKED, // READ 无数据，已让出（b_fd 可读后再次调用 vm_run 继续运行）
+    VM_RETURNED // 已执行 RETN：vm_call 调用的函数已返回
 };
 
+// 操作码名称：每个名称 4 个字符加 1 个分隔符，按 &OPCODE_NAMES[op * 5] 取得
+#define OPCODE_NAMES "LEA ,IMM ,JMP ,JSR ,JZ  ,JNZ ,ENT ,LZY ,ADJ ,LEV ,LI  ,LC  ,SI  ,SC  ,PUSH," \
+    "OR  ,XOR ,AND ,EQ  ,NE  ,LT  ,GT  ,LE  ,GE  ,SHL ,SHR ,ADD ,SUB ,MUL ,DIV ,MOD ," \
+    "OPEN,READ,CLOS,PRTF,MALC,MSET,MCMP,SNAP,EXIT,THRC,THRJ,AADD,ACAS,LOCK,UNLK,PFOR,CNEW,CRES,CYLD,CDON,NATV,RETN,QSRT,BSCH,"
+
 // 虚拟机
-typedef struct {
+typedef struct VM {
     int64_t *pc; // 程序计数器(program counter)，指向 text 中的下一条指令(最初指向 main 函数入口)
     int64_t *rbp; // base pointer，指向最外层函数的栈帧的栈底
     int64_t *rsp; // stack pointer，指向栈顶
     int64_t rax; // register rax，通用寄存器
     int64_t *stack; // 虚拟机栈
-    int64_t *o_text; // 代码段的原始指针（用以最后释放内存，请勿直接操作此指针）
-    char *o_data; // 数据段的原始指针（用以最后释放内存，请勿直接操作此指针）
+    size_t stack_size; // 虚拟机栈大小
+    char *heap; // 堆：MALC 从此区域分配内存（预留地址空间，按需分配物理页）
+    char *heap_top; // 堆：下一次分配的起始位置
+    size_t heap_size; // 堆：预留大小
+    Arena *t_arena; // 代码段的内存区（由虚拟机释放；保存快照时只写入已提交的部分）
+    Arena *d_arena; // 数据段的内存区（由虚拟机释放；保存快照时只写入已提交的部分）
+    void *text; // 代码段（保存快照用）
+    size_t t_size; // 代码段大小（字节）
+    void *data; // 数据段（保存快照用）
+    size_t d_size; // 数据段大小（字节）
+    int compact; // 是否运行紧凑字节码（pc 指向字节码）
+    int restored; // 是否从快照恢复（代码段和数据段为快照映射的内存）
+    int quiet; // 程序结束时是否不打印退出码及执行的指令数（嵌入使用）
+    int64_t *(*compile)(void *ctx, int64_t index); // 延迟编译：编译指定函数，返回函数入口
+    void *ctx; // 延迟编译的上下文（语法分析器）
+    void (*watch)(void *ctx); // 安全点（LEV）回调：热重载
+    void *w_ctx; // 安全点回调的上下文（源文件监视）
     int debug; // 是否打印当前运行的虚拟机指令
+    int64_t cycle; // 已执行的指令数（每个虚拟机即每个线程独立计数）
+    struct VM *root; // 根虚拟机：线程与其共享堆，MALC 原子地移动 root->heap_top
+    int64_t threads; // 尚未 join 的线程数（仅根虚拟机使用）
+    struct Parallel *parallel; // 并行循环的工作者（仅根虚拟机使用，首次 parallel_for 时创建）
+    int p_busy; // 是否正在执行并行循环（仅根虚拟机使用；嵌套或并发的 parallel_for 在调用线程中顺序执行）
+    struct Coroutine *coroutine; // 正在运行的协程（NULL 表示不在协程中）
+    int64_t limit; // 指令数上限：cycle 达到此值后在下一次跳转或函数调用时让出（INT64_MAX 表示不限）
+    int state; // 运行状态
+    int nonblock; // READ 无数据时是否让出而不阻塞线程（由调度器运行）
+    int b_fd; // 让出时等待可读的文件描述符
+    int callbacks; // 正在执行的 vm_call 层数（原生函数回调源程序的函数，如 qsort 的比较函数）
+    struct Coroutine *c_base; // 最内层的 vm_call 开始时正在运行的协程（回调中不能从此协程交出）
 } VM;
 
 /**
  * 初始化虚拟机
  * @param vm 虚拟机
- * @param o_text 代码段（原始指针）
- * @param o_data 数据段（原始指针）
- * @param size 栈大小
+ * @param t_arena 代码段的内存区（语法分析器分配，NULL 表示代码段不由虚拟机释放）
+ * @param d_arena 数据段的内存区（语法分析器分配，NULL 表示数据段不由虚拟机释放）
  * @param main 主函数入口
  * @param debug 是否打印当前运行的虚拟机指令
  * @param argc 参数个数
  * @param argv 参数
  */
-void vm_init(VM *vm, int64_t *o_text, char *o_data, size_t size, int64_t *main, int debug, int argc, char **argv);
+void vm_init(VM *vm, Arena *t_arena, Arena *d_arena, int64_t *main, int debug, int argc, char **argv);
+
+/**
+ * 初始化虚拟机的栈和堆，暂不设置入口（由 vm_enter 设置）
+ * @param vm 虚拟机
+ * @param t_arena 代码段的内存区（NULL 表示代码段不由虚拟机释放）
+ * @param d_arena 数据段的内存区（NULL 表示数据段不由虚拟机释放）
+ * @param debug 是否打印当前运行的虚拟机指令
+ */
+void vm_setup(VM *vm, Arena *t_arena, Arena *d_arena, int debug);
+
+/**
+ * 从栈顶开始设置调用函数的栈帧（丢弃栈中原有内容）：函数返回后执行 EXIT，vm_run 返回函数的返回值
+ * @param vm 虚拟机
+ * @param entry 函数入口
+ * @param args 参数（按声明顺序入栈）
+ * @param count 参数个数
+ */
+void vm_enter(VM *vm, int64_t *entry, const int64_t *args, int count);
+
+/**
+ * 在调用者的栈顶之下调用源程序的函数，函数返回后回到调用处（可重入：原生函数回调源程序的函数，回调中可再次调用原生函数）
+ * @details 返回地址指向栈中的 RETN 哨兵，函数执行 LEV 后 vm_run 返回 rax；调用期间不让出（指令数不限、READ 阻塞），
+ *          回调中不能保存快照、不能从调用时所在的协程交出、不能执行 exit；不支持紧凑字节码
+ * @param vm 虚拟机（正在执行系统调用，寄存器为最新状态）
+ * @param entry 函数入口
+ * @param args 参数（按声明顺序入栈）
+ * @param count 参数个数
+ * @return 函数的返回值
+ */
+int64_t vm_call(VM *vm, int64_t *entry, const int64_t *args, int count);
+
+/**
+ * 初始化与 vm 共享代码段、数据段和堆的虚拟机（线程、并行循环的工作者），分配独立的栈
+ * @param child 新的虚拟机（入口由 vm_enter 设置）
+ * @param vm 被共享的虚拟机
+ * @return 0:成功 -1:分配栈失败
+ */
+int vm_share(VM *child, const VM *vm);
+
+/**
+ * 设置代码段和数据段的位置，保存快照时写入
+ * @param vm 虚拟机
+ * @param text 代码段
+ * @param t_size 代码段大小（字节）
+ * @param data 数据段
+ * @param d_size 数据段大小（字节）
+ */
+void vm_segments(VM *vm, void *text, size_t t_size, void *data, size_t d_size);
+
+/**
+ * 从快照恢复虚拟机：代码段、数据段、栈和堆映射到保存快照时的地址，寄存器恢复为 snapshot() 返回时的状态
+ * @param vm 虚拟机
+ * @param path 快照文件路径
+ * @param debug 是否打印当前运行的虚拟机指令
+ * @param argc 参数个数（替换 main 函数的参数）
+ * @param argv 参数
+ */
+void vm_restore(VM *vm, const char *path, int debug, int argc, char **argv);
 
 /**
  * 释放虚拟机
+ * @details 仍有未 join 的线程时不释放（线程可能仍在访问代码段、数据段、栈和堆），由进程退出时回收
  * @param vm 虚拟机
  */
 void vm_free(VM *vm);
 
 /**
  * 运行虚拟机
+ * @details 不使用全局状态（延迟编译除外，由互斥锁保护），多个线程可同时运行各自的虚拟机；
+ *          返回时 state 为 VM_PREEMPTED 或 VM_BLOCKED 表示已让出，寄存器已保存，再次调用即继续运行
  * @param vm 虚拟机
  * @return 正常结束：源程序的 main函数返回值；异常结束：错误码
  */
 int64_t vm_run(VM *vm);
 
+/**
+ * 执行系统调用（OPEN ~ SNAP，THRC ~ CDON，QSRT ~ BSCH）
+ * @param vm 虚拟机（寄存器须为最新状态，参数位于栈中）
+ * @param op 操作码
+ * @param argc 参数个数（仅 PRTF 使用）
+ * @return 系统调用返回值
+ */
+int64_t vm_syscall(VM *vm, int64_t op, int64_t argc);
+
 #endif //MCC_VM_H
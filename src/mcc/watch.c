@@ -0,0 +1,344 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#include "watch.h"
+#include "lexer.h"
+#include "source.h"
+#include "fail.h"
+
+static volatile sig_atomic_t watch_tick; // 定时器到期标志：安全点据此决定是否检查源文件
+
+// 定时器信号处理
+void watch_alarm(int sig);
+
+// 读取整个文件
+char *read_source(const char *path, size_t *length, struct timespec *mtime);
+
+// 统计 [0, length) 中的换行符数量
+size_t count_lines(const char *source, size_t length);
+
+// 第 line 行（从 1 开始）在源文件中的起始位置
+size_t line_offset(const char *source, size_t length, size_t line);
+
+// 查找第一个行号大于等于 line 的词法单元
+size_t find_token(const Lexer *lexer, size_t line);
+
+// 比较两个词法单元是否相同
+int same_token(const Lexer *a, size_t i, const Lexer *b, size_t j);
+
+/**
+ * @brief 开始监视源文件
+ * @param watch 源文件监视
+ * @param path 源文件路径
+ * @param parser 语法分析器
+ */
+void watch_init(Watch *watch, const char *path, Parser *parser) {
+    watch->path = path;
+    watch->parser = parser;
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        fail("watch: could not watch %s\n", path);
+    }
+    watch->mtime = st.st_mtim;
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = watch_alarm;
+    sa.sa_flags = SA_RESTART; // 被中断的系统调用（如源程序的 read）自动重启
+    sigaction(SIGALRM, &sa, NULL);
+    const struct itimerval timer = {
+        {0, WATCH_INTERVAL * 1000}, {0, WATCH_INTERVAL * 1000}
+    };
+    setitimer(ITIMER_REAL, &timer, NULL);
+}
+
+void watch_free(Watch *watch) {
+    const struct itimerval timer = {0};
+    setitimer(ITIMER_REAL, &timer, NULL);
+    watch_tick = 0;
+    watch->parser = NULL; // 语法分析器由调用者释放
+    watch->path = NULL;
+}
+
+/**
+ * @brief 定时器信号处理：仅设置标志，由虚拟机在安全点检查
+ * @param sig 信号
+ */
+void watch_alarm(const int sig) {
+    (void) sig;
+    watch_tick = 1;
+}
+
+/**
+ * @brief 安全点回调：定时器到期且源文件修改时间变化时重新加载
+ * @param ctx 源文件监视
+ */
+void watch_poll(void *ctx) {
+    if (!watch_tick) {
+        return;
+    }
+    watch_tick = 0;
+    Watch *watch = ctx;
+    struct stat st;
+    if (stat(watch->path, &st) != 0 ||
+        (st.st_mtim.tv_sec == watch->mtime.tv_sec && st.st_mtim.tv_nsec == watch->mtime.tv_nsec)) {
+        return;
+    }
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    const int count = watch_reload(watch);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (count >= 0) {
+        printf("watch: %d function(s) reloaded in %.3f ms\n", count,
+               (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+    }
+}
+
+/**
+ * @brief 重新加载源文件
+ * @param watch 源文件监视
+ * @return 重新编译的函数数量；-1 表示无法重新加载
+ */
+int watch_reload(Watch *watch) {
+    size_t length;
+    struct timespec mtime;
+    char *source = read_source(watch->path, &length, &mtime);
+    if (source == NULL) {
+        return -1;
+    }
+    watch->mtime = mtime; // 无论能否重新加载，同一版本只处理一次
+    Parser *parser = watch->parser;
+    Lexer *lexer = parser->lexer;
+    const char *old = lexer->source;
+    const size_t o_length = lexer->s_length;
+
+    // 1. 比较新旧文本：共同前缀和共同后缀之外为修改区域，换算为旧文本中的行范围 [first, last]
+    size_t prefix = 0, suffix = 0;
+    const size_t min = length < o_length ? length : o_length;
+    while (prefix < min && old[prefix] == source[prefix]) {
+        ++prefix;
+    }
+    if (prefix == length && length == o_length) {
+        source_free(source);
+        return 0;
+    }
+    while (suffix < min - prefix && old[o_length - 1 - suffix] == source[length - 1 - suffix]) {
+        ++suffix;
+    }
+    size_t first = 1 + count_lines(old, prefix);
+    size_t last = 1 + count_lines(old, o_length - suffix);
+    const long delta = (long) count_lines(source, length) - (long) count_lines(old, o_length); // 新增行数
+
+    // 2. 扩展行范围，使其包含完整的函数定义
+    Function *functions = parser->functions;
+    for (int changed = 1; changed;) {
+        changed = 0;
+        for (size_t i = 0; i < parser->f_size; ++i) {
+            const size_t f_first = lexer_line(lexer, functions[i].t_start);
+            const size_t f_last = lexer_line(lexer, functions[i].t_end - 1);
+            if (f_first <= last && f_last >= first && (f_first < first || f_last > last)) {
+                first = f_first < first ? f_first : first;
+                last = f_last > last ? f_last : last;
+                changed = 1;
+            }
+        }
+    }
+
+    // 3. 旧词法单元 [begin, end) 必须恰好由若干完整的函数定义 [f_begin, f_end) 组成
+    const size_t begin = find_token(lexer, first);
+    const size_t end = find_token(lexer, last + 1);
+    size_t f_begin = 0;
+    while (f_begin < parser->f_size && functions[f_begin].t_start < begin) {
+        ++f_begin;
+    }
+    size_t f_end = f_begin, t_next = begin;
+    while (f_end < parser->f_size && functions[f_end].t_start == t_next && functions[f_end].t_end <= end) {
+        t_next = functions[f_end++].t_end;
+    }
+    if (t_next != end) {
+        printf("watch: declarations outside functions changed, restart to apply\n");
+        source_free(source);
+        return -1;
+    }
+
+    // 4. 仅对修改区域重新词法分析（新文本中对应的行范围为 [first, last + delta]），词素位置相对于整个新文本
+    Lexer region;
+    lexer_init(&region, source, lexer->interner); // 与语法分析器共享驻留表，标识符编号一致
+    region.s_index = line_offset(source, length, first);
+    region.s_length = line_offset(source, length, last + delta + 1);
+    region.line = first;
+    lexer_analyse(&region);
+    const size_t n_size = region.t_size;
+
+    // 5. 新词法单元必须为同名、同签名的函数定义，逐个记录范围
+    const size_t count = f_end - f_begin;
+    Function *updated = malloc(sizeof(Function) * (count > 0 ? count : 1));
+    if (updated == NULL) {
+        fail("watch: malloc memory failed\n");
+    }
+    size_t t = 0, k = 0;
+    int ok = 1;
+    while (ok && t < n_size) {
+        if (k == count) {
+            ok = 0;
+            break;
+        }
+        const Function *fn = functions + f_begin + k;
+        // 函数头（返回类型、名称、参数列表）逐个比较
+        const size_t h_size = fn->t_end - fn->t_start;
+        size_t h = 0;
+        while (ok && lexer->kinds[fn->t_start + h] != TK_LEFT_BRACE) {
+            ok = h < h_size && t + h < n_size && same_token(lexer, fn->t_start + h, &region, t + h);
+            ++h;
+        }
+        if (!ok || t + h >= n_size || region.kinds[t + h] != TK_LEFT_BRACE) {
+            ok = 0;
+            break;
+        }
+        int depth = 0;
+        size_t e = t + h;
+        do {
+            depth += region.kinds[e] == TK_LEFT_BRACE ? 1 : region.kinds[e] == TK_RIGHT_BRACE ? -1 : 0;
+            ++e;
+        } while (depth > 0 && e < n_size);
+        ok = depth == 0;
+        const size_t offset = fn->t_index - fn->t_start;
+        updated[k++] = (Function){begin + t, begin + t + offset, begin + e, fn->g_size, fn->symbol, fn->stub, fn->entry, fn->params};
+        t = e;
+    }
+    if (!ok || k != count) {
+        printf("watch: function signatures or declarations changed, restart to apply\n");
+        lexer_free(&region);
+        free(updated);
+        source_free(source);
+        return -1;
+    }
+
+    // 6. 拼接词法单元序列：[0, begin) + 新词法单元 + [end, t_size)（行号和源码位置平移）
+    Lexer merged;
+    lexer_init(&merged, source, lexer->interner);
+    lexer_append(&merged, lexer, 0, begin, 0, 0);
+    lexer_append(&merged, &region, 0, n_size, 0, 0);
+    lexer_append(&merged, lexer, end, lexer->t_size, delta, (long) length - (long) o_length);
+    merged.s_index = length;
+    merged.line = lexer->line + delta;
+    for (size_t i = 0; i < count; ++i) {
+        functions[f_begin + i] = updated[i];
+    }
+    for (size_t i = f_end; i < parser->f_size; ++i) {
+        functions[i].t_start += n_size - (end - begin);
+        functions[i].t_index += n_size - (end - begin);
+        functions[i].t_end += n_size - (end - begin);
+    }
+    lexer_free(&region);
+    lexer_free(lexer);
+    source_free(lexer->source);
+    free(updated);
+    *lexer = merged;
+
+    // 7. 重新编译函数体，修改跳转桩的目标（正在执行的旧函数体不受影响，返回后不再进入）
+    for (size_t i = f_begin; i < f_end; ++i) {
+        int64_t *entry = parser_compile_function(parser, i);
+        functions[i].stub[1] = (int64_t) entry;
+    }
+    return (int) count;
+}
+
+/**
+ * @brief 读取整个文件：复制到私有内存（映射的页面会随编辑变化，无法与新文本比较）
+ * @param path 文件路径
+ * @param length 文件长度
+ * @param mtime 文件修改时间
+ * @return 文件内容（以 0 结尾）；失败返回 NULL
+ */
+char *read_source(const char *path, size_t *length, struct timespec *mtime) {
+    const int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return NULL;
+    }
+    char *source = source_read(fd, length);
+    close(fd);
+    *mtime = st.st_mtim;
+    return source;
+}
+
+/**
+ * @brief 统计换行符数量
+ * @param source 文本
+ * @param length 统计长度
+ * @return 换行符数量
+ */
+size_t count_lines(const char *source, const size_t length) {
+    size_t count = 0;
+    for (const char *p = source; (p = memchr(p, '\n', source + length - p)) != NULL; ++p) {
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * @brief 第 line 行的起始位置
+ * @param source 文本
+ * @param length 文本长度
+ * @param line 行号（从 1 开始）
+ * @return 起始位置；行号超出时返回文本长度
+ */
+size_t line_offset(const char *source, const size_t length, const size_t line) {
+    const char *p = source;
+    for (size_t i = 1; i < line; ++i) {
+        p = memchr(p, '\n', source + length - p);
+        if (p == NULL) {
+            return length;
+        }
+        ++p;
+    }
+    return p - source;
+}
+
+/**
+ * @brief 二分查找第一个行号大于等于 line 的词法单元
+ * @param lexer 词法分析器
+ * @param line 行号
+ * @return 词法单元索引；不存在时返回词法单元数量
+ */
+size_t find_token(const Lexer *lexer, const size_t line) {
+    size_t low = 0, high = lexer->l_size;
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (lexer->lines[mid].line < line) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < lexer->l_size ? lexer->lines[low].index : lexer->t_size;
+}
+
+/**
+ * @brief 比较两个词法单元是否相同：类型相同且词素相同
+ * @param a 词法分析器
+ * @param i 词法单元索引
+ * @param b 词法分析器
+ * @param j 词法单元索引
+ * @return 1:相同 0:不同
+ */
+int same_token(const Lexer *a, const size_t i, const Lexer *b, const size_t j) {
+    return a->kinds[i] == b->kinds[j] && a->lengths[i] == b->lengths[j] &&
+           memcmp(a->source + a->offsets[i], b->source + b->offsets[j], a->lengths[i]) == 0;
+}
@@ -0,0 +1,53 @@
+//
+// Created by Patrick.Lau on 2026/10/19.
+//
+
+#ifndef MCC_WATCH_H
+#define MCC_WATCH_H
+
+#include <stddef.h>
+#include <time.h>
+
+#include "parser.h"
+
+#define WATCH_INTERVAL 200 // 检查源文件是否修改的时间间隔（毫秒）
+
+// 源文件监视（热重载）
+typedef struct {
+    const char *path; // 源文件路径
+    struct timespec mtime; // 当前运行版本的源文件修改时间
+    Parser *parser; // 语法分析器（语法分析已完成，未释放；parser->watch 为真；保留当前运行版本的源文件文本）
+} Watch;
+
+/**
+ * @brief 开始监视源文件
+ * @details 按 WATCH_INTERVAL 定时检查，虚拟机在安全点（LEV）调用 watch_poll 时重新加载
+ * @param watch 源文件监视
+ * @param path 源文件路径
+ * @param parser 语法分析器
+ */
+void watch_init(Watch *watch, const char *path, Parser *parser);
+
+/**
+ * @brief 停止监视源文件
+ * @details 停止定时器并解除与语法分析器的关联（语法分析器由调用者释放）
+ * @param watch 源文件监视
+ */
+void watch_free(Watch *watch);
+
+/**
+ * @brief 安全点回调：源文件已修改时重新加载
+ * @param ctx 源文件监视
+ */
+void watch_poll(void *ctx);
+
+/**
+ * @brief 重新加载源文件
+ * @details 仅对修改区域（按行）重新词法分析，仅重新编译词法单元有变化的函数，并修改函数跳转桩的目标；
+ * 修改涉及函数以外的声明（全局变量、枚举、新增或删除函数）或函数签名时不重新加载
+ * @param watch 源文件监视
+ * @return 重新编译的函数数量；-1 表示无法重新加载
+ */
+int watch_reload(Watch *watch);
+
+#endif //MCC_WATCH_H
@@ -0,0 +1,32 @@
+#include <stdio.h>
+
+// 仅有声明的函数绑定到 libc 中的同名函数
+extern int strlen(char *s);
+extern char *strcpy(char *dest, char *src);
+extern char *strcat(char *dest, char *src);
+extern int strcmp(char *a, char *b);
+int abs(int x);
+int atoi(char *s);
+int toupper(int c);
+
+// 原型：程序中有定义时调用定义
+int twice(int x);
+
+int main() {
+    char *buf;
+    buf = malloc(64);
+    strcpy(buf, "hello");
+    strcat(buf, " native");
+    printf("strcat: %s\n", buf);
+    printf("strlen: %d\n", strlen(buf));
+    printf("strcmp: %d %d %d\n", strcmp("a", "b") < 0, strcmp("b", "a") > 0, strcmp(buf, "hello native"));
+    printf("abs: %d\n", abs(-42));
+    printf("atoi: %d\n", atoi("-17"));
+    printf("toupper: %d\n", toupper(109));
+    printf("twice: %d\n", twice(21));
+    return 0;
+}
+
+int twice(int x) {
+    return x * 2;
+}
@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+int calls;
+
+// 比较函数：a、b 为元素的地址
+int ascending(int *a, int *b) {
+    calls++;
+    return *a - *b;
+}
+
+int descending(int *a, int *b) {
+    return *b - *a;
+}
+
+// 比较函数中再次调用 qsort（可重入）
+int nested(int *a, int *b) {
+    int *pair;
+    pair = malloc(2 * sizeof(int));
+    pair[0] = *a;
+    pair[1] = *b;
+    qsort(pair, 2, sizeof(int), descending);
+    return pair[1] == *a ? -1 : pair[1] == *b ? 1 : 0;
+}
+
+int print(int *a, int n) {
+    int i;
+    i = 0;
+    while (i < n) {
+        printf("%d ", a[i]);
+        i++;
+    }
+    printf("\n");
+    return 0;
+}
+
+int main() {
+    int *a, *p;
+    int i, key;
+    a = malloc(10 * sizeof(int));
+    i = 0;
+    while (i < 10) {
+        a[i] = (i * 7 + 3) % 10;
+        i++;
+    }
+    qsort(a, 10, sizeof(int), ascending);
+    print(a, 10);
+    printf("calls: %d\n", calls > 0);
+    key = 6;
+    p = bsearch(&key, a, 10, sizeof(int), ascending);
+    printf("found: %d at %d\n", *p, p - a);
+    key = 42;
+    printf("missing: %d\n", bsearch(&key, a, 10, sizeof(int), ascending));
+    qsort(a, 10, sizeof(int), descending);
+    print(a, 10);
+    qsort(a, 10, sizeof(int), nested);
+    print(a, 10);
+    return 0;
+}
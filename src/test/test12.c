@@ -0,0 +1,549 @@
+#include <stdio.h>
+
+int count;
+int total;
+
+// 累计字符串常量的个数及长度
+int add(char *s) {
+    count++;
+    while (*s) {
+        total++;
+        s++;
+    }
+    return 0;
+}
+
+// 2048 个以 " %d\n" 结尾的不同字符串常量（共享后缀），以及与之相同或为其后缀的常量
+int literals() {
+    add("k0 %d\n"); add("k1 %d\n"); add("k2 %d\n"); add("k3 %d\n");
+    add("k4 %d\n"); add("k5 %d\n"); add("k6 %d\n"); add("k7 %d\n");
+    add("k8 %d\n"); add("k9 %d\n"); add("k10 %d\n"); add("k11 %d\n");
+    add("k12 %d\n"); add("k13 %d\n"); add("k14 %d\n"); add("k15 %d\n");
+    add("k16 %d\n"); add("k17 %d\n"); add("k18 %d\n"); add("k19 %d\n");
+    add("k20 %d\n"); add("k21 %d\n"); add("k22 %d\n"); add("k23 %d\n");
+    add("k24 %d\n"); add("k25 %d\n"); add("k26 %d\n"); add("k27 %d\n");
+    add("k28 %d\n"); add("k29 %d\n"); add("k30 %d\n"); add("k31 %d\n");
+    add("k32 %d\n"); add("k33 %d\n"); add("k34 %d\n"); add("k35 %d\n");
+    add("k36 %d\n"); add("k37 %d\n"); add("k38 %d\n"); add("k39 %d\n");
+    add("k40 %d\n"); add("k41 %d\n"); add("k42 %d\n"); add("k43 %d\n");
+    add("k44 %d\n"); add("k45 %d\n"); add("k46 %d\n"); add("k47 %d\n");
+    add("k48 %d\n"); add("k49 %d\n"); add("k50 %d\n"); add("k51 %d\n");
+    add("k52 %d\n"); add("k53 %d\n"); add("k54 %d\n"); add("k55 %d\n");
+    add("k56 %d\n"); add("k57 %d\n"); add("k58 %d\n"); add("k59 %d\n");
+    add("k60 %d\n"); add("k61 %d\n"); add("k62 %d\n"); add("k63 %d\n");
+    add("k64 %d\n"); add("k65 %d\n"); add("k66 %d\n"); add("k67 %d\n");
+    add("k68 %d\n"); add("k69 %d\n"); add("k70 %d\n"); add("k71 %d\n");
+    add("k72 %d\n"); add("k73 %d\n"); add("k74 %d\n"); add("k75 %d\n");
+    add("k76 %d\n"); add("k77 %d\n"); add("k78 %d\n"); add("k79 %d\n");
+    add("k80 %d\n"); add("k81 %d\n"); add("k82 %d\n"); add("k83 %d\n");
+    add("k84 %d\n"); add("k85 %d\n"); add("k86 %d\n"); add("k87 %d\n");
+    add("k88 %d\n"); add("k89 %d\n"); add("k90 %d\n"); add("k91 %d\n");
+    add("k92 %d\n"); add("k93 %d\n"); add("k94 %d\n"); add("k95 %d\n");
+    add("k96 %d\n"); add("k97 %d\n"); add("k98 %d\n"); add("k99 %d\n");
+    add("k100 %d\n"); add("k101 %d\n"); add("k102 %d\n"); add("k103 %d\n");
+    add("k104 %d\n"); add("k105 %d\n"); add("k106 %d\n"); add("k107 %d\n");
+    add("k108 %d\n"); add("k109 %d\n"); add("k110 %d\n"); add("k111 %d\n");
+    add("k112 %d\n"); add("k113 %d\n"); add("k114 %d\n"); add("k115 %d\n");
+    add("k116 %d\n"); add("k117 %d\n"); add("k118 %d\n"); add("k119 %d\n");
+    add("k120 %d\n"); add("k121 %d\n"); add("k122 %d\n"); add("k123 %d\n");
+    add("k124 %d\n"); add("k125 %d\n"); add("k126 %d\n"); add("k127 %d\n");
+    add("k128 %d\n"); add("k129 %d\n"); add("k130 %d\n"); add("k131 %d\n");
+    add("k132 %d\n"); add("k133 %d\n"); add("k134 %d\n"); add("k135 %d\n");
+    add("k136 %d\n"); add("k137 %d\n"); add("k138 %d\n"); add("k139 %d\n");
+    add("k140 %d\n"); add("k141 %d\n"); add("k142 %d\n"); add("k143 %d\n");
+    add("k144 %d\n"); add("k145 %d\n"); add("k146 %d\n"); add("k147 %d\n");
+    add("k148 %d\n"); add("k149 %d\n"); add("k150 %d\n"); add("k151 %d\n");
+    add("k152 %d\n"); add("k153 %d\n"); add("k154 %d\n"); add("k155 %d\n");
+    add("k156 %d\n"); add("k157 %d\n"); add("k158 %d\n"); add("k159 %d\n");
+    add("k160 %d\n"); add("k161 %d\n"); add("k162 %d\n"); add("k163 %d\n");
+    add("k164 %d\n"); add("k165 %d\n"); add("k166 %d\n"); add("k167 %d\n");
+    add("k168 %d\n"); add("k169 %d\n"); add("k170 %d\n"); add("k171 %d\n");
+    add("k172 %d\n"); add("k173 %d\n"); add("k174 %d\n"); add("k175 %d\n");
+    add("k176 %d\n"); add("k177 %d\n"); add("k178 %d\n"); add("k179 %d\n");
+    add("k180 %d\n"); add("k181 %d\n"); add("k182 %d\n"); add("k183 %d\n");
+    add("k184 %d\n"); add("k185 %d\n"); add("k186 %d\n"); add("k187 %d\n");
+    add("k188 %d\n"); add("k189 %d\n"); add("k190 %d\n"); add("k191 %d\n");
+    add("k192 %d\n"); add("k193 %d\n"); add("k194 %d\n"); add("k195 %d\n");
+    add("k196 %d\n"); add("k197 %d\n"); add("k198 %d\n"); add("k199 %d\n");
+    add("k200 %d\n"); add("k201 %d\n"); add("k202 %d\n"); add("k203 %d\n");
+    add("k204 %d\n"); add("k205 %d\n"); add("k206 %d\n"); add("k207 %d\n");
+    add("k208 %d\n"); add("k209 %d\n"); add("k210 %d\n"); add("k211 %d\n");
+    add("k212 %d\n"); add("k213 %d\n"); add("k214 %d\n"); add("k215 %d\n");
+    add("k216 %d\n"); add("k217 %d\n"); add("k218 %d\n"); add("k219 %d\n");
+    add("k220 %d\n"); add("k221 %d\n"); add("k222 %d\n"); add("k223 %d\n");
+    add("k224 %d\n"); add("k225 %d\n"); add("k226 %d\n"); add("k227 %d\n");
+    add("k228 %d\n"); add("k229 %d\n"); add("k230 %d\n"); add("k231 %d\n");
+    add("k232 %d\n"); add("k233 %d\n"); add("k234 %d\n"); add("k235 %d\n");
+    add("k236 %d\n"); add("k237 %d\n"); add("k238 %d\n"); add("k239 %d\n");
+    add("k240 %d\n"); add("k241 %d\n"); add("k242 %d\n"); add("k243 %d\n");
+    add("k244 %d\n"); add("k245 %d\n"); add("k246 %d\n"); add("k247 %d\n");
+    add("k248 %d\n"); add("k249 %d\n"); add("k250 %d\n"); add("k251 %d\n");
+    add("k252 %d\n"); add("k253 %d\n"); add("k254 %d\n"); add("k255 %d\n");
+    add("k256 %d\n"); add("k257 %d\n"); add("k258 %d\n"); add("k259 %d\n");
+    add("k260 %d\n"); add("k261 %d\n"); add("k262 %d\n"); add("k263 %d\n");
+    add("k264 %d\n"); add("k265 %d\n"); add("k266 %d\n"); add("k267 %d\n");
+    add("k268 %d\n"); add("k269 %d\n"); add("k270 %d\n"); add("k271 %d\n");
+    add("k272 %d\n"); add("k273 %d\n"); add("k274 %d\n"); add("k275 %d\n");
+    add("k276 %d\n"); add("k277 %d\n"); add("k278 %d\n"); add("k279 %d\n");
+    add("k280 %d\n"); add("k281 %d\n"); add("k282 %d\n"); add("k283 %d\n");
+    add("k284 %d\n"); add("k285 %d\n"); add("k286 %d\n"); add("k287 %d\n");
+    add("k288 %d\n"); add("k289 %d\n"); add("k290 %d\n"); add("k291 %d\n");
+    add("k292 %d\n"); add("k293 %d\n"); add("k294 %d\n"); add("k295 %d\n");
+    add("k296 %d\n"); add("k297 %d\n"); add("k298 %d\n"); add("k299 %d\n");
+    add("k300 %d\n"); add("k301 %d\n"); add("k302 %d\n"); add("k303 %d\n");
+    add("k304 %d\n"); add("k305 %d\n"); add("k306 %d\n"); add("k307 %d\n");
+    add("k308 %d\n"); add("k309 %d\n"); add("k310 %d\n"); add("k311 %d\n");
+    add("k312 %d\n"); add("k313 %d\n"); add("k314 %d\n"); add("k315 %d\n");
+    add("k316 %d\n"); add("k317 %d\n"); add("k318 %d\n"); add("k319 %d\n");
+    add("k320 %d\n"); add("k321 %d\n"); add("k322 %d\n"); add("k323 %d\n");
+    add("k324 %d\n"); add("k325 %d\n"); add("k326 %d\n"); add("k327 %d\n");
+    add("k328 %d\n"); add("k329 %d\n"); add("k330 %d\n"); add("k331 %d\n");
+    add("k332 %d\n"); add("k333 %d\n"); add("k334 %d\n"); add("k335 %d\n");
+    add("k336 %d\n"); add("k337 %d\n"); add("k338 %d\n"); add("k339 %d\n");
+    add("k340 %d\n"); add("k341 %d\n"); add("k342 %d\n"); add("k343 %d\n");
+    add("k344 %d\n"); add("k345 %d\n"); add("k346 %d\n"); add("k347 %d\n");
+    add("k348 %d\n"); add("k349 %d\n"); add("k350 %d\n"); add("k351 %d\n");
+    add("k352 %d\n"); add("k353 %d\n"); add("k354 %d\n"); add("k355 %d\n");
+    add("k356 %d\n"); add("k357 %d\n"); add("k358 %d\n"); add("k359 %d\n");
+    add("k360 %d\n"); add("k361 %d\n"); add("k362 %d\n"); add("k363 %d\n");
+    add("k364 %d\n"); add("k365 %d\n"); add("k366 %d\n"); add("k367 %d\n");
+    add("k368 %d\n"); add("k369 %d\n"); add("k370 %d\n"); add("k371 %d\n");
+    add("k372 %d\n"); add("k373 %d\n"); add("k374 %d\n"); add("k375 %d\n");
+    add("k376 %d\n"); add("k377 %d\n"); add("k378 %d\n"); add("k379 %d\n");
+    add("k380 %d\n"); add("k381 %d\n"); add("k382 %d\n"); add("k383 %d\n");
+    add("k384 %d\n"); add("k385 %d\n"); add("k386 %d\n"); add("k387 %d\n");
+    add("k388 %d\n"); add("k389 %d\n"); add("k390 %d\n"); add("k391 %d\n");
+    add("k392 %d\n"); add("k393 %d\n"); add("k394 %d\n"); add("k395 %d\n");
+    add("k396 %d\n"); add("k397 %d\n"); add("k398 %d\n"); add("k399 %d\n");
+    add("k400 %d\n"); add("k401 %d\n"); add("k402 %d\n"); add("k403 %d\n");
+    add("k404 %d\n"); add("k405 %d\n"); add("k406 %d\n"); add("k407 %d\n");
+    add("k408 %d\n"); add("k409 %d\n"); add("k410 %d\n"); add("k411 %d\n");
+    add("k412 %d\n"); add("k413 %d\n"); add("k414 %d\n"); add("k415 %d\n");
+    add("k416 %d\n"); add("k417 %d\n"); add("k418 %d\n"); add("k419 %d\n");
+    add("k420 %d\n"); add("k421 %d\n"); add("k422 %d\n"); add("k423 %d\n");
+    add("k424 %d\n"); add("k425 %d\n"); add("k426 %d\n"); add("k427 %d\n");
+    add("k428 %d\n"); add("k429 %d\n"); add("k430 %d\n"); add("k431 %d\n");
+    add("k432 %d\n"); add("k433 %d\n"); add("k434 %d\n"); add("k435 %d\n");
+    add("k436 %d\n"); add("k437 %d\n"); add("k438 %d\n"); add("k439 %d\n");
+    add("k440 %d\n"); add("k441 %d\n"); add("k442 %d\n"); add("k443 %d\n");
+    add("k444 %d\n"); add("k445 %d\n"); add("k446 %d\n"); add("k447 %d\n");
+    add("k448 %d\n"); add("k449 %d\n"); add("k450 %d\n"); add("k451 %d\n");
+    add("k452 %d\n"); add("k453 %d\n"); add("k454 %d\n"); add("k455 %d\n");
+    add("k456 %d\n"); add("k457 %d\n"); add("k458 %d\n"); add("k459 %d\n");
+    add("k460 %d\n"); add("k461 %d\n"); add("k462 %d\n"); add("k463 %d\n");
+    add("k464 %d\n"); add("k465 %d\n"); add("k466 %d\n"); add("k467 %d\n");
+    add("k468 %d\n"); add("k469 %d\n"); add("k470 %d\n"); add("k471 %d\n");
+    add("k472 %d\n"); add("k473 %d\n"); add("k474 %d\n"); add("k475 %d\n");
+    add("k476 %d\n"); add("k477 %d\n"); add("k478 %d\n"); add("k479 %d\n");
+    add("k480 %d\n"); add("k481 %d\n"); add("k482 %d\n"); add("k483 %d\n");
+    add("k484 %d\n"); add("k485 %d\n"); add("k486 %d\n"); add("k487 %d\n");
+    add("k488 %d\n"); add("k489 %d\n"); add("k490 %d\n"); add("k491 %d\n");
+    add("k492 %d\n"); add("k493 %d\n"); add("k494 %d\n"); add("k495 %d\n");
+    add("k496 %d\n"); add("k497 %d\n"); add("k498 %d\n"); add("k499 %d\n");
+    add("k500 %d\n"); add("k501 %d\n"); add("k502 %d\n"); add("k503 %d\n");
+    add("k504 %d\n"); add("k505 %d\n"); add("k506 %d\n"); add("k507 %d\n");
+    add("k508 %d\n"); add("k509 %d\n"); add("k510 %d\n"); add("k511 %d\n");
+    add("k512 %d\n"); add("k513 %d\n"); add("k514 %d\n"); add("k515 %d\n");
+    add("k516 %d\n"); add("k517 %d\n"); add("k518 %d\n"); add("k519 %d\n");
+    add("k520 %d\n"); add("k521 %d\n"); add("k522 %d\n"); add("k523 %d\n");
+    add("k524 %d\n"); add("k525 %d\n"); add("k526 %d\n"); add("k527 %d\n");
+    add("k528 %d\n"); add("k529 %d\n"); add("k530 %d\n"); add("k531 %d\n");
+    add("k532 %d\n"); add("k533 %d\n"); add("k534 %d\n"); add("k535 %d\n");
+    add("k536 %d\n"); add("k537 %d\n"); add("k538 %d\n"); add("k539 %d\n");
+    add("k540 %d\n"); add("k541 %d\n"); add("k542 %d\n"); add("k543 %d\n");
+    add("k544 %d\n"); add("k545 %d\n"); add("k546 %d\n"); add("k547 %d\n");
+    add("k548 %d\n"); add("k549 %d\n"); add("k550 %d\n"); add("k551 %d\n");
+    add("k552 %d\n"); add("k553 %d\n"); add("k554 %d\n"); add("k555 %d\n");
+    add("k556 %d\n"); add("k557 %d\n"); add("k558 %d\n"); add("k559 %d\n");
+    add("k560 %d\n"); add("k561 %d\n"); add("k562 %d\n"); add("k563 %d\n");
+    add("k564 %d\n"); add("k565 %d\n"); add("k566 %d\n"); add("k567 %d\n");
+    add("k568 %d\n"); add("k569 %d\n"); add("k570 %d\n"); add("k571 %d\n");
+    add("k572 %d\n"); add("k573 %d\n"); add("k574 %d\n"); add("k575 %d\n");
+    add("k576 %d\n"); add("k577 %d\n"); add("k578 %d\n"); add("k579 %d\n");
+    add("k580 %d\n"); add("k581 %d\n"); add("k582 %d\n"); add("k583 %d\n");
+    add("k584 %d\n"); add("k585 %d\n"); add("k586 %d\n"); add("k587 %d\n");
+    add("k588 %d\n"); add("k589 %d\n"); add("k590 %d\n"); add("k591 %d\n");
+    add("k592 %d\n"); add("k593 %d\n"); add("k594 %d\n"); add("k595 %d\n");
+    add("k596 %d\n"); add("k597 %d\n"); add("k598 %d\n"); add("k599 %d\n");
+    add("k600 %d\n"); add("k601 %d\n"); add("k602 %d\n"); add("k603 %d\n");
+    add("k604 %d\n"); add("k605 %d\n"); add("k606 %d\n"); add("k607 %d\n");
+    add("k608 %d\n"); add("k609 %d\n"); add("k610 %d\n"); add("k611 %d\n");
+    add("k612 %d\n"); add("k613 %d\n"); add("k614 %d\n"); add("k615 %d\n");
+    add("k616 %d\n"); add("k617 %d\n"); add("k618 %d\n"); add("k619 %d\n");
+    add("k620 %d\n"); add("k621 %d\n"); add("k622 %d\n"); add("k623 %d\n");
+    add("k624 %d\n"); add("k625 %d\n"); add("k626 %d\n"); add("k627 %d\n");
+    add("k628 %d\n"); add("k629 %d\n"); add("k630 %d\n"); add("k631 %d\n");
+    add("k632 %d\n"); add("k633 %d\n"); add("k634 %d\n"); add("k635 %d\n");
+    add("k636 %d\n"); add("k637 %d\n"); add("k638 %d\n"); add("k639 %d\n");
+    add("k640 %d\n"); add("k641 %d\n"); add("k642 %d\n"); add("k643 %d\n");
+    add("k644 %d\n"); add("k645 %d\n"); add("k646 %d\n"); add("k647 %d\n");
+    add("k648 %d\n"); add("k649 %d\n"); add("k650 %d\n"); add("k651 %d\n");
+    add("k652 %d\n"); add("k653 %d\n"); add("k654 %d\n"); add("k655 %d\n");
+    add("k656 %d\n"); add("k657 %d\n"); add("k658 %d\n"); add("k659 %d\n");
+    add("k660 %d\n"); add("k661 %d\n"); add("k662 %d\n"); add("k663 %d\n");
+    add("k664 %d\n"); add("k665 %d\n"); add("k666 %d\n"); add("k667 %d\n");
+    add("k668 %d\n"); add("k669 %d\n"); add("k670 %d\n"); add("k671 %d\n");
+    add("k672 %d\n"); add("k673 %d\n"); add("k674 %d\n"); add("k675 %d\n");
+    add("k676 %d\n"); add("k677 %d\n"); add("k678 %d\n"); add("k679 %d\n");
+    add("k680 %d\n"); add("k681 %d\n"); add("k682 %d\n"); add("k683 %d\n");
+    add("k684 %d\n"); add("k685 %d\n"); add("k686 %d\n"); add("k687 %d\n");
+    add("k688 %d\n"); add("k689 %d\n"); add("k690 %d\n"); add("k691 %d\n");
+    add("k692 %d\n"); add("k693 %d\n"); add("k694 %d\n"); add("k695 %d\n");
+    add("k696 %d\n"); add("k697 %d\n"); add("k698 %d\n"); add("k699 %d\n");
+    add("k700 %d\n"); add("k701 %d\n"); add("k702 %d\n"); add("k703 %d\n");
+    add("k704 %d\n"); add("k705 %d\n"); add("k706 %d\n"); add("k707 %d\n");
+    add("k708 %d\n"); add("k709 %d\n"); add("k710 %d\n"); add("k711 %d\n");
+    add("k712 %d\n"); add("k713 %d\n"); add("k714 %d\n"); add("k715 %d\n");
+    add("k716 %d\n"); add("k717 %d\n"); add("k718 %d\n"); add("k719 %d\n");
+    add("k720 %d\n"); add("k721 %d\n"); add("k722 %d\n"); add("k723 %d\n");
+    add("k724 %d\n"); add("k725 %d\n"); add("k726 %d\n"); add("k727 %d\n");
+    add("k728 %d\n"); add("k729 %d\n"); add("k730 %d\n"); add("k731 %d\n");
+    add("k732 %d\n"); add("k733 %d\n"); add("k734 %d\n"); add("k735 %d\n");
+    add("k736 %d\n"); add("k737 %d\n"); add("k738 %d\n"); add("k739 %d\n");
+    add("k740 %d\n"); add("k741 %d\n"); add("k742 %d\n"); add("k743 %d\n");
+    add("k744 %d\n"); add("k745 %d\n"); add("k746 %d\n"); add("k747 %d\n");
+    add("k748 %d\n"); add("k749 %d\n"); add("k750 %d\n"); add("k751 %d\n");
+    add("k752 %d\n"); add("k753 %d\n"); add("k754 %d\n"); add("k755 %d\n");
+    add("k756 %d\n"); add("k757 %d\n"); add("k758 %d\n"); add("k759 %d\n");
+    add("k760 %d\n"); add("k761 %d\n"); add("k762 %d\n"); add("k763 %d\n");
+    add("k764 %d\n"); add("k765 %d\n"); add("k766 %d\n"); add("k767 %d\n");
+    add("k768 %d\n"); add("k769 %d\n"); add("k770 %d\n"); add("k771 %d\n");
+    add("k772 %d\n"); add("k773 %d\n"); add("k774 %d\n"); add("k775 %d\n");
+    add("k776 %d\n"); add("k777 %d\n"); add("k778 %d\n"); add("k779 %d\n");
+    add("k780 %d\n"); add("k781 %d\n"); add("k782 %d\n"); add("k783 %d\n");
+    add("k784 %d\n"); add("k785 %d\n"); add("k786 %d\n"); add("k787 %d\n");
+    add("k788 %d\n"); add("k789 %d\n"); add("k790 %d\n"); add("k791 %d\n");
+    add("k792 %d\n"); add("k793 %d\n"); add("k794 %d\n"); add("k795 %d\n");
+    add("k796 %d\n"); add("k797 %d\n"); add("k798 %d\n"); add("k799 %d\n");
+    add("k800 %d\n"); add("k801 %d\n"); add("k802 %d\n"); add("k803 %d\n");
+    add("k804 %d\n"); add("k805 %d\n"); add("k806 %d\n"); add("k807 %d\n");
+    add("k808 %d\n"); add("k809 %d\n"); add("k810 %d\n"); add("k811 %d\n");
+    add("k812 %d\n"); add("k813 %d\n"); add("k814 %d\n"); add("k815 %d\n");
+    add("k816 %d\n"); add("k817 %d\n"); add("k818 %d\n"); add("k819 %d\n");
+    add("k820 %d\n"); add("k821 %d\n"); add("k822 %d\n"); add("k823 %d\n");
+    add("k824 %d\n"); add("k825 %d\n"); add("k826 %d\n"); add("k827 %d\n");
+    add("k828 %d\n"); add("k829 %d\n"); add("k830 %d\n"); add("k831 %d\n");
+    add("k832 %d\n"); add("k833 %d\n"); add("k834 %d\n"); add("k835 %d\n");
+    add("k836 %d\n"); add("k837 %d\n"); add("k838 %d\n"); add("k839 %d\n");
+    add("k840 %d\n"); add("k841 %d\n"); add("k842 %d\n"); add("k843 %d\n");
+    add("k844 %d\n"); add("k845 %d\n"); add("k846 %d\n"); add("k847 %d\n");
+    add("k848 %d\n"); add("k849 %d\n"); add("k850 %d\n"); add("k851 %d\n");
+    add("k852 %d\n"); add("k853 %d\n"); add("k854 %d\n"); add("k855 %d\n");
+    add("k856 %d\n"); add("k857 %d\n"); add("k858 %d\n"); add("k859 %d\n");
+    add("k860 %d\n"); add("k861 %d\n"); add("k862 %d\n"); add("k863 %d\n");
+    add("k864 %d\n"); add("k865 %d\n"); add("k866 %d\n"); add("k867 %d\n");
+    add("k868 %d\n"); add("k869 %d\n"); add("k870 %d\n"); add("k871 %d\n");
+    add("k872 %d\n"); add("k873 %d\n"); add("k874 %d\n"); add("k875 %d\n");
+    add("k876 %d\n"); add("k877 %d\n"); add("k878 %d\n"); add("k879 %d\n");
+    add("k880 %d\n"); add("k881 %d\n"); add("k882 %d\n"); add("k883 %d\n");
+    add("k884 %d\n"); add("k885 %d\n"); add("k886 %d\n"); add("k887 %d\n");
+    add("k888 %d\n"); add("k889 %d\n"); add("k890 %d\n"); add("k891 %d\n");
+    add("k892 %d\n"); add("k893 %d\n"); add("k894 %d\n"); add("k895 %d\n");
+    add("k896 %d\n"); add("k897 %d\n"); add("k898 %d\n"); add("k899 %d\n");
+    add("k900 %d\n"); add("k901 %d\n"); add("k902 %d\n"); add("k903 %d\n");
+    add("k904 %d\n"); add("k905 %d\n"); add("k906 %d\n"); add("k907 %d\n");
+    add("k908 %d\n"); add("k909 %d\n"); add("k910 %d\n"); add("k911 %d\n");
+    add("k912 %d\n"); add("k913 %d\n"); add("k914 %d\n"); add("k915 %d\n");
+    add("k916 %d\n"); add("k917 %d\n"); add("k918 %d\n"); add("k919 %d\n");
+    add("k920 %d\n"); add("k921 %d\n"); add("k922 %d\n"); add("k923 %d\n");
+    add("k924 %d\n"); add("k925 %d\n"); add("k926 %d\n"); add("k927 %d\n");
+    add("k928 %d\n"); add("k929 %d\n"); add("k930 %d\n"); add("k931 %d\n");
+    add("k932 %d\n"); add("k933 %d\n"); add("k934 %d\n"); add("k935 %d\n");
+    add("k936 %d\n"); add("k937 %d\n"); add("k938 %d\n"); add("k939 %d\n");
+    add("k940 %d\n"); add("k941 %d\n"); add("k942 %d\n"); add("k943 %d\n");
+    add("k944 %d\n"); add("k945 %d\n"); add("k946 %d\n"); add("k947 %d\n");
+    add("k948 %d\n"); add("k949 %d\n"); add("k950 %d\n"); add("k951 %d\n");
+    add("k952 %d\n"); add("k953 %d\n"); add("k954 %d\n"); add("k955 %d\n");
+    add("k956 %d\n"); add("k957 %d\n"); add("k958 %d\n"); add("k959 %d\n");
+    add("k960 %d\n"); add("k961 %d\n"); add("k962 %d\n"); add("k963 %d\n");
+    add("k964 %d\n"); add("k965 %d\n"); add("k966 %d\n"); add("k967 %d\n");
+    add("k968 %d\n"); add("k969 %d\n"); add("k970 %d\n"); add("k971 %d\n");
+    add("k972 %d\n"); add("k973 %d\n"); add("k974 %d\n"); add("k975 %d\n");
+    add("k976 %d\n"); add("k977 %d\n"); add("k978 %d\n"); add("k979 %d\n");
+    add("k980 %d\n"); add("k981 %d\n"); add("k982 %d\n"); add("k983 %d\n");
+    add("k984 %d\n"); add("k985 %d\n"); add("k986 %d\n"); add("k987 %d\n");
+    add("k988 %d\n"); add("k989 %d\n"); add("k990 %d\n"); add("k991 %d\n");
+    add("k992 %d\n"); add("k993 %d\n"); add("k994 %d\n"); add("k995 %d\n");
+    add("k996 %d\n"); add("k997 %d\n"); add("k998 %d\n"); add("k999 %d\n");
+    add("k1000 %d\n"); add("k1001 %d\n"); add("k1002 %d\n"); add("k1003 %d\n");
+    add("k1004 %d\n"); add("k1005 %d\n"); add("k1006 %d\n"); add("k1007 %d\n");
+    add("k1008 %d\n"); add("k1009 %d\n"); add("k1010 %d\n"); add("k1011 %d\n");
+    add("k1012 %d\n"); add("k1013 %d\n"); add("k1014 %d\n"); add("k1015 %d\n");
+    add("k1016 %d\n"); add("k1017 %d\n"); add("k1018 %d\n"); add("k1019 %d\n");
+    add("k1020 %d\n"); add("k1021 %d\n"); add("k1022 %d\n"); add("k1023 %d\n");
+    add("k1024 %d\n"); add("k1025 %d\n"); add("k1026 %d\n"); add("k1027 %d\n");
+    add("k1028 %d\n"); add("k1029 %d\n"); add("k1030 %d\n"); add("k1031 %d\n");
+    add("k1032 %d\n"); add("k1033 %d\n"); add("k1034 %d\n"); add("k1035 %d\n");
+    add("k1036 %d\n"); add("k1037 %d\n"); add("k1038 %d\n"); add("k1039 %d\n");
+    add("k1040 %d\n"); add("k1041 %d\n"); add("k1042 %d\n"); add("k1043 %d\n");
+    add("k1044 %d\n"); add("k1045 %d\n"); add("k1046 %d\n"); add("k1047 %d\n");
+    add("k1048 %d\n"); add("k1049 %d\n"); add("k1050 %d\n"); add("k1051 %d\n");
+    add("k1052 %d\n"); add("k1053 %d\n"); add("k1054 %d\n"); add("k1055 %d\n");
+    add("k1056 %d\n"); add("k1057 %d\n"); add("k1058 %d\n"); add("k1059 %d\n");
+    add("k1060 %d\n"); add("k1061 %d\n"); add("k1062 %d\n"); add("k1063 %d\n");
+    add("k1064 %d\n"); add("k1065 %d\n"); add("k1066 %d\n"); add("k1067 %d\n");
+    add("k1068 %d\n"); add("k1069 %d\n"); add("k1070 %d\n"); add("k1071 %d\n");
+    add("k1072 %d\n"); add("k1073 %d\n"); add("k1074 %d\n"); add("k1075 %d\n");
+    add("k1076 %d\n"); add("k1077 %d\n"); add("k1078 %d\n"); add("k1079 %d\n");
+    add("k1080 %d\n"); add("k1081 %d\n"); add("k1082 %d\n"); add("k1083 %d\n");
+    add("k1084 %d\n"); add("k1085 %d\n"); add("k1086 %d\n"); add("k1087 %d\n");
+    add("k1088 %d\n"); add("k1089 %d\n"); add("k1090 %d\n"); add("k1091 %d\n");
+    add("k1092 %d\n"); add("k1093 %d\n"); add("k1094 %d\n"); add("k1095 %d\n");
+    add("k1096 %d\n"); add("k1097 %d\n"); add("k1098 %d\n"); add("k1099 %d\n");
+    add("k1100 %d\n"); add("k1101 %d\n"); add("k1102 %d\n"); add("k1103 %d\n");
+    add("k1104 %d\n"); add("k1105 %d\n"); add("k1106 %d\n"); add("k1107 %d\n");
+    add("k1108 %d\n"); add("k1109 %d\n"); add("k1110 %d\n"); add("k1111 %d\n");
+    add("k1112 %d\n"); add("k1113 %d\n"); add("k1114 %d\n"); add("k1115 %d\n");
+    add("k1116 %d\n"); add("k1117 %d\n"); add("k1118 %d\n"); add("k1119 %d\n");
+    add("k1120 %d\n"); add("k1121 %d\n"); add("k1122 %d\n"); add("k1123 %d\n");
+    add("k1124 %d\n"); add("k1125 %d\n"); add("k1126 %d\n"); add("k1127 %d\n");
+    add("k1128 %d\n"); add("k1129 %d\n"); add("k1130 %d\n"); add("k1131 %d\n");
+    add("k1132 %d\n"); add("k1133 %d\n"); add("k1134 %d\n"); add("k1135 %d\n");
+    add("k1136 %d\n"); add("k1137 %d\n"); add("k1138 %d\n"); add("k1139 %d\n");
+    add("k1140 %d\n"); add("k1141 %d\n"); add("k1142 %d\n"); add("k1143 %d\n");
+    add("k1144 %d\n"); add("k1145 %d\n"); add("k1146 %d\n"); add("k1147 %d\n");
+    add("k1148 %d\n"); add("k1149 %d\n"); add("k1150 %d\n"); add("k1151 %d\n");
+    add("k1152 %d\n"); add("k1153 %d\n"); add("k1154 %d\n"); add("k1155 %d\n");
+    add("k1156 %d\n"); add("k1157 %d\n"); add("k1158 %d\n"); add("k1159 %d\n");
+    add("k1160 %d\n"); add("k1161 %d\n"); add("k1162 %d\n"); add("k1163 %d\n");
+    add("k1164 %d\n"); add("k1165 %d\n"); add("k1166 %d\n"); add("k1167 %d\n");
+    add("k1168 %d\n"); add("k1169 %d\n"); add("k1170 %d\n"); add("k1171 %d\n");
+    add("k1172 %d\n"); add("k1173 %d\n"); add("k1174 %d\n"); add("k1175 %d\n");
+    add("k1176 %d\n"); add("k1177 %d\n"); add("k1178 %d\n"); add("k1179 %d\n");
+    add("k1180 %d\n"); add("k1181 %d\n"); add("k1182 %d\n"); add("k1183 %d\n");
+    add("k1184 %d\n"); add("k1185 %d\n"); add("k1186 %d\n"); add("k1187 %d\n");
+    add("k1188 %d\n"); add("k1189 %d\n"); add("k1190 %d\n"); add("k1191 %d\n");
+    add("k1192 %d\n"); add("k1193 %d\n"); add("k1194 %d\n"); add("k1195 %d\n");
+    add("k1196 %d\n"); add("k1197 %d\n"); add("k1198 %d\n"); add("k1199 %d\n");
+    add("k1200 %d\n"); add("k1201 %d\n"); add("k1202 %d\n"); add("k1203 %d\n");
+    add("k1204 %d\n"); add("k1205 %d\n"); add("k1206 %d\n"); add("k1207 %d\n");
+    add("k1208 %d\n"); add("k1209 %d\n"); add("k1210 %d\n"); add("k1211 %d\n");
+    add("k1212 %d\n"); add("k1213 %d\n"); add("k1214 %d\n"); add("k1215 %d\n");
+    add("k1216 %d\n"); add("k1217 %d\n"); add("k1218 %d\n"); add("k1219 %d\n");
+    add("k1220 %d\n"); add("k1221 %d\n"); add("k1222 %d\n"); add("k1223 %d\n");
+    add("k1224 %d\n"); add("k1225 %d\n"); add("k1226 %d\n"); add("k1227 %d\n");
+    add("k1228 %d\n"); add("k1229 %d\n"); add("k1230 %d\n"); add("k1231 %d\n");
+    add("k1232 %d\n"); add("k1233 %d\n"); add("k1234 %d\n"); add("k1235 %d\n");
+    add("k1236 %d\n"); add("k1237 %d\n"); add("k1238 %d\n"); add("k1239 %d\n");
+    add("k1240 %d\n"); add("k1241 %d\n"); add("k1242 %d\n"); add("k1243 %d\n");
+    add("k1244 %d\n"); add("k1245 %d\n"); add("k1246 %d\n"); add("k1247 %d\n");
+    add("k1248 %d\n"); add("k1249 %d\n"); add("k1250 %d\n"); add("k1251 %d\n");
+    add("k1252 %d\n"); add("k1253 %d\n"); add("k1254 %d\n"); add("k1255 %d\n");
+    add("k1256 %d\n"); add("k1257 %d\n"); add("k1258 %d\n"); add("k1259 %d\n");
+    add("k1260 %d\n"); add("k1261 %d\n"); add("k1262 %d\n"); add("k1263 %d\n");
+    add("k1264 %d\n"); add("k1265 %d\n"); add("k1266 %d\n"); add("k1267 %d\n");
+    add("k1268 %d\n"); add("k1269 %d\n"); add("k1270 %d\n"); add("k1271 %d\n");
+    add("k1272 %d\n"); add("k1273 %d\n"); add("k1274 %d\n"); add("k1275 %d\n");
+    add("k1276 %d\n"); add("k1277 %d\n"); add("k1278 %d\n"); add("k1279 %d\n");
+    add("k1280 %d\n"); add("k1281 %d\n"); add("k1282 %d\n"); add("k1283 %d\n");
+    add("k1284 %d\n"); add("k1285 %d\n"); add("k1286 %d\n"); add("k1287 %d\n");
+    add("k1288 %d\n"); add("k1289 %d\n"); add("k1290 %d\n"); add("k1291 %d\n");
+    add("k1292 %d\n"); add("k1293 %d\n"); add("k1294 %d\n"); add("k1295 %d\n");
+    add("k1296 %d\n"); add("k1297 %d\n"); add("k1298 %d\n"); add("k1299 %d\n");
+    add("k1300 %d\n"); add("k1301 %d\n"); add("k1302 %d\n"); add("k1303 %d\n");
+    add("k1304 %d\n"); add("k1305 %d\n"); add("k1306 %d\n"); add("k1307 %d\n");
+    add("k1308 %d\n"); add("k1309 %d\n"); add("k1310 %d\n"); add("k1311 %d\n");
+    add("k1312 %d\n"); add("k1313 %d\n"); add("k1314 %d\n"); add("k1315 %d\n");
+    add("k1316 %d\n"); add("k1317 %d\n"); add("k1318 %d\n"); add("k1319 %d\n");
+    add("k1320 %d\n"); add("k1321 %d\n"); add("k1322 %d\n"); add("k1323 %d\n");
+    add("k1324 %d\n"); add("k1325 %d\n"); add("k1326 %d\n"); add("k1327 %d\n");
+    add("k1328 %d\n"); add("k1329 %d\n"); add("k1330 %d\n"); add("k1331 %d\n");
+    add("k1332 %d\n"); add("k1333 %d\n"); add("k1334 %d\n"); add("k1335 %d\n");
+    add("k1336 %d\n"); add("k1337 %d\n"); add("k1338 %d\n"); add("k1339 %d\n");
+    add("k1340 %d\n"); add("k1341 %d\n"); add("k1342 %d\n"); add("k1343 %d\n");
+    add("k1344 %d\n"); add("k1345 %d\n"); add("k1346 %d\n"); add("k1347 %d\n");
+    add("k1348 %d\n"); add("k1349 %d\n"); add("k1350 %d\n"); add("k1351 %d\n");
+    add("k1352 %d\n"); add("k1353 %d\n"); add("k1354 %d\n"); add("k1355 %d\n");
+    add("k1356 %d\n"); add("k1357 %d\n"); add("k1358 %d\n"); add("k1359 %d\n");
+    add("k1360 %d\n"); add("k1361 %d\n"); add("k1362 %d\n"); add("k1363 %d\n");
+    add("k1364 %d\n"); add("k1365 %d\n"); add("k1366 %d\n"); add("k1367 %d\n");
+    add("k1368 %d\n"); add("k1369 %d\n"); add("k1370 %d\n"); add("k1371 %d\n");
+    add("k1372 %d\n"); add("k1373 %d\n"); add("k1374 %d\n"); add("k1375 %d\n");
+    add("k1376 %d\n"); add("k1377 %d\n"); add("k1378 %d\n"); add("k1379 %d\n");
+    add("k1380 %d\n"); add("k1381 %d\n"); add("k1382 %d\n"); add("k1383 %d\n");
+    add("k1384 %d\n"); add("k1385 %d\n"); add("k1386 %d\n"); add("k1387 %d\n");
+    add("k1388 %d\n"); add("k1389 %d\n"); add("k1390 %d\n"); add("k1391 %d\n");
+    add("k1392 %d\n"); add("k1393 %d\n"); add("k1394 %d\n"); add("k1395 %d\n");
+    add("k1396 %d\n"); add("k1397 %d\n"); add("k1398 %d\n"); add("k1399 %d\n");
+    add("k1400 %d\n"); add("k1401 %d\n"); add("k1402 %d\n"); add("k1403 %d\n");
+    add("k1404 %d\n"); add("k1405 %d\n"); add("k1406 %d\n"); add("k1407 %d\n");
+    add("k1408 %d\n"); add("k1409 %d\n"); add("k1410 %d\n"); add("k1411 %d\n");
+    add("k1412 %d\n"); add("k1413 %d\n"); add("k1414 %d\n"); add("k1415 %d\n");
+    add("k1416 %d\n"); add("k1417 %d\n"); add("k1418 %d\n"); add("k1419 %d\n");
+    add("k1420 %d\n"); add("k1421 %d\n"); add("k1422 %d\n"); add("k1423 %d\n");
+    add("k1424 %d\n"); add("k1425 %d\n"); add("k1426 %d\n"); add("k1427 %d\n");
+    add("k1428 %d\n"); add("k1429 %d\n"); add("k1430 %d\n"); add("k1431 %d\n");
+    add("k1432 %d\n"); add("k1433 %d\n"); add("k1434 %d\n"); add("k1435 %d\n");
+    add("k1436 %d\n"); add("k1437 %d\n"); add("k1438 %d\n"); add("k1439 %d\n");
+    add("k1440 %d\n"); add("k1441 %d\n"); add("k1442 %d\n"); add("k1443 %d\n");
+    add("k1444 %d\n"); add("k1445 %d\n"); add("k1446 %d\n"); add("k1447 %d\n");
+    add("k1448 %d\n"); add("k1449 %d\n"); add("k1450 %d\n"); add("k1451 %d\n");
+    add("k1452 %d\n"); add("k1453 %d\n"); add("k1454 %d\n"); add("k1455 %d\n");
+    add("k1456 %d\n"); add("k1457 %d\n"); add("k1458 %d\n"); add("k1459 %d\n");
+    add("k1460 %d\n"); add("k1461 %d\n"); add("k1462 %d\n"); add("k1463 %d\n");
+    add("k1464 %d\n"); add("k1465 %d\n"); add("k1466 %d\n"); add("k1467 %d\n");
+    add("k1468 %d\n"); add("k1469 %d\n"); add("k1470 %d\n"); add("k1471 %d\n");
+    add("k1472 %d\n"); add("k1473 %d\n"); add("k1474 %d\n"); add("k1475 %d\n");
+    add("k1476 %d\n"); add("k1477 %d\n"); add("k1478 %d\n"); add("k1479 %d\n");
+    add("k1480 %d\n"); add("k1481 %d\n"); add("k1482 %d\n"); add("k1483 %d\n");
+    add("k1484 %d\n"); add("k1485 %d\n"); add("k1486 %d\n"); add("k1487 %d\n");
+    add("k1488 %d\n"); add("k1489 %d\n"); add("k1490 %d\n"); add("k1491 %d\n");
+    add("k1492 %d\n"); add("k1493 %d\n"); add("k1494 %d\n"); add("k1495 %d\n");
+    add("k1496 %d\n"); add("k1497 %d\n"); add("k1498 %d\n"); add("k1499 %d\n");
+    add("k1500 %d\n"); add("k1501 %d\n"); add("k1502 %d\n"); add("k1503 %d\n");
+    add("k1504 %d\n"); add("k1505 %d\n"); add("k1506 %d\n"); add("k1507 %d\n");
+    add("k1508 %d\n"); add("k1509 %d\n"); add("k1510 %d\n"); add("k1511 %d\n");
+    add("k1512 %d\n"); add("k1513 %d\n"); add("k1514 %d\n"); add("k1515 %d\n");
+    add("k1516 %d\n"); add("k1517 %d\n"); add("k1518 %d\n"); add("k1519 %d\n");
+    add("k1520 %d\n"); add("k1521 %d\n"); add("k1522 %d\n"); add("k1523 %d\n");
+    add("k1524 %d\n"); add("k1525 %d\n"); add("k1526 %d\n"); add("k1527 %d\n");
+    add("k1528 %d\n"); add("k1529 %d\n"); add("k1530 %d\n"); add("k1531 %d\n");
+    add("k1532 %d\n"); add("k1533 %d\n"); add("k1534 %d\n"); add("k1535 %d\n");
+    add("k1536 %d\n"); add("k1537 %d\n"); add("k1538 %d\n"); add("k1539 %d\n");
+    add("k1540 %d\n"); add("k1541 %d\n"); add("k1542 %d\n"); add("k1543 %d\n");
+    add("k1544 %d\n"); add("k1545 %d\n"); add("k1546 %d\n"); add("k1547 %d\n");
+    add("k1548 %d\n"); add("k1549 %d\n"); add("k1550 %d\n"); add("k1551 %d\n");
+    add("k1552 %d\n"); add("k1553 %d\n"); add("k1554 %d\n"); add("k1555 %d\n");
+    add("k1556 %d\n"); add("k1557 %d\n"); add("k1558 %d\n"); add("k1559 %d\n");
+    add("k1560 %d\n"); add("k1561 %d\n"); add("k1562 %d\n"); add("k1563 %d\n");
+    add("k1564 %d\n"); add("k1565 %d\n"); add("k1566 %d\n"); add("k1567 %d\n");
+    add("k1568 %d\n"); add("k1569 %d\n"); add("k1570 %d\n"); add("k1571 %d\n");
+    add("k1572 %d\n"); add("k1573 %d\n"); add("k1574 %d\n"); add("k1575 %d\n");
+    add("k1576 %d\n"); add("k1577 %d\n"); add("k1578 %d\n"); add("k1579 %d\n");
+    add("k1580 %d\n"); add("k1581 %d\n"); add("k1582 %d\n"); add("k1583 %d\n");
+    add("k1584 %d\n"); add("k1585 %d\n"); add("k1586 %d\n"); add("k1587 %d\n");
+    add("k1588 %d\n"); add("k1589 %d\n"); add("k1590 %d\n"); add("k1591 %d\n");
+    add("k1592 %d\n"); add("k1593 %d\n"); add("k1594 %d\n"); add("k1595 %d\n");
+    add("k1596 %d\n"); add("k1597 %d\n"); add("k1598 %d\n"); add("k1599 %d\n");
+    add("k1600 %d\n"); add("k1601 %d\n"); add("k1602 %d\n"); add("k1603 %d\n");
+    add("k1604 %d\n"); add("k1605 %d\n"); add("k1606 %d\n"); add("k1607 %d\n");
+    add("k1608 %d\n"); add("k1609 %d\n"); add("k1610 %d\n"); add("k1611 %d\n");
+    add("k1612 %d\n"); add("k1613 %d\n"); add("k1614 %d\n"); add("k1615 %d\n");
+    add("k1616 %d\n"); add("k1617 %d\n"); add("k1618 %d\n"); add("k1619 %d\n");
+    add("k1620 %d\n"); add("k1621 %d\n"); add("k1622 %d\n"); add("k1623 %d\n");
+    add("k1624 %d\n"); add("k1625 %d\n"); add("k1626 %d\n"); add("k1627 %d\n");
+    add("k1628 %d\n"); add("k1629 %d\n"); add("k1630 %d\n"); add("k1631 %d\n");
+    add("k1632 %d\n"); add("k1633 %d\n"); add("k1634 %d\n"); add("k1635 %d\n");
+    add("k1636 %d\n"); add("k1637 %d\n"); add("k1638 %d\n"); add("k1639 %d\n");
+    add("k1640 %d\n"); add("k1641 %d\n"); add("k1642 %d\n"); add("k1643 %d\n");
+    add("k1644 %d\n"); add("k1645 %d\n"); add("k1646 %d\n"); add("k1647 %d\n");
+    add("k1648 %d\n"); add("k1649 %d\n"); add("k1650 %d\n"); add("k1651 %d\n");
+    add("k1652 %d\n"); add("k1653 %d\n"); add("k1654 %d\n"); add("k1655 %d\n");
+    add("k1656 %d\n"); add("k1657 %d\n"); add("k1658 %d\n"); add("k1659 %d\n");
+    add("k1660 %d\n"); add("k1661 %d\n"); add("k1662 %d\n"); add("k1663 %d\n");
+    add("k1664 %d\n"); add("k1665 %d\n"); add("k1666 %d\n"); add("k1667 %d\n");
+    add("k1668 %d\n"); add("k1669 %d\n"); add("k1670 %d\n"); add("k1671 %d\n");
+    add("k1672 %d\n"); add("k1673 %d\n"); add("k1674 %d\n"); add("k1675 %d\n");
+    add("k1676 %d\n"); add("k1677 %d\n"); add("k1678 %d\n"); add("k1679 %d\n");
+    add("k1680 %d\n"); add("k1681 %d\n"); add("k1682 %d\n"); add("k1683 %d\n");
+    add("k1684 %d\n"); add("k1685 %d\n"); add("k1686 %d\n"); add("k1687 %d\n");
+    add("k1688 %d\n"); add("k1689 %d\n"); add("k1690 %d\n"); add("k1691 %d\n");
+    add("k1692 %d\n"); add("k1693 %d\n"); add("k1694 %d\n"); add("k1695 %d\n");
+    add("k1696 %d\n"); add("k1697 %d\n"); add("k1698 %d\n"); add("k1699 %d\n");
+    add("k1700 %d\n"); add("k1701 %d\n"); add("k1702 %d\n"); add("k1703 %d\n");
+    add("k1704 %d\n"); add("k1705 %d\n"); add("k1706 %d\n"); add("k1707 %d\n");
+    add("k1708 %d\n"); add("k1709 %d\n"); add("k1710 %d\n"); add("k1711 %d\n");
+    add("k1712 %d\n"); add("k1713 %d\n"); add("k1714 %d\n"); add("k1715 %d\n");
+    add("k1716 %d\n"); add("k1717 %d\n"); add("k1718 %d\n"); add("k1719 %d\n");
+    add("k1720 %d\n"); add("k1721 %d\n"); add("k1722 %d\n"); add("k1723 %d\n");
+    add("k1724 %d\n"); add("k1725 %d\n"); add("k1726 %d\n"); add("k1727 %d\n");
+    add("k1728 %d\n"); add("k1729 %d\n"); add("k1730 %d\n"); add("k1731 %d\n");
+    add("k1732 %d\n"); add("k1733 %d\n"); add("k1734 %d\n"); add("k1735 %d\n");
+    add("k1736 %d\n"); add("k1737 %d\n"); add("k1738 %d\n"); add("k1739 %d\n");
+    add("k1740 %d\n"); add("k1741 %d\n"); add("k1742 %d\n"); add("k1743 %d\n");
+    add("k1744 %d\n"); add("k1745 %d\n"); add("k1746 %d\n"); add("k1747 %d\n");
+    add("k1748 %d\n"); add("k1749 %d\n"); add("k1750 %d\n"); add("k1751 %d\n");
+    add("k1752 %d\n"); add("k1753 %d\n"); add("k1754 %d\n"); add("k1755 %d\n");
+    add("k1756 %d\n"); add("k1757 %d\n"); add("k1758 %d\n"); add("k1759 %d\n");
+    add("k1760 %d\n"); add("k1761 %d\n"); add("k1762 %d\n"); add("k1763 %d\n");
+    add("k1764 %d\n"); add("k1765 %d\n"); add("k1766 %d\n"); add("k1767 %d\n");
+    add("k1768 %d\n"); add("k1769 %d\n"); add("k1770 %d\n"); add("k1771 %d\n");
+    add("k1772 %d\n"); add("k1773 %d\n"); add("k1774 %d\n"); add("k1775 %d\n");
+    add("k1776 %d\n"); add("k1777 %d\n"); add("k1778 %d\n"); add("k1779 %d\n");
+    add("k1780 %d\n"); add("k1781 %d\n"); add("k1782 %d\n"); add("k1783 %d\n");
+    add("k1784 %d\n"); add("k1785 %d\n"); add("k1786 %d\n"); add("k1787 %d\n");
+    add("k1788 %d\n"); add("k1789 %d\n"); add("k1790 %d\n"); add("k1791 %d\n");
+    add("k1792 %d\n"); add("k1793 %d\n"); add("k1794 %d\n"); add("k1795 %d\n");
+    add("k1796 %d\n"); add("k1797 %d\n"); add("k1798 %d\n"); add("k1799 %d\n");
+    add("k1800 %d\n"); add("k1801 %d\n"); add("k1802 %d\n"); add("k1803 %d\n");
+    add("k1804 %d\n"); add("k1805 %d\n"); add("k1806 %d\n"); add("k1807 %d\n");
+    add("k1808 %d\n"); add("k1809 %d\n"); add("k1810 %d\n"); add("k1811 %d\n");
+    add("k1812 %d\n"); add("k1813 %d\n"); add("k1814 %d\n"); add("k1815 %d\n");
+    add("k1816 %d\n"); add("k1817 %d\n"); add("k1818 %d\n"); add("k1819 %d\n");
+    add("k1820 %d\n"); add("k1821 %d\n"); add("k1822 %d\n"); add("k1823 %d\n");
+    add("k1824 %d\n"); add("k1825 %d\n"); add("k1826 %d\n"); add("k1827 %d\n");
+    add("k1828 %d\n"); add("k1829 %d\n"); add("k1830 %d\n"); add("k1831 %d\n");
+    add("k1832 %d\n"); add("k1833 %d\n"); add("k1834 %d\n"); add("k1835 %d\n");
+    add("k1836 %d\n"); add("k1837 %d\n"); add("k1838 %d\n"); add("k1839 %d\n");
+    add("k1840 %d\n"); add("k1841 %d\n"); add("k1842 %d\n"); add("k1843 %d\n");
+    add("k1844 %d\n"); add("k1845 %d\n"); add("k1846 %d\n"); add("k1847 %d\n");
+    add("k1848 %d\n"); add("k1849 %d\n"); add("k1850 %d\n"); add("k1851 %d\n");
+    add("k1852 %d\n"); add("k1853 %d\n"); add("k1854 %d\n"); add("k1855 %d\n");
+    add("k1856 %d\n"); add("k1857 %d\n"); add("k1858 %d\n"); add("k1859 %d\n");
+    add("k1860 %d\n"); add("k1861 %d\n"); add("k1862 %d\n"); add("k1863 %d\n");
+    add("k1864 %d\n"); add("k1865 %d\n"); add("k1866 %d\n"); add("k1867 %d\n");
+    add("k1868 %d\n"); add("k1869 %d\n"); add("k1870 %d\n"); add("k1871 %d\n");
+    add("k1872 %d\n"); add("k1873 %d\n"); add("k1874 %d\n"); add("k1875 %d\n");
+    add("k1876 %d\n"); add("k1877 %d\n"); add("k1878 %d\n"); add("k1879 %d\n");
+    add("k1880 %d\n"); add("k1881 %d\n"); add("k1882 %d\n"); add("k1883 %d\n");
+    add("k1884 %d\n"); add("k1885 %d\n"); add("k1886 %d\n"); add("k1887 %d\n");
+    add("k1888 %d\n"); add("k1889 %d\n"); add("k1890 %d\n"); add("k1891 %d\n");
+    add("k1892 %d\n"); add("k1893 %d\n"); add("k1894 %d\n"); add("k1895 %d\n");
+    add("k1896 %d\n"); add("k1897 %d\n"); add("k1898 %d\n"); add("k1899 %d\n");
+    add("k1900 %d\n"); add("k1901 %d\n"); add("k1902 %d\n"); add("k1903 %d\n");
+    add("k1904 %d\n"); add("k1905 %d\n"); add("k1906 %d\n"); add("k1907 %d\n");
+    add("k1908 %d\n"); add("k1909 %d\n"); add("k1910 %d\n"); add("k1911 %d\n");
+    add("k1912 %d\n"); add("k1913 %d\n"); add("k1914 %d\n"); add("k1915 %d\n");
+    add("k1916 %d\n"); add("k1917 %d\n"); add("k1918 %d\n"); add("k1919 %d\n");
+    add("k1920 %d\n"); add("k1921 %d\n"); add("k1922 %d\n"); add("k1923 %d\n");
+    add("k1924 %d\n"); add("k1925 %d\n"); add("k1926 %d\n"); add("k1927 %d\n");
+    add("k1928 %d\n"); add("k1929 %d\n"); add("k1930 %d\n"); add("k1931 %d\n");
+    add("k1932 %d\n"); add("k1933 %d\n"); add("k1934 %d\n"); add("k1935 %d\n");
+    add("k1936 %d\n"); add("k1937 %d\n"); add("k1938 %d\n"); add("k1939 %d\n");
+    add("k1940 %d\n"); add("k1941 %d\n"); add("k1942 %d\n"); add("k1943 %d\n");
+    add("k1944 %d\n"); add("k1945 %d\n"); add("k1946 %d\n"); add("k1947 %d\n");
+    add("k1948 %d\n"); add("k1949 %d\n"); add("k1950 %d\n"); add("k1951 %d\n");
+    add("k1952 %d\n"); add("k1953 %d\n"); add("k1954 %d\n"); add("k1955 %d\n");
+    add("k1956 %d\n"); add("k1957 %d\n"); add("k1958 %d\n"); add("k1959 %d\n");
+    add("k1960 %d\n"); add("k1961 %d\n"); add("k1962 %d\n"); add("k1963 %d\n");
+    add("k1964 %d\n"); add("k1965 %d\n"); add("k1966 %d\n"); add("k1967 %d\n");
+    add("k1968 %d\n"); add("k1969 %d\n"); add("k1970 %d\n"); add("k1971 %d\n");
+    add("k1972 %d\n"); add("k1973 %d\n"); add("k1974 %d\n"); add("k1975 %d\n");
+    add("k1976 %d\n"); add("k1977 %d\n"); add("k1978 %d\n"); add("k1979 %d\n");
+    add("k1980 %d\n"); add("k1981 %d\n"); add("k1982 %d\n"); add("k1983 %d\n");
+    add("k1984 %d\n"); add("k1985 %d\n"); add("k1986 %d\n"); add("k1987 %d\n");
+    add("k1988 %d\n"); add("k1989 %d\n"); add("k1990 %d\n"); add("k1991 %d\n");
+    add("k1992 %d\n"); add("k1993 %d\n"); add("k1994 %d\n"); add("k1995 %d\n");
+    add("k1996 %d\n"); add("k1997 %d\n"); add("k1998 %d\n"); add("k1999 %d\n");
+    add("k2000 %d\n"); add("k2001 %d\n"); add("k2002 %d\n"); add("k2003 %d\n");
+    add("k2004 %d\n"); add("k2005 %d\n"); add("k2006 %d\n"); add("k2007 %d\n");
+    add("k2008 %d\n"); add("k2009 %d\n"); add("k2010 %d\n"); add("k2011 %d\n");
+    add("k2012 %d\n"); add("k2013 %d\n"); add("k2014 %d\n"); add("k2015 %d\n");
+    add("k2016 %d\n"); add("k2017 %d\n"); add("k2018 %d\n"); add("k2019 %d\n");
+    add("k2020 %d\n"); add("k2021 %d\n"); add("k2022 %d\n"); add("k2023 %d\n");
+    add("k2024 %d\n"); add("k2025 %d\n"); add("k2026 %d\n"); add("k2027 %d\n");
+    add("k2028 %d\n"); add("k2029 %d\n"); add("k2030 %d\n"); add("k2031 %d\n");
+    add("k2032 %d\n"); add("k2033 %d\n"); add("k2034 %d\n"); add("k2035 %d\n");
+    add("k2036 %d\n"); add("k2037 %d\n"); add("k2038 %d\n"); add("k2039 %d\n");
+    add("k2040 %d\n"); add("k2041 %d\n"); add("k2042 %d\n"); add("k2043 %d\n");
+    add("k2044 %d\n"); add("k2045 %d\n"); add("k2046 %d\n"); add("k2047 %d\n");
+    return 0;
+}
+
+int main() {
+    char *whole, *tail;
+    literals();
+    add("k2047 %d\n");
+    add("047 %d\n");
+    add(" %d\n");
+    add("\n");
+    add("");
+    printf("count: %d, total: %d\n", count, total);
+    // 后缀相同的字符串共享同一地址
+    whole = "k1047 %d\n";
+    tail = "047 %d\n";
+    printf("suffix: %d\n", whole + 2 == tail);
+    printf("same: %d\n", "k5 %d\n" == "k5 %d\n");
+    printf("last: %s", "k2047 %d\n" + 5);
+    return 0;
+}
@@ -0,0 +1,28 @@
+#include <stdio.h>
+
+// 快照时尚未调用的函数：-l 延迟编译时应在快照前编译，从快照恢复后仍可调用
+int later(int n) {
+    return n * 2;
+}
+
+int twice(int n) {
+    return later(n) + later(n);
+}
+
+int early(int n) {
+    return n + 1;
+}
+
+int main(int argc, char **argv) {
+    int state;
+    printf("early: %d\n", early(1));
+    state = snapshot("/tmp/test13.snap");
+    if (state == 0) {
+        printf("saved\n");
+        return 0;
+    }
+    printf("restored: %d %s\n", state, argv[0]);
+    printf("later: %d\n", later(21));
+    printf("twice: %d\n", twice(5));
+    return 0;
+}
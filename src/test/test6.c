@@ -0,0 +1,40 @@
+#include <stdio.h>
+
+int x;
+
+// 语句块内的声明遮蔽外层的同名变量，离开语句块后恢复
+int scopes(int a) {
+    int x;
+    x = a;
+    {
+        int x, y;
+        x = 100;
+        y = 5;
+        printf("inner: %d %d\n", x, y);
+        {
+            char *x;
+            x = "shadow";
+            printf("innermost: %s\n", x);
+        }
+        printf("inner again: %d\n", x);
+    }
+    {
+        int y;
+        y = 7;
+        printf("sibling: %d %d\n", x, y);
+    }
+    while (a > 0) {
+        int t;
+        t = a * 2;
+        printf("loop: %d\n", t);
+        a--;
+    }
+    return x;
+}
+
+int main() {
+    x = 1;
+    printf("result: %d\n", scopes(2));
+    printf("global: %d\n", x);
+    return 0;
+}
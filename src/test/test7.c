@@ -0,0 +1,38 @@
+#include <stdio.h>
+
+int counter;
+int total;
+int lock;
+
+// 每个线程累加 n 次：counter 原子加，total 由互斥锁保护
+int worker(int n) {
+    int i;
+    i = 0;
+    while (i < n) {
+        atomic_add(&counter, 1);
+        mutex_lock(&lock);
+        total = total + 2;
+        mutex_unlock(&lock);
+        i++;
+    }
+    return n;
+}
+
+int main() {
+    int t1, t2, t3, t4;
+    int x;
+    t1 = thread_create(worker, 10000);
+    t2 = thread_create(worker, 20000);
+    t3 = thread_create(worker, 30000);
+    t4 = thread_create(worker, 40000);
+    printf("joined: %d\n", thread_join(t1) + thread_join(t2) + thread_join(t3) + thread_join(t4));
+    printf("counter: %d\n", counter);
+    printf("total: %d\n", total);
+    // atomic_add 返回原值，atomic_cas 成功时返回 1
+    x = 5;
+    printf("atomic_add: %d\n", atomic_add(&x, 3));
+    printf("atomic_cas: %d\n", atomic_cas(&x, 5, 1));
+    printf("atomic_cas: %d\n", atomic_cas(&x, 8, 1));
+    printf("x: %d\n", x);
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+int *squares;
+int sum;
+
+// 循环体：fn(i, ctx)
+int square(int i, int scale) {
+    squares[i] = i * i * scale;
+    atomic_add(&sum, i);
+    return 0;
+}
+
+int inner(int j, int i) {
+    atomic_add(&sum, i * 10 + j);
+    return 0;
+}
+
+// 嵌套：循环体中再次并行循环
+int outer(int i, int n) {
+    parallel_for(0, n, inner, i);
+    return 0;
+}
+
+int main() {
+    int i, bad;
+    squares = malloc(1000 * sizeof(int));
+    parallel_for(0, 1000, square, 2);
+    bad = 0;
+    i = 0;
+    while (i < 1000) {
+        if (squares[i] != i * i * 2) {
+            bad++;
+        }
+        i++;
+    }
+    printf("sum: %d, bad: %d\n", sum, bad);
+    sum = 0;
+    parallel_for(0, 20, outer, 10);
+    printf("nested: %d\n", sum);
+    printf("empty: %d\n", parallel_for(5, 5, inner, 0));
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include <stdio.h>
+
+// 生成器：依次交出 0 .. n-1
+int numbers(int n) {
+    int i;
+    i = 0;
+    while (i < n) {
+        coro_yield(i);
+        i++;
+    }
+    return -1;
+}
+
+// 过滤：在协程中恢复上游的生成器，只交出偶数
+int evens(int up) {
+    int v;
+    v = coro_resume(up, 10);
+    while (!coro_done(up)) {
+        if (v % 2 == 0) {
+            coro_yield(v * 10);
+        }
+        v = coro_resume(up, 0);
+    }
+    return 99;
+}
+
+// 累加：coro_yield 的返回值为下一次 coro_resume 传入的值
+int accumulate(int first) {
+    int v, total;
+    total = first;
+    v = coro_yield(total);
+    while (v != 0) {
+        total = total + v;
+        v = coro_yield(total);
+    }
+    return total;
+}
+
+int main() {
+    int up, co, v;
+    up = coro_create(numbers, 4096);
+    co = coro_create(evens, 4096);
+    v = coro_resume(co, up);
+    while (!coro_done(co)) {
+        printf("even: %d\n", v);
+        v = coro_resume(co, 0);
+    }
+    printf("return: %d\n", v);
+    co = coro_create(accumulate, 4096);
+    printf("yield: %d\n", coro_resume(co, 5));
+    printf("yield: %d\n", coro_resume(co, 3));
+    printf("yield: %d\n", coro_resume(co, 4));
+    printf("return: %d\n", coro_resume(co, 0));
+    printf("done: %d\n", coro_done(co));
+    return 0;
+}